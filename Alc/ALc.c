@@ -25,6 +25,12 @@
 #include <stdio.h>
 #include <memory.h>
 #include <ctype.h>
+#ifdef HAVE_CPUID_H
+#include <cpuid.h>
+#endif
+#ifdef HAVE_INTRIN_H
+#include <intrin.h>
+#endif
 #include "alMain.h"
 #include "alSource.h"
 #include "AL/al.h"
@@ -183,7 +189,7 @@ static ALCchar *alcDefaultAllDeviceSpecifier;
 static ALCchar *alcCaptureDefaultDeviceSpecifier;
 
 
-static ALCchar alcExtensionList[] = "ALC_ENUMERATE_ALL_EXT ALC_ENUMERATION_EXT ALC_EXT_CAPTURE ALC_EXT_disconnect ALC_EXT_EFX ALC_EXTX_thread_local_context";
+static ALCchar alcExtensionList[] = "ALC_ENUMERATE_ALL_EXT ALC_ENUMERATION_EXT ALC_EXT_CAPTURE ALC_EXT_disconnect ALC_EXT_EFX ALC_EXTX_buffer_memory ALC_EXTX_mixer_stats ALC_EXTX_pool_stats ALC_EXTX_thread_local_context";
 static ALCint alcMajorVersion = 1;
 static ALCint alcMinorVersion = 1;
 
@@ -199,7 +205,31 @@ static ALCint alcEFXMinorVersion = 0;
 static ALCdevice *g_pDeviceList = NULL;
 static ALCuint    g_ulDeviceCount = 0;
 
+/* Locking
+ *
+ * There are three kinds of locks, which must be taken in this order:
+ *
+ *  1. g_csMutex, the list lock (SuspendContext(NULL)). It protects the device
+ *     and context lists, and which context is current. It's only held for
+ *     short lookups and for creating and destroying devices and contexts.
+ *  2. Each device's Mutex (LockDevice, or SuspendContext with a context). It
+ *     protects the device along with all of its contexts, sources, buffers,
+ *     effects, etc, and it's held by the device's mixer while mixing. Devices
+ *     don't share any state, so separate devices mix in parallel.
+ *  3. g_csPropMutex, the property lock (LockProps). It protects the source
+ *     properties that are passed to the mixer through each source's property
+ *     blocks (see alSource.h), and it's never taken by the mixer.
+ *
+ * The list lock must never be waited on while holding a device lock. Since
+ * AL calls are often made from inside other AL calls, a thread that holds a
+ * context's lock through GetContextSuspended keeps getting that context back
+ * from it without going through the list lock (see LockedContext).
+ *
+ * The context list is only changed with the list and property locks held,
+ * and each context's source list with its device and property locks held,
+ * so the property lock alone is enough to walk them. */
 static CRITICAL_SECTION g_csMutex;
+static CRITICAL_SECTION g_csPropMutex;
 
 // Context List
 static ALCcontext *g_pContextList = NULL;
@@ -208,15 +238,19 @@ static ALCuint     g_ulContextCount = 0;
 // Thread-local current context
 static tls_type LocalContext;
 
+// Context this thread has locked through GetContextSuspended, if any
+static tls_type LockedContext;
+
 // Context Error
 static ALCenum g_eLastContextError = ALC_NO_ERROR;
 
 // Default context extensions
 static const ALchar alExtList[] =
-    "AL_EXTX_buffer_sub_data AL_EXT_EXPONENT_DISTANCE AL_EXT_FLOAT32 "
-    "AL_EXT_IMA4 AL_EXT_LINEAR_DISTANCE AL_EXT_MCFORMATS AL_EXT_OFFSET "
-    "AL_EXTX_sample_buffer_object AL_EXT_source_distance_model "
-    "AL_LOKI_quadriphonic";
+    "AL_EXTX_buffer_sub_data AL_EXTX_deferred_updates AL_EXT_EXPONENT_DISTANCE "
+    "AL_EXT_FLOAT32 AL_EXT_IMA4 AL_EXT_LINEAR_DISTANCE AL_EXT_MCFORMATS "
+    "AL_EXT_OFFSET AL_EXTX_sample_buffer_object AL_EXTX_source_arrays "
+    "AL_EXT_source_distance_model AL_EXTX_source_priority AL_EXTX_sound_bank "
+    "AL_EXTX_static_buffer AL_LOKI_quadriphonic";
 
 // Mixing Priority Level
 ALint RTPrioLevel;
@@ -224,6 +258,9 @@ ALint RTPrioLevel;
 // Resampler Quality
 resampler_t DefaultResampler;
 
+// CPU extensions usable by the mixer
+ALuint CPUCapFlags = 0;
+
 ///////////////////////////////////////////////////////
 
 
@@ -258,23 +295,116 @@ static void alc_deinit(void) __attribute__((destructor));
 #endif
 #endif
 
+static void FillCPUCaps(void)
+{
+    ALuint caps = 0;
+    const char *str;
+
+#if defined(HAVE_GCC_GET_CPUID)
+    unsigned int eax, ebx, ecx, edx;
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        if((edx&(1<<25)))
+            caps |= CPU_CAP_SSE;
+        if((edx&(1<<26)))
+            caps |= CPU_CAP_SSE2;
+    }
+#elif defined(HAVE_CPUID_INTRINSIC)
+    int cpuinf[4];
+    __cpuid(cpuinf, 0);
+    if(cpuinf[0] >= 1)
+    {
+        __cpuid(cpuinf, 1);
+        if((cpuinf[3]&(1<<25)))
+            caps |= CPU_CAP_SSE;
+        if((cpuinf[3]&(1<<26)))
+            caps |= CPU_CAP_SSE2;
+    }
+#elif (defined(HAVE_SSE) || defined(HAVE_SSE2)) && (defined(__x86_64__) || defined(_M_X64))
+    /* SSE and SSE2 are part of the base x86-64 instruction set */
+    caps |= CPU_CAP_SSE | CPU_CAP_SSE2;
+#endif
+
+#ifdef HAVE_NEON
+#if defined(__aarch64__) || defined(_M_ARM64)
+    /* Neon is part of the base AArch64 instruction set */
+    caps |= CPU_CAP_NEON;
+#else
+    {
+        /* Assume Neon is only available if the kernel says so */
+        FILE *file = fopen("/proc/cpuinfo", "rb");
+        char line[1024];
+        if(file)
+        {
+            while(fgets(line, sizeof(line), file) != NULL)
+            {
+                if(strncmp(line, "Features", 8) != 0)
+                    continue;
+                if(strstr(line, " neon") != NULL)
+                    caps |= CPU_CAP_NEON;
+                break;
+            }
+            fclose(file);
+        }
+    }
+#endif
+#endif
+
+    str = GetConfigValue(NULL, "disable-cpu-exts", "");
+    if(strcasecmp(str, "all") == 0)
+        caps = 0;
+    else if(str[0])
+    {
+        const char *next = str;
+        size_t len;
+
+        do {
+            str = next;
+            next = strchr(str, ',');
+
+            while(isspace(*str))
+                str++;
+            if(!str[0] || str[0] == ',')
+                continue;
+
+            len = (next ? ((size_t)(next-str)) : strlen(str));
+            while(len > 0 && isspace(str[len-1]))
+                len--;
+            if(len == 3 && strncasecmp(str, "sse", len) == 0)
+                caps &= ~CPU_CAP_SSE;
+            else if(len == 4 && strncasecmp(str, "sse2", len) == 0)
+                caps &= ~CPU_CAP_SSE2;
+            else if(len == 4 && strncasecmp(str, "neon", len) == 0)
+                caps &= ~CPU_CAP_NEON;
+        } while(next++);
+    }
+
+    CPUCapFlags = caps;
+}
+
 static void alc_init(void)
 {
     int i;
     const char *devs, *str;
 
     InitializeCriticalSection(&g_csMutex);
+    InitializeCriticalSection(&g_csPropMutex);
     ALTHUNK_INIT();
     ReadALConfig();
 
     tls_create(&LocalContext);
+    tls_create(&LockedContext);
 
     RTPrioLevel = GetConfigValueInt(NULL, "rt-prio", 0);
 
+    FillCPUCaps();
+
     DefaultResampler = GetConfigValueInt(NULL, "resampler", RESAMPLER_DEFAULT);
     if(DefaultResampler >= RESAMPLER_MAX || DefaultResampler <= RESAMPLER_MIN)
         DefaultResampler = RESAMPLER_DEFAULT;
 
+    aluInitResamplers();
+
     devs = GetConfigValue(NULL, "drivers", "");
     if(devs[0])
     {
@@ -335,6 +465,8 @@ static void alc_init(void)
 
     DuplicateStereo = GetConfigValueBool(NULL, "stereodup", 0);
 
+    KeepIMA4Compressed = GetConfigValueBool(NULL, "ima4-compressed", 0);
+
     str = GetConfigValue(NULL, "excludefx", "");
     if(str[0])
     {
@@ -378,10 +510,12 @@ static void alc_deinit(void)
     for(i = 0;BackendList[i].Deinit;i++)
         BackendList[i].Deinit();
 
+    tls_delete(LockedContext);
     tls_delete(LocalContext);
 
     FreeALConfig();
     ALTHUNK_EXIT();
+    DeleteCriticalSection(&g_csPropMutex);
     DeleteCriticalSection(&g_csMutex);
 }
 
@@ -561,12 +695,15 @@ ALCvoid alcSetError(ALCdevice *device, ALenum errorCode)
 /*
     SuspendContext
 
-    Thread-safe entry
+    Thread-safe entry. With a context, this locks the context's device (see
+    LockDevice), otherwise it locks the device and context lists.
 */
 ALCvoid SuspendContext(ALCcontext *pContext)
 {
-    (void)pContext;
-    EnterCriticalSection(&g_csMutex);
+    if(pContext)
+        LockDevice(pContext->Device);
+    else
+        EnterCriticalSection(&g_csMutex);
 }
 
 
@@ -577,21 +714,48 @@ ALCvoid SuspendContext(ALCcontext *pContext)
 */
 ALCvoid ProcessContext(ALCcontext *pContext)
 {
-    (void)pContext;
-    LeaveCriticalSection(&g_csMutex);
+    if(pContext)
+        UnlockDevice(pContext->Device);
+    else
+        LeaveCriticalSection(&g_csMutex);
 }
 
 
 /*
-    GetContextSuspended
+    LockDevice
 
-    Returns the currently active Context, in a locked state
+    Locks the device, its contexts, and the objects on them
 */
-ALCcontext *GetContextSuspended(void)
+ALCvoid LockDevice(ALCdevice *device)
 {
-    ALCcontext *pContext = NULL;
+    EnterCriticalSection(&device->Mutex);
+    device->LockCount++;
+}
 
-    SuspendContext(NULL);
+
+/*
+    UnlockDevice
+
+    Unlocks the device. Once this thread has let go of it completely, it also
+    forgets the context it locked through GetContextSuspended.
+*/
+ALCvoid UnlockDevice(ALCdevice *device)
+{
+    if(--device->LockCount == 0)
+        tls_set(LockedContext, NULL);
+    LeaveCriticalSection(&device->Mutex);
+}
+
+
+/*
+    FindCurrentContext
+
+    Returns the context that's current for this thread, or NULL. The caller
+    must hold the list lock.
+*/
+static ALCcontext *FindCurrentContext(void)
+{
+    ALCcontext *pContext;
 
     pContext = tls_get(LocalContext);
     if(pContext && !IsContext(pContext))
@@ -605,8 +769,37 @@ ALCcontext *GetContextSuspended(void)
         while(pContext && !pContext->InUse)
             pContext = pContext->next;
     }
+    return pContext;
+}
+
+
+/*
+    GetContextSuspended
+
+    Returns the currently active Context, in a locked state
+*/
+ALCcontext *GetContextSuspended(void)
+{
+    ALCcontext *pContext;
+
+    // If this thread already has a context locked, it's still the one to
+    // use. Looking it up again would mean waiting on the list lock while
+    // holding a device lock.
+    pContext = tls_get(LockedContext);
+    if(pContext)
+    {
+        SuspendContext(pContext);
+        return pContext;
+    }
+
+    SuspendContext(NULL);
+
+    pContext = FindCurrentContext();
     if(pContext)
+    {
         SuspendContext(pContext);
+        tls_set(LockedContext, pContext);
+    }
 
     ProcessContext(NULL);
 
@@ -614,6 +807,66 @@ ALCcontext *GetContextSuspended(void)
 }
 
 
+/*
+    LockProps
+
+    Thread-safe entry for source property updates
+*/
+ALCvoid LockProps(ALCvoid)
+{
+    EnterCriticalSection(&g_csPropMutex);
+}
+
+
+/*
+    UnlockProps
+
+    Thread-safe exit for source property updates
+*/
+ALCvoid UnlockProps(ALCvoid)
+{
+    LeaveCriticalSection(&g_csPropMutex);
+}
+
+
+/*
+    GetContextProps
+
+    Returns the currently active Context with the property lock held. Unlike
+    GetContextSuspended, this doesn't wait for the mixer.
+*/
+ALCcontext *GetContextProps(void)
+{
+    ALCcontext *pContext;
+    ALCcontext *pTempContext;
+
+    LockProps();
+
+    pContext = tls_get(LocalContext);
+    if(pContext)
+    {
+        pTempContext = g_pContextList;
+        while(pTempContext && pTempContext != pContext)
+            pTempContext = pTempContext->next;
+        if(!pTempContext)
+        {
+            tls_set(LocalContext, NULL);
+            pContext = NULL;
+        }
+    }
+    if(!pContext)
+    {
+        pContext = g_pContextList;
+        while(pContext && !pContext->InUse)
+            pContext = pContext->next;
+    }
+    if(!pContext)
+        UnlockProps();
+
+    return pContext;
+}
+
+
 /*
     InitContext
 
@@ -636,6 +889,7 @@ static ALvoid InitContext(ALCcontext *pContext)
     pContext->Listener.Up[0] = 0.0f;
     pContext->Listener.Up[1] = 1.0f;
     pContext->Listener.Up[2] = 0.0f;
+    aluUpdateListener(pContext);
 
     //Validate pContext
     pContext->LastError = AL_NO_ERROR;
@@ -650,6 +904,9 @@ static ALvoid InitContext(ALCcontext *pContext)
     pContext->flSpeedOfSound = SPEEDOFSOUNDMETRESPERSEC;
 
     pContext->ExtensionList = alExtList;
+
+    InitPool(&pContext->SourcePool, sizeof(ALsource), 16);
+    InitPool(&pContext->BufferListPool, sizeof(ALbufferlistitem), 64);
 }
 
 
@@ -663,6 +920,9 @@ static ALCvoid ExitContext(ALCcontext *pContext)
     //Invalidate context
     pContext->LastError = AL_NO_ERROR;
     pContext->InUse = AL_FALSE;
+
+    DestroyPool(&pContext->SourcePool);
+    DestroyPool(&pContext->BufferListPool);
 }
 
 ///////////////////////////////////////////////////////
@@ -693,6 +953,10 @@ ALCAPI ALCdevice* ALCAPIENTRY alcCaptureOpenDevice(const ALCchar *deviceName, AL
     {
         //Initialise device structure
         memset(pDevice, 0, sizeof(ALCdevice));
+        InitializeCriticalSection(&pDevice->Mutex);
+        InitPool(&pDevice->BufferPool, sizeof(ALbuffer), 64);
+        InitPool(&pDevice->EffectPool, sizeof(ALeffect), 16);
+        InitPool(&pDevice->FilterPool, sizeof(ALfilter), 16);
 
         //Validate device
         pDevice->Connected = ALC_TRUE;
@@ -724,6 +988,7 @@ ALCAPI ALCdevice* ALCAPIENTRY alcCaptureOpenDevice(const ALCchar *deviceName, AL
         if(!DeviceFound)
         {
             alcSetError(NULL, ALC_INVALID_VALUE);
+            DeleteCriticalSection(&pDevice->Mutex);
             free(pDevice);
             pDevice = NULL;
         }
@@ -757,6 +1022,11 @@ ALCAPI ALCboolean ALCAPIENTRY alcCaptureCloseDevice(ALCdevice *pDevice)
         free(pDevice->szDeviceName);
         pDevice->szDeviceName = NULL;
 
+        DestroyPool(&pDevice->BufferPool);
+        DestroyPool(&pDevice->EffectPool);
+        DestroyPool(&pDevice->FilterPool);
+
+        DeleteCriticalSection(&pDevice->Mutex);
         free(pDevice);
 
         bReturn = ALC_TRUE;
@@ -942,6 +1212,75 @@ ALCAPI const ALCchar* ALCAPIENTRY alcGetString(ALCdevice *pDevice,ALCenum param)
 }
 
 
+/*
+    GetPoolStat
+
+    Totals the hits or misses of the device's object pools and those of its
+    contexts. The device must be locked.
+*/
+static ALCint GetPoolStat(ALCdevice *device, ALCenum param)
+{
+    const ALpool *pools[3];
+    ALuint total = 0;
+    ALuint i, j;
+
+    pools[0] = &device->BufferPool;
+    pools[1] = &device->EffectPool;
+    pools[2] = &device->FilterPool;
+    for(j = 0;j < 3;j++)
+        total += ((param == ALC_POOL_HITS_EXT) ? pools[j]->Hits : pools[j]->Misses);
+
+    for(i = 0;i < device->NumContexts;i++)
+    {
+        pools[0] = &device->Contexts[i]->SourcePool;
+        pools[1] = &device->Contexts[i]->BufferListPool;
+        for(j = 0;j < 2;j++)
+            total += ((param == ALC_POOL_HITS_EXT) ? pools[j]->Hits : pools[j]->Misses);
+    }
+
+    return (ALCint)total;
+}
+
+
+/*
+    GetBufferMemory
+
+    Returns the bytes of sample data held by the device's buffers, or the
+    bytes saved by keeping them in their own sample type (or compressed)
+    rather than as floats. Totals too big for an ALCint are clamped. The
+    device must be locked.
+*/
+static ALCint GetBufferMemory(ALCdevice *device, ALCenum param)
+{
+    ALbuffer *buffer;
+    ALuint64 total = 0;
+    ALuint Bytes, Channels;
+    ALuint size;
+
+    for(buffer = device->Buffers;buffer;buffer = buffer->next)
+    {
+        Bytes = aluBytesFromFormat(buffer->format);
+        Channels = aluChannelsFromFormat(buffer->format);
+        if(Bytes == 0)
+            continue;
+
+        size = buffer->size;
+        if(buffer->Compressed)
+            size = size/(65*Bytes*Channels) * 36*Channels;
+        // App memory given with alBufferDataStaticEXT isn't held here
+        if(buffer->Static)
+            size = 0;
+
+        if(param == ALC_BUFFER_MEMORY_EXT)
+            total += size;
+        else
+            total += (ALuint64)buffer->size/Bytes*sizeof(ALfloat) - size;
+    }
+
+    return (ALCint)min(total, 0x7fffffff);
+}
+
+
 /*
     alcGetIntegerv
 
@@ -957,7 +1296,7 @@ ALCAPI ALCvoid ALCAPIENTRY alcGetIntegerv(ALCdevice *device,ALCenum param,ALsize
 
     if(IsDevice(device) && device->IsCaptureDevice)
     {
-        SuspendContext(NULL);
+        LockDevice(device);
 
         // Capture device
         switch (param)
@@ -971,11 +1310,12 @@ ALCAPI ALCvoid ALCAPIENTRY alcGetIntegerv(ALCdevice *device,ALCenum param,ALsize
             break;
 
         default:
+            UnlockDevice(device);
             alcSetError(device, ALC_INVALID_ENUM);
-            break;
+            return;
         }
 
-        ProcessContext(NULL);
+        UnlockDevice(device);
         return;
     }
 
@@ -1021,7 +1361,7 @@ ALCAPI ALCvoid ALCAPIENTRY alcGetIntegerv(ALCdevice *device,ALCenum param,ALsize
             {
                 int i = 0;
 
-                SuspendContext(NULL);
+                LockDevice(device);
                 data[i++] = ALC_FREQUENCY;
                 data[i++] = device->Frequency;
 
@@ -1041,7 +1381,7 @@ ALCAPI ALCvoid ALCAPIENTRY alcGetIntegerv(ALCdevice *device,ALCenum param,ALsize
                 data[i++] = device->NumAuxSends;
 
                 data[i++] = 0;
-                ProcessContext(NULL);
+                UnlockDevice(device);
             }
             break;
 
@@ -1087,6 +1427,52 @@ ALCAPI ALCvoid ALCAPIENTRY alcGetIntegerv(ALCdevice *device,ALCenum param,ALsize
                 *data = device->Connected;
             break;
 
+        case ALC_PARAM_UPDATES_EXT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+            {
+                LockDevice(device);
+                *data = device->ParamUpdates;
+                UnlockDevice(device);
+            }
+            break;
+
+        case ALC_PLACEMENT_UPDATES_EXT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+            {
+                LockDevice(device);
+                *data = device->PlacementUpdates;
+                UnlockDevice(device);
+            }
+            break;
+
+        case ALC_POOL_HITS_EXT:
+        case ALC_POOL_MISSES_EXT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+            {
+                LockDevice(device);
+                *data = GetPoolStat(device, param);
+                UnlockDevice(device);
+            }
+            break;
+
+        case ALC_BUFFER_MEMORY_EXT:
+        case ALC_BUFFER_MEMORY_SAVED_EXT:
+            if(!IsDevice(device))
+                alcSetError(device, ALC_INVALID_DEVICE);
+            else
+            {
+                LockDevice(device);
+                *data = GetBufferMemory(device, param);
+                UnlockDevice(device);
+            }
+            break;
+
         default:
             alcSetError(device, ALC_INVALID_ENUM);
             break;
@@ -1198,6 +1584,7 @@ ALCAPI ALCcontext* ALCAPIENTRY alcCreateContext(ALCdevice *device, const ALCint
         ProcessContext(NULL);
         return NULL;
     }
+    LockDevice(device);
 
     // Reset Context Last Error code
     device->LastError = ALC_NO_ERROR;
@@ -1206,9 +1593,9 @@ ALCAPI ALCcontext* ALCAPIENTRY alcCreateContext(ALCdevice *device, const ALCint
     // device attributes can be updated
     if(device->NumContexts > 0)
     {
-        ProcessContext(NULL);
+        UnlockDevice(device);
         ALCdevice_StopPlayback(device);
-        SuspendContext(NULL);
+        LockDevice(device);
     }
 
     // Check for attributes
@@ -1263,6 +1650,7 @@ ALCAPI ALCcontext* ALCAPIENTRY alcCreateContext(ALCdevice *device, const ALCint
     {
         alcSetError(device, ALC_INVALID_DEVICE);
         aluHandleDisconnect(device);
+        UnlockDevice(device);
         ProcessContext(NULL);
         return NULL;
     }
@@ -1284,6 +1672,7 @@ ALCAPI ALCcontext* ALCAPIENTRY alcCreateContext(ALCdevice *device, const ALCint
                 alcSetError(device, ALC_INVALID_DEVICE);
                 aluHandleDisconnect(device);
                 ProcessContext(context);
+                UnlockDevice(device);
                 ProcessContext(NULL);
                 ALCdevice_StopPlayback(device);
                 return NULL;
@@ -1329,6 +1718,7 @@ ALCAPI ALCcontext* ALCAPIENTRY alcCreateContext(ALCdevice *device, const ALCint
     if(!temp)
     {
         alcSetError(device, ALC_OUT_OF_MEMORY);
+        UnlockDevice(device);
         ProcessContext(NULL);
         return NULL;
     }
@@ -1338,6 +1728,7 @@ ALCAPI ALCcontext* ALCAPIENTRY alcCreateContext(ALCdevice *device, const ALCint
     if(!ALContext)
     {
         alcSetError(device, ALC_OUT_OF_MEMORY);
+        UnlockDevice(device);
         ProcessContext(NULL);
         return NULL;
     }
@@ -1348,10 +1739,13 @@ ALCAPI ALCcontext* ALCAPIENTRY alcCreateContext(ALCdevice *device, const ALCint
     InitContext(ALContext);
     aluInitPanning(ALContext);
 
+    LockProps();
     ALContext->next = g_pContextList;
     g_pContextList = ALContext;
     g_ulContextCount++;
+    UnlockProps();
 
+    UnlockDevice(device);
     ProcessContext(NULL);
 
     return ALContext;
@@ -1377,6 +1771,10 @@ ALCAPI ALCvoid ALCAPIENTRY alcDestroyContext(ALCcontext *context)
 
         SuspendContext(NULL);
 
+        // Lock context
+        SuspendContext(context);
+        LockProps();
+
         for(i = 0;i < Device->NumContexts-1;i++)
         {
             if(Device->Contexts[i] == context)
@@ -1388,9 +1786,6 @@ ALCAPI ALCvoid ALCAPIENTRY alcDestroyContext(ALCcontext *context)
         }
         Device->NumContexts--;
 
-        // Lock context
-        SuspendContext(context);
-
         if(context->SourceCount > 0)
         {
 #ifdef _DEBUG
@@ -1414,6 +1809,7 @@ ALCAPI ALCvoid ALCAPIENTRY alcDestroyContext(ALCcontext *context)
         g_ulContextCount--;
 
         // Unlock context
+        UnlockProps();
         ProcessContext(context);
         ProcessContext(NULL);
 
@@ -1437,8 +1833,9 @@ ALCAPI ALCcontext * ALCAPIENTRY alcGetCurrentContext(ALCvoid)
 {
     ALCcontext *pContext;
 
-    if((pContext=GetContextSuspended()) != NULL)
-        ProcessContext(pContext);
+    SuspendContext(NULL);
+    pContext = FindCurrentContext();
+    ProcessContext(NULL);
 
     return pContext;
 }
@@ -1502,18 +1899,13 @@ ALCAPI ALCboolean ALCAPIENTRY alcMakeContextCurrent(ALCcontext *context)
     // context must be a valid Context or NULL
     if(context == NULL || IsContext(context))
     {
-        if((ALContext=GetContextSuspended()) != NULL)
-        {
+        LockProps();
+        if((ALContext=FindCurrentContext()) != NULL)
             ALContext->InUse=AL_FALSE;
-            ProcessContext(ALContext);
-        }
 
         if((ALContext=context) != NULL && ALContext->Device)
-        {
-            SuspendContext(ALContext);
             ALContext->InUse=AL_TRUE;
-            ProcessContext(ALContext);
-        }
+        UnlockProps();
 
         tls_set(LocalContext, NULL);
     }
@@ -1683,6 +2075,10 @@ ALCAPI ALCdevice* ALCAPIENTRY alcOpenDevice(const ALCchar *deviceName)
 
         //Initialise device structure
         memset(device, 0, sizeof(ALCdevice));
+        InitializeCriticalSection(&device->Mutex);
+        InitPool(&device->BufferPool, sizeof(ALbuffer), 64);
+        InitPool(&device->EffectPool, sizeof(ALeffect), 16);
+        InitPool(&device->FilterPool, sizeof(ALfilter), 16);
 
         //Validate device
         device->Connected = ALC_TRUE;
@@ -1722,6 +2118,17 @@ ALCAPI ALCdevice* ALCAPIENTRY alcOpenDevice(const ALCchar *deviceName)
         if((ALint)device->AuxiliaryEffectSlotMax <= 0)
             device->AuxiliaryEffectSlotMax = 4;
 
+        device->MaxVoices = GetConfigValueInt(NULL, "voices", 0);
+        if((ALint)device->MaxVoices < 0)
+            device->MaxVoices = 0;
+        device->VoiceHeap = NULL;
+        if(device->MaxVoices > 0)
+        {
+            device->VoiceHeap = malloc(device->MaxVoices * sizeof(*device->VoiceHeap));
+            if(!device->VoiceHeap)
+                device->MaxVoices = 0;
+        }
+
         device->lNumStereoSources = 1;
         device->lNumMonoSources = device->MaxNoOfSources - device->lNumStereoSources;
 
@@ -1731,6 +2138,19 @@ ALCAPI ALCdevice* ALCAPIENTRY alcOpenDevice(const ALCchar *deviceName)
 
         device->Bs2bLevel = GetConfigValueInt(NULL, "cf_level", 0);
 
+        i = GetConfigValueInt(NULL, "mixer-threads", 1);
+        if(i < 1) i = 1;
+        if(i > MAX_MIX_THREADS) i = MAX_MIX_THREADS;
+        device->NumMixThreads = i;
+        if(!aluInitMixThreads(device))
+        {
+            alcSetError(NULL, ALC_OUT_OF_MEMORY);
+            free(device->VoiceHeap);
+            DeleteCriticalSection(&device->Mutex);
+            free(device);
+            return NULL;
+        }
+
         if(aluChannelsFromFormat(device->Format) <= 2)
         {
             device->HeadDampen = GetConfigValueFloat(NULL, "head_dampen", DEFAULT_HEAD_DAMPEN);
@@ -1761,6 +2181,9 @@ ALCAPI ALCdevice* ALCAPIENTRY alcOpenDevice(const ALCchar *deviceName)
         {
             // No suitable output device found
             alcSetError(NULL, ALC_INVALID_VALUE);
+            aluDeinitMixThreads(device);
+            free(device->VoiceHeap);
+            DeleteCriticalSection(&device->Mutex);
             free(device);
             device = NULL;
         }
@@ -1804,6 +2227,7 @@ ALCAPI ALCboolean ALCAPIENTRY alcCloseDevice(ALCdevice *pDevice)
                 alcDestroyContext(pDevice->Contexts[0]);
         }
         ALCdevice_ClosePlayback(pDevice);
+        aluDeinitMixThreads(pDevice);
 
         if(pDevice->BufferCount > 0)
         {
@@ -1843,6 +2267,15 @@ ALCAPI ALCboolean ALCAPIENTRY alcCloseDevice(ALCdevice *pDevice)
         free(pDevice->Contexts);
         pDevice->Contexts = NULL;
 
+        free(pDevice->VoiceHeap);
+        pDevice->VoiceHeap = NULL;
+
+        DestroyPool(&pDevice->BufferPool);
+        DestroyPool(&pDevice->EffectPool);
+        DestroyPool(&pDevice->FilterPool);
+
+        DeleteCriticalSection(&pDevice->Mutex);
+
         //Release device structure
         memset(pDevice, 0, sizeof(ALCdevice));
         free(pDevice);
@@ -36,15 +36,18 @@
 #include "alAuxEffectSlot.h"
 #include "alu.h"
 #include "bs2b.h"
+#include "mixer_defs.h"
 
-#define FRACTIONBITS 14
-#define FRACTIONMASK ((1L<<FRACTIONBITS)-1)
 #define MAX_PITCH 65536
 
 /* Minimum ramp length in milliseconds. The value below was chosen to
  * adequately reduce clicks and pops from harsh gain changes. */
 #define MIN_RAMP_LENGTH  16
 
+/* Sources with all of their gains at or below this (-100dB) can't be heard,
+ * and only have their playback position advanced instead of being mixed. */
+#define INAUDIBLE_GAIN  0.00001f
+
 ALboolean DuplicateStereo = AL_FALSE;
 
 
@@ -398,8 +401,44 @@ ALvoid aluInitPanning(ALCcontext *Context)
     }
 }
 
+/* Rebuilds the listener-space transform after the listener moved or turned.
+ * The caller must hold the context lock. */
+ALvoid aluUpdateListener(ALCcontext *Context)
+{
+    ALlistener *Listener = &Context->Listener;
+    ALfloat U[3],V[3],N[3],P[3];
+
+    // Build transform matrix
+    memcpy(N, Listener->Forward, sizeof(N));  // At-vector
+    aluNormalize(N);  // Normalized At-vector
+    memcpy(V, Listener->Up, sizeof(V));  // Up-vector
+    aluNormalize(V);  // Normalized Up-vector
+    aluCrossproduct(N, V, U); // Right-vector
+    aluNormalize(U);  // Normalized Right-vector
+    P[0] = -(Listener->Position[0]*U[0] + // Translation
+             Listener->Position[1]*U[1] +
+             Listener->Position[2]*U[2]);
+    P[1] = -(Listener->Position[0]*V[0] +
+             Listener->Position[1]*V[1] +
+             Listener->Position[2]*V[2]);
+    P[2] = -(Listener->Position[0]*-N[0] +
+             Listener->Position[1]*-N[1] +
+             Listener->Position[2]*-N[2]);
+    Listener->Matrix[0][0] = U[0]; Listener->Matrix[0][1] = V[0]; Listener->Matrix[0][2] = -N[0]; Listener->Matrix[0][3] = 0.0f;
+    Listener->Matrix[1][0] = U[1]; Listener->Matrix[1][1] = V[1]; Listener->Matrix[1][2] = -N[1]; Listener->Matrix[1][3] = 0.0f;
+    Listener->Matrix[2][0] = U[2]; Listener->Matrix[2][1] = V[2]; Listener->Matrix[2][2] = -N[2]; Listener->Matrix[2][3] = 0.0f;
+    Listener->Matrix[3][0] = P[0]; Listener->Matrix[3][1] = P[1]; Listener->Matrix[3][2] =  P[2]; Listener->Matrix[3][3] = 1.0f;
+
+    // Transform listener velocity into listener space
+    memcpy(Listener->LocalVelocity, Listener->Velocity, sizeof(Listener->Velocity));
+    aluMatrixVector(Listener->LocalVelocity, 0.0f, Listener->Matrix);
+
+    Listener->Generation++;
+}
+
 static ALvoid CalcNonAttnSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
 {
+    const ALsourceProps *Props = &ALSource->Props[ALSource->PropRead];
     ALfloat SourceVolume,ListenerGain,MinVolume,MaxVolume;
     ALfloat DryGain, DryGainHF;
     ALfloat WetGain[MAX_SENDS];
@@ -416,12 +455,12 @@ static ALvoid CalcNonAttnSourceParams(const ALCcontext *ALContext, ALsource *ALS
     ListenerGain = ALContext->Listener.Gain;
 
     //Get source properties
-    SourceVolume = ALSource->flGain;
-    MinVolume    = ALSource->flMinGain;
-    MaxVolume    = ALSource->flMaxGain;
+    SourceVolume = Props->Gain;
+    MinVolume    = Props->MinGain;
+    MaxVolume    = Props->MaxGain;
 
     //1. Multi-channel buffers always play "normal"
-    ALSource->Params.Pitch = ALSource->flPitch;
+    ALSource->Params.Pitch = Props->Pitch;
 
     DryGain = SourceVolume;
     DryGain = __min(DryGain,MaxVolume);
@@ -486,15 +525,117 @@ static ALvoid CalcNonAttnSourceParams(const ALCcontext *ALContext, ALsource *ALS
     }
 }
 
-static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
+/* Checks if the source's cached placement was calculated from its current
+ * position, orientation and velocity, and the listener's current placement.
+ * Head-relative sources don't depend on the listener. */
+static __inline ALboolean SourcePlacementValid(const ALCcontext *ALContext, const ALsource *ALSource)
 {
-    ALfloat InnerAngle,OuterAngle,Angle,Distance,DryMix,OrigDist;
+    const ALsourceProps *Props = &ALSource->Props[ALSource->PropRead];
+
+    return ALSource->Params.Placement.Valid &&
+           ALSource->Params.Placement.HeadRelative == ALSource->bHeadRelative &&
+           (ALSource->bHeadRelative ||
+            ALSource->Params.Placement.ListenerGen == ALContext->Listener.Generation) &&
+           ALSource->Params.Placement.RefDistance == Props->RefDistance &&
+           memcmp(ALSource->Params.Placement.Position, Props->Position, sizeof(Props->Position)) == 0 &&
+           memcmp(ALSource->Params.Placement.Velocity, Props->Velocity, sizeof(Props->Velocity)) == 0 &&
+           memcmp(ALSource->Params.Placement.Orientation, Props->Orientation, sizeof(Props->Orientation)) == 0;
+}
+
+/* Records what the source's placement was calculated from */
+static __inline ALvoid SetPlacementValid(const ALCcontext *ALContext, ALsource *ALSource)
+{
+    const ALsourceProps *Props = &ALSource->Props[ALSource->PropRead];
+
+    memcpy(ALSource->Params.Placement.Position, Props->Position, sizeof(Props->Position));
+    memcpy(ALSource->Params.Placement.Velocity, Props->Velocity, sizeof(Props->Velocity));
+    memcpy(ALSource->Params.Placement.Orientation, Props->Orientation, sizeof(Props->Orientation));
+    ALSource->Params.Placement.RefDistance = Props->RefDistance;
+    ALSource->Params.Placement.HeadRelative = ALSource->bHeadRelative;
+    ALSource->Params.Placement.ListenerGen = ALContext->Listener.Generation;
+    ALSource->Params.Placement.Valid = AL_TRUE;
+}
+
+/* Calculates where a spatialized source is relative to the listener: its
+ * distance, the angles used for the sound cone and rear dampening, how fast
+ * the source and listener move towards each other, and the panning. These are
+ * the expensive parts of CalcSourceParams, and don't depend on the source's
+ * gain, filter or distance model settings. The reference distance is only
+ * needed to scale the panning for sources closer than it. */
+static ALvoid CalcSourcePlacement(const ALCcontext *ALContext, ALsource *ALSource)
+{
+    const ALsourceProps *Props = &ALSource->Props[ALSource->PropRead];
     ALfloat Direction[3],Position[3],SourceToListener[3];
     ALfloat Velocity[3],ListenerVel[3];
+    ALfloat Matrix[4][4];
+    ALfloat MinDist, Distance, length;
+
+    //Get source properties
+    memcpy(Position,  Props->Position,    sizeof(Props->Position));
+    memcpy(Direction, Props->Orientation, sizeof(Props->Orientation));
+    memcpy(Velocity,  Props->Velocity,    sizeof(Props->Velocity));
+    MinDist = Props->RefDistance;
+
+    //1. Translate Listener to origin (convert to head relative)
+    if(ALSource->bHeadRelative==AL_FALSE)
+    {
+        memcpy(Matrix, ALContext->Listener.Matrix, sizeof(Matrix));
+        memcpy(ListenerVel, ALContext->Listener.LocalVelocity, sizeof(ListenerVel));
+
+        // Transform source position and direction into listener space
+        aluMatrixVector(Position, 1.0f, Matrix);
+        aluMatrixVector(Direction, 0.0f, Matrix);
+        // Transform source velocity into listener space
+        aluMatrixVector(Velocity, 0.0f, Matrix);
+    }
+    else
+        ListenerVel[0] = ListenerVel[1] = ListenerVel[2] = 0.0f;
+
+    SourceToListener[0] = -Position[0];
+    SourceToListener[1] = -Position[1];
+    SourceToListener[2] = -Position[2];
+    aluNormalize(SourceToListener);
+    aluNormalize(Direction);
+
+    Distance = aluSqrt(aluDotproduct(Position, Position));
+    ALSource->Params.Placement.Distance = Distance;
+
+    ALSource->Params.Placement.ConeAngle =
+        aluAcos(aluDotproduct(Direction,SourceToListener)) * 180.0f/M_PI;
+
+    // NOTE: This should be aluDotproduct({0,0,-1}, ListenerToSource), however
+    // that is equivalent to aluDotproduct({0,0,1}, SourceToListener), which is
+    // the same as SourceToListener[2]
+    ALSource->Params.Placement.RearAngle = aluAcos(SourceToListener[2]) * 180.0f/M_PI;
+
+    ALSource->Params.Placement.SourceSpeed = aluDotproduct(Velocity, SourceToListener);
+    ALSource->Params.Placement.ListenerSpeed = aluDotproduct(ListenerVel, SourceToListener);
+
+    // Use energy-preserving panning algorithm for multi-speaker playback
+    length = __max(Distance, MinDist);
+    if(length > 0.0f)
+    {
+        ALfloat invlen = 1.0f/length;
+        Position[0] *= invlen;
+        Position[1] *= invlen;
+        Position[2] *= invlen;
+    }
+
+    ALSource->Params.Placement.PanPos = aluCart2LUTpos(-Position[2], Position[0]);
+    ALSource->Params.Placement.DirGain = aluSqrt(Position[0]*Position[0] + Position[2]*Position[2]);
+
+    SetPlacementValid(ALContext, ALSource);
+}
+
+/* Calculates the mixing parameters of a spatialized source from its cached
+ * placement (see CalcSourcePlacement), which must be up to date. */
+static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
+{
+    const ALsourceProps *Props = &ALSource->Props[ALSource->PropRead];
+    ALfloat InnerAngle,OuterAngle,Angle,Distance,DryMix,OrigDist;
     ALfloat MinVolume,MaxVolume,MinDist,MaxDist,Rolloff,OuterGainHF;
     ALfloat ConeVolume,ConeHF,SourceVolume,ListenerGain;
     ALfloat DopplerFactor, DopplerVelocity, flSpeedOfSound;
-    ALfloat Matrix[4][4];
     ALfloat flAttenuation, effectiveDist;
     ALfloat RoomAttenuation[MAX_SENDS];
     ALfloat MetersPerUnit;
@@ -503,18 +644,17 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
     ALfloat WetGain[MAX_SENDS];
     ALfloat WetGainHF[MAX_SENDS];
     ALfloat DirGain, AmbientGain;
-    ALfloat length;
     const ALfloat *SpeakerGain;
     ALuint Frequency;
     ALint NumSends;
-    ALint pos, s, i;
+    ALint s, i;
     ALfloat cw;
 
     for(i = 0;i < MAX_SENDS;i++)
         WetGainHF[i] = 1.0f;
 
     //Get context properties
-    DopplerFactor   = ALContext->DopplerFactor * ALSource->DopplerFactor;
+    DopplerFactor   = ALContext->DopplerFactor * Props->DopplerFactor;
     DopplerVelocity = ALContext->DopplerVelocity;
     flSpeedOfSound  = ALContext->flSpeedOfSound;
     NumSends        = ALContext->Device->NumAuxSends;
@@ -523,66 +663,20 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
     //Get listener properties
     ListenerGain = ALContext->Listener.Gain;
     MetersPerUnit = ALContext->Listener.MetersPerUnit;
-    memcpy(ListenerVel, ALContext->Listener.Velocity, sizeof(ALContext->Listener.Velocity));
 
     //Get source properties
-    SourceVolume = ALSource->flGain;
-    memcpy(Position,  ALSource->vPosition,    sizeof(ALSource->vPosition));
-    memcpy(Direction, ALSource->vOrientation, sizeof(ALSource->vOrientation));
-    memcpy(Velocity,  ALSource->vVelocity,    sizeof(ALSource->vVelocity));
-    MinVolume    = ALSource->flMinGain;
-    MaxVolume    = ALSource->flMaxGain;
-    MinDist      = ALSource->flRefDistance;
-    MaxDist      = ALSource->flMaxDistance;
-    Rolloff      = ALSource->flRollOffFactor;
-    InnerAngle   = ALSource->flInnerAngle;
-    OuterAngle   = ALSource->flOuterAngle;
-    OuterGainHF  = ALSource->OuterGainHF;
-
-    //1. Translate Listener to origin (convert to head relative)
-    if(ALSource->bHeadRelative==AL_FALSE)
-    {
-        ALfloat U[3],V[3],N[3],P[3];
-
-        // Build transform matrix
-        memcpy(N, ALContext->Listener.Forward, sizeof(N));  // At-vector
-        aluNormalize(N);  // Normalized At-vector
-        memcpy(V, ALContext->Listener.Up, sizeof(V));  // Up-vector
-        aluNormalize(V);  // Normalized Up-vector
-        aluCrossproduct(N, V, U); // Right-vector
-        aluNormalize(U);  // Normalized Right-vector
-        P[0] = -(ALContext->Listener.Position[0]*U[0] + // Translation
-                 ALContext->Listener.Position[1]*U[1] +
-                 ALContext->Listener.Position[2]*U[2]);
-        P[1] = -(ALContext->Listener.Position[0]*V[0] +
-                 ALContext->Listener.Position[1]*V[1] +
-                 ALContext->Listener.Position[2]*V[2]);
-        P[2] = -(ALContext->Listener.Position[0]*-N[0] +
-                 ALContext->Listener.Position[1]*-N[1] +
-                 ALContext->Listener.Position[2]*-N[2]);
-        Matrix[0][0] = U[0]; Matrix[0][1] = V[0]; Matrix[0][2] = -N[0]; Matrix[0][3] = 0.0f;
-        Matrix[1][0] = U[1]; Matrix[1][1] = V[1]; Matrix[1][2] = -N[1]; Matrix[1][3] = 0.0f;
-        Matrix[2][0] = U[2]; Matrix[2][1] = V[2]; Matrix[2][2] = -N[2]; Matrix[2][3] = 0.0f;
-        Matrix[3][0] = P[0]; Matrix[3][1] = P[1]; Matrix[3][2] =  P[2]; Matrix[3][3] = 1.0f;
-
-        // Transform source position and direction into listener space
-        aluMatrixVector(Position, 1.0f, Matrix);
-        aluMatrixVector(Direction, 0.0f, Matrix);
-        // Transform source and listener velocity into listener space
-        aluMatrixVector(Velocity, 0.0f, Matrix);
-        aluMatrixVector(ListenerVel, 0.0f, Matrix);
-    }
-    else
-        ListenerVel[0] = ListenerVel[1] = ListenerVel[2] = 0.0f;
-
-    SourceToListener[0] = -Position[0];
-    SourceToListener[1] = -Position[1];
-    SourceToListener[2] = -Position[2];
-    aluNormalize(SourceToListener);
-    aluNormalize(Direction);
+    SourceVolume = Props->Gain;
+    MinVolume    = Props->MinGain;
+    MaxVolume    = Props->MaxGain;
+    MinDist      = Props->RefDistance;
+    MaxDist      = Props->MaxDistance;
+    Rolloff      = Props->RollOffFactor;
+    InnerAngle   = Props->InnerAngle;
+    OuterAngle   = Props->OuterAngle;
+    OuterGainHF  = Props->OuterGainHF;
 
     //2. Calculate distance attenuation
-    Distance = aluSqrt(aluDotproduct(Position, Position));
+    Distance = ALSource->Params.Placement.Distance;
     OrigDist = Distance;
 
     flAttenuation = 1.0f;
@@ -590,7 +684,7 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
     {
         RoomAttenuation[i] = 1.0f;
 
-        RoomRolloff[i] = ALSource->RoomRolloffFactor;
+        RoomRolloff[i] = Props->RoomRolloffFactor;
         if(ALSource->Send[i].Slot &&
            (ALSource->Send[i].Slot->effect.type == AL_EFFECT_REVERB ||
             ALSource->Send[i].Slot->effect.type == AL_EFFECT_EAXREVERB))
@@ -664,12 +758,12 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
         effectiveDist = (MinDist/flAttenuation - MinDist)*MetersPerUnit;
 
     // Distance-based air absorption
-    if(ALSource->AirAbsorptionFactor > 0.0f && effectiveDist > 0.0f)
+    if(Props->AirAbsorptionFactor > 0.0f && effectiveDist > 0.0f)
     {
         ALfloat absorb;
 
         // Absorption calculation is done in dB
-        absorb = (ALSource->AirAbsorptionFactor*AIRABSORBGAINDBHF) *
+        absorb = (Props->AirAbsorptionFactor*AIRABSORBGAINDBHF) *
                  effectiveDist;
         // Convert dB to linear gain before applying
         absorb = pow(10.0, absorb/20.0);
@@ -678,16 +772,16 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
     }
 
     //3. Apply directional soundcones
-    Angle = aluAcos(aluDotproduct(Direction,SourceToListener)) * 180.0f/M_PI;
+    Angle = ALSource->Params.Placement.ConeAngle;
     if(Angle >= InnerAngle && Angle <= OuterAngle)
     {
         ALfloat scale = (Angle-InnerAngle) / (OuterAngle-InnerAngle);
-        ConeVolume = (1.0f+(ALSource->flOuterGain-1.0f)*scale);
+        ConeVolume = (1.0f+(Props->OuterGain-1.0f)*scale);
         ConeHF = (1.0f+(OuterGainHF-1.0f)*scale);
     }
     else if(Angle > OuterAngle)
     {
-        ConeVolume = (1.0f+(ALSource->flOuterGain-1.0f));
+        ConeVolume = (1.0f+(Props->OuterGain-1.0f));
         ConeHF = (1.0f+(OuterGainHF-1.0f));
     }
     else
@@ -697,10 +791,7 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
     }
 
     // Apply some high-frequency attenuation for sources behind the listener
-    // NOTE: This should be aluDotproduct({0,0,-1}, ListenerToSource), however
-    // that is equivalent to aluDotproduct({0,0,1}, SourceToListener), which is
-    // the same as SourceToListener[2]
-    Angle = aluAcos(SourceToListener[2]) * 180.0f/M_PI;
+    Angle = ALSource->Params.Placement.RearAngle;
     // Sources within the minimum distance attenuate less
     if(OrigDist < MinDist)
         Angle *= OrigDist/MinDist;
@@ -752,7 +843,7 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
 
                     WetGainHF[i] *= pow(10.0,
                                         log10(Slot->effect.Reverb.AirAbsorptionGainHF) *
-                                        ALSource->AirAbsorptionFactor * effectiveDist);
+                                        Props->AirAbsorptionFactor * effectiveDist);
                 }
             }
             else
@@ -802,39 +893,29 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
         ALfloat flMaxVelocity = (DopplerVelocity * flSpeedOfSound) /
                                 DopplerFactor;
 
-        flVSS = aluDotproduct(Velocity, SourceToListener);
+        flVSS = ALSource->Params.Placement.SourceSpeed;
         if(flVSS >= flMaxVelocity)
             flVSS = (flMaxVelocity - 1.0f);
         else if(flVSS <= -flMaxVelocity)
             flVSS = -flMaxVelocity + 1.0f;
 
-        flVLS = aluDotproduct(ListenerVel, SourceToListener);
+        flVLS = ALSource->Params.Placement.ListenerSpeed;
         if(flVLS >= flMaxVelocity)
             flVLS = (flMaxVelocity - 1.0f);
         else if(flVLS <= -flMaxVelocity)
             flVLS = -flMaxVelocity + 1.0f;
 
-        ALSource->Params.Pitch = ALSource->flPitch *
+        ALSource->Params.Pitch = Props->Pitch *
             ((flSpeedOfSound * DopplerVelocity) - (DopplerFactor * flVLS)) /
             ((flSpeedOfSound * DopplerVelocity) - (DopplerFactor * flVSS));
     }
     else
-        ALSource->Params.Pitch = ALSource->flPitch;
+        ALSource->Params.Pitch = Props->Pitch;
 
     // Use energy-preserving panning algorithm for multi-speaker playback
-    length = __max(OrigDist, MinDist);
-    if(length > 0.0f)
-    {
-        ALfloat invlen = 1.0f/length;
-        Position[0] *= invlen;
-        Position[1] *= invlen;
-        Position[2] *= invlen;
-    }
-
-    pos = aluCart2LUTpos(-Position[2], Position[0]);
-    SpeakerGain = &ALContext->PanningLUT[OUTPUTCHANNELS * pos];
+    SpeakerGain = &ALContext->PanningLUT[OUTPUTCHANNELS * ALSource->Params.Placement.PanPos];
 
-    DirGain = aluSqrt(Position[0]*Position[0] + Position[2]*Position[2]);
+    DirGain = ALSource->Params.Placement.DirGain;
     // elevation adjustment for directional gain. this sucks, but
     // has low complexity
     AmbientGain = 1.0/aluSqrt(ALContext->NumChan) * (1.0-DirGain);
@@ -860,33 +941,503 @@ static ALvoid CalcSourceParams(const ALCcontext *ALContext, ALsource *ALSource)
     }
 }
 
-static __inline ALfloat point(ALfloat val1, ALfloat val2, ALint frac)
+static ResamplerFunc SelectResampler(resampler_t Resampler)
 {
-    return val1;
-    (void)val2;
-    (void)frac;
+    switch(Resampler)
+    {
+        case POINT_RESAMPLER:
+            return Resample_point_C;
+        case LINEAR_RESAMPLER:
+            return Resample_lerp_C;
+        case COSINE_RESAMPLER:
+            return Resample_cos_lerp_C;
+        case SINC_RESAMPLER:
+#ifdef HAVE_SSE
+            if((CPUCapFlags&CPU_CAP_SSE))
+                return Resample_sinc_SSE;
+#endif
+#ifdef HAVE_NEON
+            if((CPUCapFlags&CPU_CAP_NEON))
+                return Resample_sinc_Neon;
+#endif
+            return Resample_sinc_C;
+        case RESAMPLER_MIN:
+        case RESAMPLER_MAX:
+            break;
+    }
+    return Resample_point_C;
 }
-static __inline ALfloat lerp(ALfloat val1, ALfloat val2, ALint frac)
+
+static LoadSamplesProc SelectSampleLoader(ALuint Bytes)
 {
-    return val1 + ((val2-val1)*(frac * (1.0f/(1<<FRACTIONBITS))));
+    switch(Bytes)
+    {
+        case 1:
+#ifdef HAVE_SSE2
+            if((CPUCapFlags&CPU_CAP_SSE2))
+                return LoadSamples_ubyte_SSE2;
+#endif
+            return LoadSamples_ubyte_C;
+        case 2:
+#ifdef HAVE_SSE2
+            if((CPUCapFlags&CPU_CAP_SSE2))
+                return LoadSamples_short_SSE2;
+#endif
+            return LoadSamples_short_C;
+    }
+    return LoadSamples_float_C;
+}
+
+/* Loads sample frames from a compressed IMA4 buffer, decoding the blocks
+ * they're in. The last block decoded is kept with the source, since the
+ * blocks are small enough that it's often read again by the next mix, and
+ * seeking or looping back only needs the one block decoded. */
+static void LoadIMA4Frames(ALsource *ALSource, ALfloat *dst, const ALbuffer *buffer,
+                           ALuint pos, ALuint count, ALuint Channels,
+                           LoadSamplesProc LoadSamples)
+{
+    ALshort Block[65*2];
+    ALuint offset, n;
+
+    while(count > 0)
+    {
+        if(ALSource->IMA4Cache.Buffer != buffer ||
+           ALSource->IMA4Cache.Serial != buffer->Serial ||
+           ALSource->IMA4Cache.Block != pos/65)
+        {
+            DecodeIMA4Block(Block, (const ALubyte*)buffer->data + pos/65*36*Channels,
+                            Channels);
+            LoadSamples(ALSource->IMA4Cache.Samples, Block, 65*Channels);
+            ALSource->IMA4Cache.Buffer = buffer;
+            ALSource->IMA4Cache.Serial = buffer->Serial;
+            ALSource->IMA4Cache.Block = pos/65;
+        }
+
+        offset = pos%65;
+        n = min(count, 65-offset);
+        memcpy(dst, &ALSource->IMA4Cache.Samples[offset*Channels],
+               n*Channels*sizeof(ALfloat));
+        dst += n*Channels;
+        pos += n;
+        count -= n;
+    }
+}
+
+/* Loads count sample frames from a buffer into a resampler window, starting
+ * at frame pos. */
+static __inline void LoadWindowFrames(ALsource *ALSource, ALfloat *dst,
+                                      const ALbuffer *buffer, ALuint pos,
+                                      ALuint count, ALuint Channels, ALuint Bytes,
+                                      LoadSamplesProc LoadSamples)
+{
+    if(count == 0)
+        return;
+    if(buffer->Compressed)
+        LoadIMA4Frames(ALSource, dst, buffer, pos, count, Channels, LoadSamples);
+    else
+        LoadSamples(dst, (const ALubyte*)buffer->data + pos*Channels*Bytes,
+                    count*Channels);
 }
-static __inline ALfloat cos_lerp(ALfloat val1, ALfloat val2, ALint frac)
+
+/* Returns the number of sample frames before the current position the
+ * resampler reads. */
+static __inline ALuint ResamplerPrePadding(resampler_t Resampler)
+{
+    if(Resampler == SINC_RESAMPLER)
+        return SincTaps/2 - 1;
+    return 0;
+}
+
+/* Returns the number of sample frames after the current position the
+ * resampler reads. */
+static __inline ALuint ResamplerPadding(resampler_t Resampler)
 {
-    ALfloat mult = (1.0f-cos(frac * (1.0f/(1<<FRACTIONBITS)) * M_PI)) * 0.5f;
-    return val1 + ((val2-val1)*mult);
+    if(Resampler == SINC_RESAMPLER)
+        return SincTaps/2;
+    return 1;
 }
 
-static void MixSomeSources(ALCcontext *ALContext, float (*DryBuffer)[OUTPUTCHANNELS], ALuint SamplesToDo)
+ALvoid aluInitResamplers(ALvoid)
 {
-    static float DummyBuffer[BUFFERSIZE];
+    ALint taps;
+
+    taps = GetConfigValueInt(NULL, "sinc-taps", DEFAULT_SINC_TAPS);
+    taps = (taps+3) & ~3;
+    if(taps < 4) taps = 4;
+    if(taps > MAX_SINC_TAPS) taps = MAX_SINC_TAPS;
+    InitResamplerTables(taps);
+}
+
+/* Source channel to output channel mapping for multi-channel formats */
+static const Channel *GetSourceChannelMap(ALuint Channels)
+{
+    static const Channel StereoChans[] = {
+        FRONT_LEFT, FRONT_RIGHT
+    };
+    static const Channel QuadChans[] = {
+        FRONT_LEFT, FRONT_RIGHT,
+        BACK_LEFT,  BACK_RIGHT
+    };
+    static const Channel X51Chans[] = {
+        FRONT_LEFT,   FRONT_RIGHT,
+        FRONT_CENTER, LFE,
+        BACK_LEFT,    BACK_RIGHT
+    };
+    static const Channel X61Chans[] = {
+        FRONT_LEFT,   FRONT_RIGHT,
+        FRONT_CENTER, LFE,
+        BACK_CENTER,
+        SIDE_LEFT,    SIDE_RIGHT
+    };
+    static const Channel X71Chans[] = {
+        FRONT_LEFT,   FRONT_RIGHT,
+        FRONT_CENTER, LFE,
+        BACK_LEFT,    BACK_RIGHT,
+        SIDE_LEFT,    SIDE_RIGHT
+    };
+
+    switch(Channels)
+    {
+        case 2: return StereoChans;
+        case 4: return QuadChans;
+        case 6: return X51Chans;
+        case 7: return X61Chans;
+        case 8: return X71Chans;
+    }
+    return NULL;
+}
+
+static __inline ALfloat RampGain(ALfloat gain, ALfloat step, ALuint count)
+{
+    while(count--)
+        gain += step;
+    return gain;
+}
+
+static PlacementProc SelectPlacementProc(void)
+{
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return CalcPlacements_SSE;
+#endif
+    return CalcPlacements_C;
+}
+
+static MixRowProc SelectRowMixer(void)
+{
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return MixRow_SSE;
+#endif
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return MixRow_Neon;
+#endif
+    return MixRow_C;
+}
+
+/* Number of source positions mixed from a window at once, near the ends of a
+ * float buffer, and the most mixed from one at once for other buffers (see
+ * MixSomeSources) */
+#define WINDOW_SPAN      16
+#define MAX_WINDOW_SPAN  BUFFERSIZE
+
+/* Scratch space used while mixing a source. Each mixing thread has its own,
+ * including the device's own mixing thread (ALCdevice::Scratch). */
+typedef struct MixScratch {
+    ALfloat DummyBuffer[BUFFERSIZE];
+    ALfloat ResampledData[BUFFERSIZE];
+    ALfloat FilteredData[BUFFERSIZE];
+    ALfloat StereoMatrix[OUTPUTCHANNELS][OUTPUTCHANNELS];
+    ALfloat Window[(MAX_WINDOW_SPAN+MAX_SINC_TAPS)*OUTPUTCHANNELS];
+
+    /* Staging for CalcStalePlacements, only used by the device's own thread */
+    PlacementBatch Placements;
+
+    /* Source parameter and placement recalculations done by this thread,
+     * collected into the device's counts after each update. */
+    ALuint ParamUpdates;
+    ALuint PlacementUpdates;
+} MixScratch;
+
+/* When a device has more than one mixing thread, its sources are dealt out
+ * round-robin into NumMixThreads groups. Group 0 is mixed by the device's own
+ * mixing thread directly into the device's buffers, and every other group is
+ * mixed by a helper thread into its own buffers, which are then summed in
+ * group order so the output doesn't depend on thread scheduling. */
+typedef struct ALmixthread {
+    ALCdevice *Device;
+    ALuint Group;
+
+    ALvoid *Thread;
+    ALvoid *Start;
+    ALuint SamplesToDo;
+    volatile ALboolean Quit;
+
+    MixScratch Scratch;
+    ALfloat DryBuffer[OUTPUTCHANNELS][BUFFERSIZE];
+} ALmixthread;
+
+struct ALmixpool {
+    ALvoid *Done;
+    ALmixthread *Threads;
+    ALuint NumThreads;
+};
+
+/* Takes the source's most recently published property block, if the mixer
+ * hasn't seen it yet. Returns true if the source's parameters need to be
+ * recalculated as a result. */
+static __inline ALboolean FetchSourceProps(ALsource *ALSource)
+{
+    if(!(ALSource->PropState&PROPS_FRESH))
+        return AL_FALSE;
+    ALSource->PropRead = ExchangeInt(&ALSource->PropState, ALSource->PropRead) &
+                         PROPS_INDEX_MASK;
+    return AL_TRUE;
+}
+
+/* Recalculates a source's mixing parameters after something changed. Only
+ * mono sources are spatialized, and their placement relative to the listener
+ * is reused if neither of them moved. */
+static ALvoid UpdateSourceParams(const ALCcontext *ALContext, ALsource *ALSource, ALuint Channels, MixScratch *Scratch)
+{
+    if(Channels == 1)
+    {
+        if(!SourcePlacementValid(ALContext, ALSource))
+        {
+            CalcSourcePlacement(ALContext, ALSource);
+            Scratch->PlacementUpdates++;
+        }
+        CalcSourceParams(ALContext, ALSource);
+    }
+    else
+        CalcNonAttnSourceParams(ALContext, ALSource);
+    ALSource->NeedsUpdate = AL_FALSE;
+    Scratch->ParamUpdates++;
+}
+
+/* Calculates the placements of a batch of sources gathered by
+ * CalcStalePlacements, and stores them with the sources. */
+static ALvoid CalcBatchPlacements(ALCcontext *ALContext, PlacementBatch *batch, ALsource **Sources, ALuint count, MixScratch *Scratch)
+{
+    PlacementProc CalcPlacements = SelectPlacementProc();
+    ALuint i;
+
+    CalcPlacements(batch, count, ALContext->Listener.Matrix,
+                   ALContext->Listener.LocalVelocity);
+
+    for(i = 0;i < count;i++)
+    {
+        ALsource *ALSource = Sources[i];
+
+        ALSource->Params.Placement.Distance = batch->Distance[i];
+        ALSource->Params.Placement.ConeAngle = aluAcos(batch->ConeCos[i]) * 180.0f/M_PI;
+        ALSource->Params.Placement.RearAngle = aluAcos(batch->RearCos[i]) * 180.0f/M_PI;
+        ALSource->Params.Placement.SourceSpeed = batch->SourceSpeed[i];
+        ALSource->Params.Placement.ListenerSpeed = batch->ListenerSpeed[i];
+        ALSource->Params.Placement.PanPos = aluCart2LUTpos(-batch->PanZ[i], batch->PanX[i]);
+        ALSource->Params.Placement.DirGain = batch->DirGain[i];
+        SetPlacementValid(ALContext, ALSource);
+    }
+    Scratch->PlacementUpdates += count;
+}
+
+/* Finds the playing mono sources whose placement is stale, and calculates
+ * them in batches before anything is mixed. When the listener moves, that's
+ * every source that isn't head-relative, and batching lets the placement math
+ * run on several sources at once. UpdateSourceParams then finds these
+ * placements up to date. Head-relative sources are left to it, since they
+ * don't use the listener's transform. The caller must hold the device lock. */
+static ALvoid CalcStalePlacements(ALCdevice *device)
+{
+    PlacementBatch *batch = &device->Scratch->Placements;
+    ALsource *Sources[PLACEMENT_BATCH];
+    ALuint c;
+
+    for(c = 0;c < device->NumContexts;c++)
+    {
+        ALCcontext *ALContext = device->Contexts[c];
+        ALsource *ALSource;
+        ALuint count = 0;
+
+        for(ALSource = ALContext->Source;ALSource;ALSource = ALSource->next)
+        {
+            const ALsourceProps *Props;
+            ALbufferlistitem *BufferListItem;
+
+            if(ALSource->state != AL_PLAYING || ALSource->bHeadRelative)
+                continue;
+            if(FetchSourceProps(ALSource))
+                ALSource->NeedsUpdate = AL_TRUE;
+            if(!ALSource->NeedsUpdate || SourcePlacementValid(ALContext, ALSource))
+                continue;
+
+            BufferListItem = ALSource->queue;
+            while(BufferListItem && !BufferListItem->buffer)
+                BufferListItem = BufferListItem->next;
+            if(!BufferListItem ||
+               aluChannelsFromFormat(BufferListItem->buffer->format) != 1)
+                continue;
+
+            Props = &ALSource->Props[ALSource->PropRead];
+            batch->PosX[count] = Props->Position[0];
+            batch->PosY[count] = Props->Position[1];
+            batch->PosZ[count] = Props->Position[2];
+            batch->VelX[count] = Props->Velocity[0];
+            batch->VelY[count] = Props->Velocity[1];
+            batch->VelZ[count] = Props->Velocity[2];
+            batch->DirX[count] = Props->Orientation[0];
+            batch->DirY[count] = Props->Orientation[1];
+            batch->DirZ[count] = Props->Orientation[2];
+            batch->RefDistance[count] = Props->RefDistance;
+            Sources[count++] = ALSource;
+
+            if(count == PLACEMENT_BATCH)
+            {
+                CalcBatchPlacements(ALContext, batch, Sources, count, device->Scratch);
+                count = 0;
+            }
+        }
+        if(count > 0)
+            CalcBatchPlacements(ALContext, batch, Sources, count, device->Scratch);
+    }
+}
+
+/* How loud a source will be once its gains finish ramping, scaled by its
+ * priority. Only sends that feed a slot count. */
+static ALfloat SourceAudibility(const ALsource *ALSource)
+{
+    ALfloat gain = 0.0f;
+    ALuint i;
+
+    for(i = 0;i < OUTPUTCHANNELS;i++)
+        gain = __max(gain, ALSource->Params.DryGains[i]);
+    for(i = 0;i < MAX_SENDS;i++)
+    {
+        if(ALSource->Send[i].Slot)
+            gain = __max(gain, ALSource->Params.WetGains[i]);
+    }
+    return gain * ALSource->Props[ALSource->PropRead].Priority;
+}
+
+static __inline ALvoid SiftVoiceUp(ALsource **heap, ALuint i)
+{
+    while(i > 0)
+    {
+        ALuint parent = (i-1)/2;
+        ALsource *tmp;
+
+        if(heap[parent]->Audibility <= heap[i]->Audibility)
+            break;
+        tmp = heap[parent]; heap[parent] = heap[i]; heap[i] = tmp;
+        i = parent;
+    }
+}
+
+static __inline ALvoid SiftVoiceDown(ALsource **heap, ALuint count, ALuint i)
+{
+    for(;;)
+    {
+        ALuint least = i;
+        ALuint child = i*2 + 1;
+        ALsource *tmp;
+
+        if(child < count && heap[child]->Audibility < heap[least]->Audibility)
+            least = child;
+        child++;
+        if(child < count && heap[child]->Audibility < heap[least]->Audibility)
+            least = child;
+        if(least == i)
+            break;
+        tmp = heap[least]; heap[least] = heap[i]; heap[i] = tmp;
+        i = least;
+    }
+}
+
+/* Picks the MaxVoices most audible playing sources across all of the device's
+ * contexts, and marks the rest as culled. The picked sources are kept in a
+ * min-heap so the least audible one can be replaced when a louder source comes
+ * along. Sources that are equally audible keep their place in the source
+ * list's order, so a tie doesn't make voices trade places every update.
+ *
+ * Culled sources are still processed by MixSomeSources, but with their target
+ * gains set to 0. They fade out with the normal gain ramp, and then only have
+ * their position advanced like any other inaudible source, so they pick up
+ * where they should be when they get a voice back and fade in again. Sources
+ * that are still fading out can briefly take the mixer over budget. */
+static ALvoid CullSources(ALCdevice *device)
+{
+    ALsource **heap = device->VoiceHeap;
+    ALuint count = 0;
+    ALuint c;
+
+    for(c = 0;c < device->NumContexts;c++)
+    {
+        ALCcontext *ALContext = device->Contexts[c];
+        ALsource *ALSource;
+
+        for(ALSource = ALContext->Source;ALSource;ALSource = ALSource->next)
+        {
+            if(ALSource->state != AL_PLAYING)
+                continue;
+
+            if(FetchSourceProps(ALSource))
+                ALSource->NeedsUpdate = AL_TRUE;
+            if(ALSource->NeedsUpdate)
+            {
+                ALbufferlistitem *BufferListItem = ALSource->queue;
+                ALuint Channels = 0;
+
+                while(BufferListItem && !BufferListItem->buffer)
+                    BufferListItem = BufferListItem->next;
+                if(BufferListItem)
+                    Channels = aluChannelsFromFormat(BufferListItem->buffer->format);
+
+                UpdateSourceParams(ALContext, ALSource, Channels, device->Scratch);
+            }
+
+            ALSource->Audibility = SourceAudibility(ALSource);
+            ALSource->Culled = AL_FALSE;
+            if(count < device->MaxVoices)
+            {
+                heap[count] = ALSource;
+                SiftVoiceUp(heap, count++);
+            }
+            else if(ALSource->Audibility > heap[0]->Audibility)
+            {
+                heap[0]->Culled = AL_TRUE;
+                heap[0] = ALSource;
+                SiftVoiceDown(heap, count, 0);
+            }
+            else
+                ALSource->Culled = AL_TRUE;
+        }
+    }
+}
+
+static void MixSomeSources(ALCcontext *ALContext, float (*DryBuffer)[BUFFERSIZE], MixScratch *Scratch, ALuint Group, ALuint SamplesToDo)
+{
+    ALfloat *DummyBuffer = Scratch->DummyBuffer;
+    ALfloat *ResampledData = Scratch->ResampledData;
+    ALfloat *FilteredData = Scratch->FilteredData;
+    MixRowProc MixRow;
+    ResamplerFunc Resample;
+    LoadSamplesProc LoadSamples;
+    const Channel *chans;
     ALfloat *WetBuffer[MAX_SENDS];
-    ALfloat (*Matrix)[OUTPUTCHANNELS] = ALContext->ChannelMatrix;
+    ALfloat (*Matrix)[OUTPUTCHANNELS];
+    ALuint SourceIndex, NumGroups;
+    ALuint PrePadding, PostPadding;
+    ALboolean Inaudible;
+    const Channel *OutChans;
+    ALuint NumOutChans;
+    static const ALfloat Silence[OUTPUTCHANNELS] = { 0.0f };
+    const ALfloat *TargetDry, *TargetWet;
     ALfloat DrySend[OUTPUTCHANNELS];
     ALfloat dryGainStep[OUTPUTCHANNELS];
     ALfloat wetGainStep[MAX_SENDS];
-    ALuint i, j, k, out;
+    ALuint i, j, m, out;
     ALsource *ALSource;
-    ALfloat value, outsamp;
     ALbufferlistitem *BufferListItem;
     ALint64 DataSize64,DataPos64;
     FILTER *DryFilter, *WetFilter[MAX_SENDS];
@@ -897,7 +1448,6 @@ static void MixSomeSources(ALCcontext *ALContext, float (*DryBuffer)[OUTPUTCHANN
     ALuint DataPosInt, DataPosFrac;
     ALuint Channels, Bytes;
     ALuint Frequency;
-    resampler_t Resampler;
     ALuint BuffersPlayed;
     ALfloat Pitch;
     ALenum State;
@@ -907,11 +1457,22 @@ static void MixSomeSources(ALCcontext *ALContext, float (*DryBuffer)[OUTPUTCHANN
 
     DeviceFreq = ALContext->Device->Frequency;
 
+    /* Only the channels the device actually outputs need to be mixed. The
+     * rest of the dry buffer gets dropped by aluMixData. */
+    OutChans = ALContext->Device->DevChannels;
+    NumOutChans = aluChannelsFromFormat(ALContext->Device->Format);
+
+    MixRow = SelectRowMixer();
+    NumGroups = ALContext->Device->NumMixThreads;
+    SourceIndex = 0;
+
     rampLength = DeviceFreq * MIN_RAMP_LENGTH / 1000;
     rampLength = max(rampLength, SamplesToDo);
 
 another_source:
-    if(ALSource->state != AL_PLAYING)
+    /* Sources belonging to another group must be left alone, since another
+     * thread may be mixing them */
+    if((SourceIndex++)%NumGroups != Group || ALSource->state != AL_PLAYING)
     {
         if((ALSource=ALSource->next) != NULL)
             goto another_source;
@@ -937,18 +1498,17 @@ another_source:
         BufferListItem = BufferListItem->next;
     }
 
+    if(FetchSourceProps(ALSource))
+        ALSource->NeedsUpdate = AL_TRUE;
     if(ALSource->NeedsUpdate)
-    {
-        //Only apply 3D calculations for mono buffers
-        if(Channels == 1)
-            CalcSourceParams(ALContext, ALSource);
-        else
-            CalcNonAttnSourceParams(ALContext, ALSource);
-        ALSource->NeedsUpdate = AL_FALSE;
-    }
+        UpdateSourceParams(ALContext, ALSource, Channels, Scratch);
 
     /* Get source info */
-    Resampler     = ALSource->Resampler;
+    Resample      = SelectResampler(ALSource->Resampler);
+    PrePadding    = ResamplerPrePadding(ALSource->Resampler);
+    PostPadding   = ResamplerPadding(ALSource->Resampler);
+    LoadSamples   = SelectSampleLoader(Bytes);
+    chans         = GetSourceChannelMap(Channels);
     State         = ALSource->state;
     BuffersPlayed = ALSource->BuffersPlayed;
     DataPosInt    = ALSource->position;
@@ -960,13 +1520,22 @@ another_source:
     increment = (ALint)(Pitch*(ALfloat)(1L<<FRACTIONBITS));
     if(increment <= 0)  increment = (1<<FRACTIONBITS);
 
+    /* Culled sources fade to silence */
+    TargetDry = ALSource->Params.DryGains;
+    TargetWet = ALSource->Params.WetGains;
+    if(ALSource->Culled)
+    {
+        TargetDry = Silence;
+        TargetWet = Silence;
+    }
+
     /* Compute the gain steps for each output channel */
     if(ALSource->FirstStart)
     {
         for(i = 0;i < OUTPUTCHANNELS;i++)
-            DrySend[i] = ALSource->Params.DryGains[i];
+            DrySend[i] = TargetDry[i];
         for(i = 0;i < MAX_SENDS;i++)
-            WetSend[i] = ALSource->Params.WetGains[i];
+            WetSend[i] = TargetWet[i];
     }
     else
     {
@@ -976,82 +1545,70 @@ another_source:
             WetSend[i] = ALSource->WetGains[i];
     }
 
+    /* A source is inaudible if every gain it would be mixed with, now and at
+     * the end of any ramp, is too small to be heard */
+    Inaudible = AL_TRUE;
+    for(i = 0;i < OUTPUTCHANNELS;i++)
+    {
+        if(DrySend[i] > INAUDIBLE_GAIN || TargetDry[i] > INAUDIBLE_GAIN)
+            Inaudible = AL_FALSE;
+    }
+    for(i = 0;i < MAX_SENDS;i++)
+    {
+        if(ALSource->Send[i].Slot &&
+           (WetSend[i] > INAUDIBLE_GAIN || TargetWet[i] > INAUDIBLE_GAIN))
+            Inaudible = AL_FALSE;
+    }
+
     DryFilter = &ALSource->Params.iirFilter;
     for(i = 0;i < MAX_SENDS;i++)
     {
         WetFilter[i] = &ALSource->Params.Send[i].iirFilter;
-        WetBuffer[i] = (ALSource->Send[i].Slot ?
-                        ALSource->Send[i].Slot->WetBuffer :
-                        DummyBuffer);
+        if(!ALSource->Send[i].Slot)
+            WetBuffer[i] = DummyBuffer;
+        else if(Group == 0)
+            WetBuffer[i] = ALSource->Send[i].Slot->WetBuffer;
+        else
+            WetBuffer[i] = ALSource->Send[i].Slot->ThreadWetBuffer[Group-1];
     }
 
+    /* Duplicated stereo uses a modified copy of the channel matrix, since the
+     * context's matrix is shared by every mixing thread */
+    Matrix = ALContext->ChannelMatrix;
     if(DuplicateStereo && Channels == 2)
     {
+        memcpy(Scratch->StereoMatrix, Matrix, sizeof(Scratch->StereoMatrix));
+        Matrix = Scratch->StereoMatrix;
         Matrix[FRONT_LEFT][SIDE_LEFT]   = 1.0f;
         Matrix[FRONT_RIGHT][SIDE_RIGHT] = 1.0f;
         Matrix[FRONT_LEFT][BACK_LEFT]   = 1.0f;
         Matrix[FRONT_RIGHT][BACK_RIGHT] = 1.0f;
     }
-    else if(DuplicateStereo)
-    {
-        Matrix[FRONT_LEFT][SIDE_LEFT]   = 0.0f;
-        Matrix[FRONT_RIGHT][SIDE_RIGHT] = 0.0f;
-        Matrix[FRONT_LEFT][BACK_LEFT]   = 0.0f;
-        Matrix[FRONT_RIGHT][BACK_RIGHT] = 0.0f;
-    }
 
     /* Get current buffer queue item */
-    BufferListItem = ALSource->queue;
-    for(i = 0;i < BuffersPlayed && BufferListItem;i++)
-        BufferListItem = BufferListItem->next;
+    BufferListItem = ALSource->CurrentItem;
 
     while(State == AL_PLAYING && j < SamplesToDo)
     {
         ALuint DataSize = 0;
         ALbuffer *ALBuffer;
-        ALfloat *Data;
+        const ALfloat *Data;
         ALuint BufferSize;
 
         /* Get buffer info */
         if((ALBuffer=BufferListItem->buffer) != NULL)
         {
-            Data      = ALBuffer->data;
             DataSize  = ALBuffer->size;
             DataSize /= Channels * Bytes;
         }
         if(DataPosInt >= DataSize)
             goto skipmix;
 
-        if(BufferListItem->next)
-        {
-            ALbuffer *NextBuf = BufferListItem->next->buffer;
-            if(NextBuf && NextBuf->size)
-            {
-                ALint ulExtraSamples = BUFFER_PADDING*Channels*Bytes;
-                ulExtraSamples = min(NextBuf->size, ulExtraSamples);
-                memcpy(&Data[DataSize*Channels], NextBuf->data, ulExtraSamples);
-            }
-        }
-        else if(ALSource->bLooping)
-        {
-            ALbuffer *NextBuf = ALSource->queue->buffer;
-            if(NextBuf && NextBuf->size)
-            {
-                ALint ulExtraSamples = BUFFER_PADDING*Channels*Bytes;
-                ulExtraSamples = min(NextBuf->size, ulExtraSamples);
-                memcpy(&Data[DataSize*Channels], NextBuf->data, ulExtraSamples);
-            }
-        }
-        else
-            memset(&Data[DataSize*Channels], 0, (BUFFER_PADDING*Channels*Bytes));
-
         /* Compute the gain steps for each output channel */
         for(i = 0;i < OUTPUTCHANNELS;i++)
-            dryGainStep[i] = (ALSource->Params.DryGains[i]-DrySend[i]) /
-                             rampLength;
+            dryGainStep[i] = (TargetDry[i]-DrySend[i]) / rampLength;
         for(i = 0;i < MAX_SENDS;i++)
-            wetGainStep[i] = (ALSource->Params.WetGains[i]-WetSend[i]) /
-                             rampLength;
+            wetGainStep[i] = (TargetWet[i]-WetSend[i]) / rampLength;
 
         /* Figure out how many samples we can mix. */
         DataSize64 = DataSize;
@@ -1063,216 +1620,188 @@ another_source:
 
         BufferSize = min(BufferSize, (SamplesToDo-j));
 
-        /* Actual sample mixing loop */
-        k = 0;
-        Data += DataPosInt*Channels;
-
-        if(Channels == 1) /* Mono */
+        /* Inaudible sources only need their position advanced, so the sample
+         * data isn't touched */
+        if(Inaudible)
+            goto skipsamples;
+
+        /* The resampler reads a few samples on either side of the current
+         * position, which near the ends of this buffer come from the buffers
+         * queued before or after it (or silence). Buffers may be shared between sources,
+         * so they're never written to here. Instead, those samples are
+         * gathered with this buffer's into a window, which the block is mixed
+         * from until it runs out. Buffers that don't hold float samples are
+         * always mixed from a window, which their samples are converted (or
+         * decoded) into as they're gathered, so it covers up to
+         * MAX_WINDOW_SPAN positions.
+         * Everywhere else, float buffers are read directly, stopping before
+         * the samples past the end are needed. */
+        if(Bytes != sizeof(ALfloat) ||
+           DataPosInt < PrePadding || DataPosInt+PostPadding >= DataSize)
         {
-#define DO_MIX(resampler) do { \
-    while(BufferSize--) \
-    { \
-        for(i = 0;i < OUTPUTCHANNELS;i++) \
-            DrySend[i] += dryGainStep[i]; \
-        for(i = 0;i < MAX_SENDS;i++) \
-            WetSend[i] += wetGainStep[i]; \
- \
-        /* First order interpolator */ \
-        value = (resampler)(Data[k], Data[k+1], DataPosFrac); \
- \
-        /* Direct path final mix buffer and panning */ \
-        outsamp = lpFilter4P(DryFilter, 0, value); \
-        DryBuffer[j][FRONT_LEFT]   += outsamp*DrySend[FRONT_LEFT]; \
-        DryBuffer[j][FRONT_RIGHT]  += outsamp*DrySend[FRONT_RIGHT]; \
-        DryBuffer[j][SIDE_LEFT]    += outsamp*DrySend[SIDE_LEFT]; \
-        DryBuffer[j][SIDE_RIGHT]   += outsamp*DrySend[SIDE_RIGHT]; \
-        DryBuffer[j][BACK_LEFT]    += outsamp*DrySend[BACK_LEFT]; \
-        DryBuffer[j][BACK_RIGHT]   += outsamp*DrySend[BACK_RIGHT]; \
-        DryBuffer[j][FRONT_CENTER] += outsamp*DrySend[FRONT_CENTER]; \
-        DryBuffer[j][BACK_CENTER]  += outsamp*DrySend[BACK_CENTER]; \
- \
-        /* Room path final mix buffer and panning */ \
-        for(i = 0;i < MAX_SENDS;i++) \
-        { \
-            outsamp = lpFilter2P(WetFilter[i], 0, value); \
-            WetBuffer[i][j] += outsamp*WetSend[i]; \
-        } \
- \
-        DataPosFrac += increment; \
-        k += DataPosFrac>>FRACTIONBITS; \
-        DataPosFrac &= FRACTIONMASK; \
-        j++; \
-    } \
-} while(0)
-
-            switch(Resampler)
+            ALfloat *Window = Scratch->Window;
+            ALbufferlistitem *Item;
+            ALuint Span, count, size, k, n;
+            ALint pos;
+
+            /* Only gather the positions this block starts from, up to the
+             * window's span */
+            Span = ((Bytes == sizeof(ALfloat)) ? WINDOW_SPAN : MAX_WINDOW_SPAN);
+            count = (ALuint)((DataPosFrac + (ALint64)increment*(BufferSize-1)) >>
+                             FRACTIONBITS) + 1;
+            if(count > Span)
             {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
+                count = Span;
+                BufferSize = min(BufferSize,
+                                 (ALuint)((((ALint64)Span<<FRACTIONBITS) - DataPosFrac +
+                                           (increment-1)) / increment));
             }
-#undef DO_MIX
-        }
-        else if(Channels == 2) /* Stereo */
-        {
-            const int chans[] = {
-                FRONT_LEFT, FRONT_RIGHT
-            };
-            const ALfloat scaler = aluSqrt(1.0f/Channels);
-
-#define DO_MIX(resampler) do { \
-    while(BufferSize--) \
-    { \
-        for(i = 0;i < OUTPUTCHANNELS;i++) \
-            DrySend[i] += dryGainStep[i]; \
-        for(i = 0;i < MAX_SENDS;i++) \
-            WetSend[i] += wetGainStep[i]; \
- \
-        for(i = 0;i < Channels;i++) \
-        { \
-            value = (resampler)(Data[k*Channels + i], Data[(k+1)*Channels + i], \
-                                DataPosFrac); \
-            outsamp = lpFilter2P(DryFilter, chans[i]*2, value)*DrySend[chans[i]]; \
-            for(out = 0;out < OUTPUTCHANNELS;out++) \
-                DryBuffer[j][out] += outsamp*Matrix[chans[i]][out]; \
-            for(out = 0;out < MAX_SENDS;out++) \
-            { \
-                outsamp = lpFilter1P(WetFilter[out], chans[i], value); \
-                WetBuffer[out][j] += outsamp*WetSend[out]*scaler; \
-            } \
-        } \
- \
-        DataPosFrac += increment; \
-        k += DataPosFrac>>FRACTIONBITS; \
-        DataPosFrac &= FRACTIONMASK; \
-        j++; \
-    } \
-} while(0)
-
-            switch(Resampler)
+            count += PrePadding + PostPadding;
+
+            /* The frames before this buffer come from the end of the ones
+             * queued before it, as many as it takes, going round to the end
+             * of the queue for looping sources. They're filled in from the
+             * back of their part of the window. Since this buffer isn't
+             * empty, going round always gets somewhere. */
+            pos = (ALint)DataPosInt - (ALint)PrePadding;
+            k = ((pos < 0) ? (ALuint)-pos : 0);
+            Item = BufferListItem;
+            while(k > 0)
             {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
+                Item = Item->prev;
+                if(!Item && ALSource->bLooping)
+                    Item = ALSource->QueueTail;
+                if(!Item)
+                {
+                    memset(Window, 0, k*Channels*sizeof(ALfloat));
+                    break;
+                }
+                if(!Item->buffer)
+                    continue;
+
+                size = Item->buffer->size / (Channels*Bytes);
+                n = min(k, size);
+                k -= n;
+                LoadWindowFrames(ALSource, &Window[k*Channels], Item->buffer,
+                                 size-n, n, Channels, Bytes, LoadSamples);
             }
-        }
-        else if(Channels == 4) /* Quad */
-        {
-            const int chans[] = {
-                FRONT_LEFT, FRONT_RIGHT,
-                BACK_LEFT,  BACK_RIGHT
-            };
-            const ALfloat scaler = aluSqrt(1.0f/Channels);
-
-            switch(Resampler)
+            k = ((pos < 0) ? (ALuint)-pos : 0);
+
+            /* Then this buffer's frames, up to its end */
+            n = min(count-k, DataSize-(ALuint)(pos+(ALint)k));
+            LoadWindowFrames(ALSource, &Window[k*Channels], ALBuffer,
+                             (ALuint)(pos+(ALint)k), n, Channels, Bytes, LoadSamples);
+            k += n;
+
+            /* And the rest from the start of the buffers queued after it,
+             * or silence once the queue runs out */
+            Item = BufferListItem;
+            while(k < count)
             {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
+                Item = Item->next;
+                if(!Item && ALSource->bLooping)
+                    Item = ALSource->queue;
+                if(!Item)
+                {
+                    memset(&Window[k*Channels], 0, (count-k)*Channels*sizeof(ALfloat));
+                    break;
+                }
+                if(!Item->buffer)
+                    continue;
+
+                size = Item->buffer->size / (Channels*Bytes);
+                n = min(count-k, size);
+                LoadWindowFrames(ALSource, &Window[k*Channels], Item->buffer,
+                                 0, n, Channels, Bytes, LoadSamples);
+                k += n;
             }
+
+            Data = &Window[PrePadding*Channels];
         }
-        else if(Channels == 6) /* 5.1 */
+        else
         {
-            const int chans[] = {
-                FRONT_LEFT,   FRONT_RIGHT,
-                FRONT_CENTER, LFE,
-                BACK_LEFT,    BACK_RIGHT
-            };
-            const ALfloat scaler = aluSqrt(1.0f/Channels);
+            ALuint count;
 
-            switch(Resampler)
-            {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
-            }
+            count = (ALuint)((((ALint64)(DataSize-PostPadding)<<FRACTIONBITS) -
+                              DataPos64 + (increment-1)) / increment);
+            BufferSize = min(BufferSize, count);
+
+            Data = (const ALfloat*)ALBuffer->data + DataPosInt*Channels;
         }
-        else if(Channels == 7) /* 6.1 */
+
+        /* Actual sample mixing loop. Each channel is first resampled to a
+         * block, which is filtered, and then mixed with a ramping gain for
+         * each output. */
+        if(Channels == 1) /* Mono */
         {
-            const int chans[] = {
-                FRONT_LEFT,   FRONT_RIGHT,
-                FRONT_CENTER, LFE,
-                BACK_CENTER,
-                SIDE_LEFT,    SIDE_RIGHT
-            };
-            const ALfloat scaler = aluSqrt(1.0f/Channels);
+            Resample(Data, 1, DataPosFrac, increment, ResampledData, BufferSize);
 
-            switch(Resampler)
+            /* Direct path final mix buffer and panning */
+            for(m = 0;m < BufferSize;m++)
+                FilteredData[m] = lpFilter4P(DryFilter, 0, ResampledData[m]);
+            for(i = 0;i < NumOutChans;i++)
             {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
+                out = OutChans[i];
+                /* Mono sources aren't mixed to the LFE channel, and there's
+                 * nothing to add for channels that are panned silent */
+                if(out == LFE || (DrySend[out] == 0.0f && dryGainStep[out] == 0.0f))
+                    continue;
+                MixRow(&DryBuffer[out][j], FilteredData, DrySend[out],
+                       dryGainStep[out], 1.0f, BufferSize);
             }
-        }
-        else if(Channels == 8) /* 7.1 */
-        {
-            const int chans[] = {
-                FRONT_LEFT,   FRONT_RIGHT,
-                FRONT_CENTER, LFE,
-                BACK_LEFT,    BACK_RIGHT,
-                SIDE_LEFT,    SIDE_RIGHT
-            };
-            const ALfloat scaler = aluSqrt(1.0f/Channels);
 
-            switch(Resampler)
+            /* Room path final mix buffer and panning */
+            for(out = 0;out < MAX_SENDS;out++)
             {
-                case POINT_RESAMPLER:
-                DO_MIX(point); break;
-                case LINEAR_RESAMPLER:
-                DO_MIX(lerp); break;
-                case COSINE_RESAMPLER:
-                DO_MIX(cos_lerp); break;
-                case RESAMPLER_MIN:
-                case RESAMPLER_MAX:
-                break;
+                for(m = 0;m < BufferSize;m++)
+                    FilteredData[m] = lpFilter2P(WetFilter[out], 0, ResampledData[m]);
+                MixRow(&WetBuffer[out][j], FilteredData, WetSend[out],
+                       wetGainStep[out], 1.0f, BufferSize);
             }
-#undef DO_MIX
         }
-        else /* Unknown? */
+        else if(chans) /* Multi-channel */
         {
-            for(i = 0;i < OUTPUTCHANNELS;i++)
-                DrySend[i] += dryGainStep[i]*BufferSize;
-            for(i = 0;i < MAX_SENDS;i++)
-                WetSend[i] += wetGainStep[i]*BufferSize;
-            while(BufferSize--)
+            const ALfloat scaler = aluSqrt(1.0f/Channels);
+
+            for(i = 0;i < Channels;i++)
             {
-                DataPosFrac += increment;
-                k += DataPosFrac>>FRACTIONBITS;
-                DataPosFrac &= FRACTIONMASK;
-                j++;
+                Resample(Data+i, Channels, DataPosFrac, increment,
+                         ResampledData, BufferSize);
+
+                for(m = 0;m < BufferSize;m++)
+                    FilteredData[m] = lpFilter2P(DryFilter, chans[i]*2, ResampledData[m]);
+                for(m = 0;m < NumOutChans;m++)
+                {
+                    /* Most of the matrix is empty, so skip the outputs this
+                     * channel doesn't feed */
+                    out = OutChans[m];
+                    if(Matrix[chans[i]][out] == 0.0f)
+                        continue;
+                    MixRow(&DryBuffer[out][j], FilteredData, DrySend[chans[i]],
+                           dryGainStep[chans[i]], Matrix[chans[i]][out],
+                           BufferSize);
+                }
+
+                for(out = 0;out < MAX_SENDS;out++)
+                {
+                    for(m = 0;m < BufferSize;m++)
+                        FilteredData[m] = lpFilter1P(WetFilter[out], chans[i], ResampledData[m]);
+                    MixRow(&WetBuffer[out][j], FilteredData, WetSend[out],
+                           wetGainStep[out], scaler, BufferSize);
+                }
             }
         }
-        DataPosInt += k;
+    skipsamples:
+        for(i = 0;i < OUTPUTCHANNELS;i++)
+            DrySend[i] = RampGain(DrySend[i], dryGainStep[i], BufferSize);
+        for(i = 0;i < MAX_SENDS;i++)
+            WetSend[i] = RampGain(WetSend[i], wetGainStep[i], BufferSize);
+
+        DataPos64  = DataPosFrac;
+        DataPos64 += (ALint64)increment*BufferSize;
+        DataPosInt += (ALuint)(DataPos64>>FRACTIONBITS);
+        DataPosFrac = (ALuint)(DataPos64&FRACTIONMASK);
+        j += BufferSize;
 
     skipmix:
         /* Handle looping sources */
@@ -1307,6 +1836,8 @@ another_source:
     /* Update source info */
     ALSource->state             = State;
     ALSource->BuffersPlayed     = BuffersPlayed;
+    ALSource->CurrentItem       = ((BuffersPlayed < ALSource->BuffersInQueue) ?
+                                   BufferListItem : NULL);
     ALSource->position          = DataPosInt;
     ALSource->position_fraction = DataPosFrac;
     ALSource->Buffer            = BufferListItem->buffer;
@@ -1322,13 +1853,205 @@ another_source:
         goto another_source;
 }
 
+static ALuint MixThreadProc(ALvoid *ptr)
+{
+    ALmixthread *thread = (ALmixthread*)ptr;
+    ALCdevice *device = thread->Device;
+    ALuint c;
+
+    /* This thread only ever mixes, so it can keep the mixer's rounding mode */
+#if defined(HAVE_FESETROUND)
+    fesetround(FE_TOWARDZERO);
+#elif defined(HAVE__CONTROLFP)
+    _controlfp(_RC_CHOP, _MCW_RC);
+#endif
+
+    while(1)
+    {
+        WaitSem(thread->Start);
+        if(thread->Quit)
+            break;
+
+        for(c = 0;c < OUTPUTCHANNELS;c++)
+            memset(thread->DryBuffer[c], 0, thread->SamplesToDo*sizeof(ALfloat));
+        for(c = 0;c < device->NumContexts;c++)
+            MixSomeSources(device->Contexts[c], thread->DryBuffer,
+                           &thread->Scratch, thread->Group, thread->SamplesToDo);
+
+        PostSem(device->MixPool->Done);
+    }
+
+    return 0;
+}
+
+/* Mixes the sources of every context on the device, splitting them between
+ * the device's mixing threads. The caller must hold the device lock. */
+static ALvoid MixThreadedSources(ALCdevice *device, ALfloat (*DryBuffer)[BUFFERSIZE], ALuint SamplesToDo)
+{
+    struct ALmixpool *pool = device->MixPool;
+    ALeffectslot *ALEffectSlot;
+    ALuint i, c, t;
+
+    for(t = 0;t < pool->NumThreads;t++)
+    {
+        pool->Threads[t].SamplesToDo = SamplesToDo;
+        PostSem(pool->Threads[t].Start);
+    }
+
+    for(c = 0;c < device->NumContexts;c++)
+        MixSomeSources(device->Contexts[c], DryBuffer, device->Scratch, 0, SamplesToDo);
+
+    for(t = 0;t < pool->NumThreads;t++)
+        WaitSem(pool->Done);
+
+    /* Sum each group's output in a fixed order */
+    for(t = 0;t < pool->NumThreads;t++)
+    {
+        for(c = 0;c < OUTPUTCHANNELS;c++)
+        {
+            for(i = 0;i < SamplesToDo;i++)
+                DryBuffer[c][i] += pool->Threads[t].DryBuffer[c][i];
+        }
+    }
+    for(c = 0;c < device->NumContexts;c++)
+    {
+        ALEffectSlot = device->Contexts[c]->AuxiliaryEffectSlot;
+        while(ALEffectSlot)
+        {
+            for(t = 0;t < pool->NumThreads;t++)
+            {
+                ALfloat *ThreadWetBuffer = ALEffectSlot->ThreadWetBuffer[t];
+                for(i = 0;i < SamplesToDo;i++)
+                {
+                    ALEffectSlot->WetBuffer[i] += ThreadWetBuffer[i];
+                    ThreadWetBuffer[i] = 0.0f;
+                }
+            }
+            ALEffectSlot = ALEffectSlot->next;
+        }
+    }
+}
+
+static ALvoid StopMixThreads(ALCdevice *device)
+{
+    struct ALmixpool *pool = device->MixPool;
+    ALuint t;
+
+    if(pool)
+    {
+        for(t = 0;t < pool->NumThreads;t++)
+        {
+            pool->Threads[t].Quit = AL_TRUE;
+            PostSem(pool->Threads[t].Start);
+            StopThread(pool->Threads[t].Thread);
+            DestroySem(pool->Threads[t].Start);
+        }
+        free(pool->Threads);
+        if(pool->Done)
+            DestroySem(pool->Done);
+        free(pool);
+    }
+    device->MixPool = NULL;
+    device->NumMixThreads = 1;
+}
+
+/* Sets up the device's mixing state. If the extra mixing threads can't be
+ * started, the device falls back to mixing on its own thread. Only returns
+ * false if there isn't enough memory for the device to mix at all. */
+ALboolean aluInitMixThreads(ALCdevice *device)
+{
+    struct ALmixpool *pool;
+    ALuint t;
+
+    device->MixPool = NULL;
+    device->Scratch = calloc(1, sizeof(*device->Scratch));
+    if(!device->Scratch)
+        return AL_FALSE;
+
+    if(device->NumMixThreads <= 1)
+    {
+        device->NumMixThreads = 1;
+        return AL_TRUE;
+    }
+
+    pool = calloc(1, sizeof(*pool));
+    if(!pool)
+        goto error;
+    device->MixPool = pool;
+
+    pool->Done = CreateSem();
+    pool->Threads = calloc(device->NumMixThreads-1, sizeof(*pool->Threads));
+    if(!pool->Done || !pool->Threads)
+        goto error;
+
+    for(t = 0;t < device->NumMixThreads-1;t++)
+    {
+        ALmixthread *thread = &pool->Threads[t];
+
+        thread->Device = device;
+        thread->Group = t+1;
+        thread->Quit = AL_FALSE;
+        thread->Start = CreateSem();
+        if(!thread->Start)
+            goto error;
+        thread->Thread = StartThread(MixThreadProc, thread);
+        if(!thread->Thread)
+        {
+            DestroySem(thread->Start);
+            goto error;
+        }
+        pool->NumThreads++;
+    }
+
+    return AL_TRUE;
+
+error:
+    AL_PRINT("Failed to start %u mixing threads, mixing on one thread\n",
+             device->NumMixThreads-1);
+    StopMixThreads(device);
+    return AL_TRUE;
+}
+
+ALvoid aluDeinitMixThreads(ALCdevice *device)
+{
+    StopMixThreads(device);
+    free(device->Scratch);
+    device->Scratch = NULL;
+}
+
+/* Takes the counts of source recalculations from the device's mixing threads,
+ * adding them to the given totals. The caller must hold the device lock. */
+static ALvoid CollectUpdateCounts(ALCdevice *device, ALuint *ParamUpdates, ALuint *PlacementUpdates)
+{
+    ALuint t;
+
+    *ParamUpdates += device->Scratch->ParamUpdates;
+    *PlacementUpdates += device->Scratch->PlacementUpdates;
+    device->Scratch->ParamUpdates = 0;
+    device->Scratch->PlacementUpdates = 0;
+
+    if(!device->MixPool)
+        return;
+    for(t = 0;t < device->MixPool->NumThreads;t++)
+    {
+        MixScratch *Scratch = &device->MixPool->Threads[t].Scratch;
+
+        *ParamUpdates += Scratch->ParamUpdates;
+        *PlacementUpdates += Scratch->PlacementUpdates;
+        Scratch->ParamUpdates = 0;
+        Scratch->PlacementUpdates = 0;
+    }
+}
+
 ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
 {
-    float (*DryBuffer)[OUTPUTCHANNELS];
+    float (*DryBuffer)[BUFFERSIZE];
     const Channel *ChanMap;
     ALuint SamplesToDo;
     ALeffectslot *ALEffectSlot;
     ALCcontext *ALContext;
+    ALuint ParamUpdates = 0;
+    ALuint PlacementUpdates = 0;
     int fpuState;
     ALuint i, c;
 
@@ -1349,15 +2072,22 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
         SamplesToDo = min(size, BUFFERSIZE);
 
         /* Clear mixing buffer */
-        memset(DryBuffer, 0, SamplesToDo*OUTPUTCHANNELS*sizeof(ALfloat));
-
-        SuspendContext(NULL);
+        for(c = 0;c < OUTPUTCHANNELS;c++)
+            memset(DryBuffer[c], 0, SamplesToDo*sizeof(ALfloat));
+
+        /* The device lock covers all of its contexts */
+        LockDevice(device);
+        CalcStalePlacements(device);
+        if(device->MaxVoices > 0)
+            CullSources(device);
+        if(device->MixPool)
+            MixThreadedSources(device, DryBuffer, SamplesToDo);
         for(c = 0;c < device->NumContexts;c++)
         {
             ALContext = device->Contexts[c];
-            SuspendContext(ALContext);
 
-            MixSomeSources(ALContext, DryBuffer, SamplesToDo);
+            if(!device->MixPool)
+                MixSomeSources(ALContext, DryBuffer, device->Scratch, 0, SamplesToDo);
 
             /* effect slot processing */
             ALEffectSlot = ALContext->AuxiliaryEffectSlot;
@@ -1370,9 +2100,9 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
                     ALEffectSlot->WetBuffer[i] = 0.0f;
                 ALEffectSlot = ALEffectSlot->next;
             }
-            ProcessContext(ALContext);
         }
-        ProcessContext(NULL);
+        CollectUpdateCounts(device, &ParamUpdates, &PlacementUpdates);
+        UnlockDevice(device);
 
         //Post processing loop
         ChanMap = device->DevChannels;
@@ -1382,7 +2112,7 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
         case AL_FORMAT_MONO##bits:                                            \
             for(i = 0;i < SamplesToDo;i++)                                    \
             {                                                                 \
-                ((type*)buffer)[0] = (func)(DryBuffer[i][ChanMap[0]]);        \
+                ((type*)buffer)[0] = (func)(DryBuffer[ChanMap[0]][i]);        \
                 buffer = ((type*)buffer) + 1;                                 \
             }                                                                 \
             break;                                                            \
@@ -1392,8 +2122,8 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
                 for(i = 0;i < SamplesToDo;i++)                                \
                 {                                                             \
                     float samples[2];                                         \
-                    samples[0] = DryBuffer[i][ChanMap[0]];                    \
-                    samples[1] = DryBuffer[i][ChanMap[1]];                    \
+                    samples[0] = DryBuffer[ChanMap[0]][i];                    \
+                    samples[1] = DryBuffer[ChanMap[1]][i];                    \
                     bs2b_cross_feed(device->Bs2b, samples);                   \
                     ((type*)buffer)[0] = (func)(samples[0]);                  \
                     ((type*)buffer)[1] = (func)(samples[1]);                  \
@@ -1404,8 +2134,8 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
             {                                                                 \
                 for(i = 0;i < SamplesToDo;i++)                                \
                 {                                                             \
-                    ((type*)buffer)[0] = (func)(DryBuffer[i][ChanMap[0]]);    \
-                    ((type*)buffer)[1] = (func)(DryBuffer[i][ChanMap[1]]);    \
+                    ((type*)buffer)[0] = (func)(DryBuffer[ChanMap[0]][i]);    \
+                    ((type*)buffer)[1] = (func)(DryBuffer[ChanMap[1]][i]);    \
                     buffer = ((type*)buffer) + 2;                             \
                 }                                                             \
             }                                                                 \
@@ -1413,49 +2143,49 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
         case AL_FORMAT_QUAD##bits:                                            \
             for(i = 0;i < SamplesToDo;i++)                                    \
             {                                                                 \
-                ((type*)buffer)[0] = (func)(DryBuffer[i][ChanMap[0]]);        \
-                ((type*)buffer)[1] = (func)(DryBuffer[i][ChanMap[1]]);        \
-                ((type*)buffer)[2] = (func)(DryBuffer[i][ChanMap[2]]);        \
-                ((type*)buffer)[3] = (func)(DryBuffer[i][ChanMap[3]]);        \
+                ((type*)buffer)[0] = (func)(DryBuffer[ChanMap[0]][i]);        \
+                ((type*)buffer)[1] = (func)(DryBuffer[ChanMap[1]][i]);        \
+                ((type*)buffer)[2] = (func)(DryBuffer[ChanMap[2]][i]);        \
+                ((type*)buffer)[3] = (func)(DryBuffer[ChanMap[3]][i]);        \
                 buffer = ((type*)buffer) + 4;                                 \
             }                                                                 \
             break;                                                            \
         case AL_FORMAT_51CHN##bits:                                           \
             for(i = 0;i < SamplesToDo;i++)                                    \
             {                                                                 \
-                ((type*)buffer)[0] = (func)(DryBuffer[i][ChanMap[0]]);        \
-                ((type*)buffer)[1] = (func)(DryBuffer[i][ChanMap[1]]);        \
-                ((type*)buffer)[2] = (func)(DryBuffer[i][ChanMap[2]]);        \
-                ((type*)buffer)[3] = (func)(DryBuffer[i][ChanMap[3]]);        \
-                ((type*)buffer)[4] = (func)(DryBuffer[i][ChanMap[4]]);        \
-                ((type*)buffer)[5] = (func)(DryBuffer[i][ChanMap[5]]);        \
+                ((type*)buffer)[0] = (func)(DryBuffer[ChanMap[0]][i]);        \
+                ((type*)buffer)[1] = (func)(DryBuffer[ChanMap[1]][i]);        \
+                ((type*)buffer)[2] = (func)(DryBuffer[ChanMap[2]][i]);        \
+                ((type*)buffer)[3] = (func)(DryBuffer[ChanMap[3]][i]);        \
+                ((type*)buffer)[4] = (func)(DryBuffer[ChanMap[4]][i]);        \
+                ((type*)buffer)[5] = (func)(DryBuffer[ChanMap[5]][i]);        \
                 buffer = ((type*)buffer) + 6;                                 \
             }                                                                 \
             break;                                                            \
         case AL_FORMAT_61CHN##bits:                                           \
             for(i = 0;i < SamplesToDo;i++)                                    \
             {                                                                 \
-                ((type*)buffer)[0] = (func)(DryBuffer[i][ChanMap[0]]);        \
-                ((type*)buffer)[1] = (func)(DryBuffer[i][ChanMap[1]]);        \
-                ((type*)buffer)[2] = (func)(DryBuffer[i][ChanMap[2]]);        \
-                ((type*)buffer)[3] = (func)(DryBuffer[i][ChanMap[3]]);        \
-                ((type*)buffer)[4] = (func)(DryBuffer[i][ChanMap[4]]);        \
-                ((type*)buffer)[5] = (func)(DryBuffer[i][ChanMap[5]]);        \
-                ((type*)buffer)[6] = (func)(DryBuffer[i][ChanMap[6]]);        \
+                ((type*)buffer)[0] = (func)(DryBuffer[ChanMap[0]][i]);        \
+                ((type*)buffer)[1] = (func)(DryBuffer[ChanMap[1]][i]);        \
+                ((type*)buffer)[2] = (func)(DryBuffer[ChanMap[2]][i]);        \
+                ((type*)buffer)[3] = (func)(DryBuffer[ChanMap[3]][i]);        \
+                ((type*)buffer)[4] = (func)(DryBuffer[ChanMap[4]][i]);        \
+                ((type*)buffer)[5] = (func)(DryBuffer[ChanMap[5]][i]);        \
+                ((type*)buffer)[6] = (func)(DryBuffer[ChanMap[6]][i]);        \
                 buffer = ((type*)buffer) + 7;                                 \
             }                                                                 \
             break;                                                            \
         case AL_FORMAT_71CHN##bits:                                           \
             for(i = 0;i < SamplesToDo;i++)                                    \
             {                                                                 \
-                ((type*)buffer)[0] = (func)(DryBuffer[i][ChanMap[0]]);        \
-                ((type*)buffer)[1] = (func)(DryBuffer[i][ChanMap[1]]);        \
-                ((type*)buffer)[2] = (func)(DryBuffer[i][ChanMap[2]]);        \
-                ((type*)buffer)[3] = (func)(DryBuffer[i][ChanMap[3]]);        \
-                ((type*)buffer)[4] = (func)(DryBuffer[i][ChanMap[4]]);        \
-                ((type*)buffer)[5] = (func)(DryBuffer[i][ChanMap[5]]);        \
-                ((type*)buffer)[6] = (func)(DryBuffer[i][ChanMap[6]]);        \
-                ((type*)buffer)[7] = (func)(DryBuffer[i][ChanMap[7]]);        \
+                ((type*)buffer)[0] = (func)(DryBuffer[ChanMap[0]][i]);        \
+                ((type*)buffer)[1] = (func)(DryBuffer[ChanMap[1]][i]);        \
+                ((type*)buffer)[2] = (func)(DryBuffer[ChanMap[2]][i]);        \
+                ((type*)buffer)[3] = (func)(DryBuffer[ChanMap[3]][i]);        \
+                ((type*)buffer)[4] = (func)(DryBuffer[ChanMap[4]][i]);        \
+                ((type*)buffer)[5] = (func)(DryBuffer[ChanMap[5]][i]);        \
+                ((type*)buffer)[6] = (func)(DryBuffer[ChanMap[6]][i]);        \
+                ((type*)buffer)[7] = (func)(DryBuffer[ChanMap[7]][i]);        \
                 buffer = ((type*)buffer) + 8;                                 \
             }                                                                 \
             break;
@@ -1476,6 +2206,11 @@ ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size)
         size -= SamplesToDo;
     }
 
+    LockDevice(device);
+    device->ParamUpdates = ParamUpdates;
+    device->PlacementUpdates = PlacementUpdates;
+    UnlockDevice(device);
+
 #if defined(HAVE_FESETROUND)
     fesetround(fpuState);
 #elif defined(HAVE__CONTROLFP)
@@ -1487,13 +2222,11 @@ ALvoid aluHandleDisconnect(ALCdevice *device)
 {
     ALuint i;
 
-    SuspendContext(NULL);
+    LockDevice(device);
     for(i = 0;i < device->NumContexts;i++)
     {
         ALsource *source;
 
-        SuspendContext(device->Contexts[i]);
-
         source = device->Contexts[i]->Source;
         while(source)
         {
@@ -1501,14 +2234,14 @@ ALvoid aluHandleDisconnect(ALCdevice *device)
             {
                 source->state = AL_STOPPED;
                 source->BuffersPlayed = source->BuffersInQueue;
+                source->CurrentItem = NULL;
                 source->position = 0;
                 source->position_fraction = 0;
             }
             source = source->next;
         }
-        ProcessContext(device->Contexts[i]);
     }
 
     device->Connected = ALC_FALSE;
-    ProcessContext(NULL);
+    UnlockDevice(device);
 }
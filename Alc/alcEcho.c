@@ -118,7 +118,7 @@ ALvoid EchoUpdate(ALeffectState *effect, ALCcontext *Context, const ALeffect *Ef
     state->iirFilter.coeff = a;
 }
 
-ALvoid EchoProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[OUTPUTCHANNELS])
+ALvoid EchoProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[BUFFERSIZE])
 {
     ALechoState *state = (ALechoState*)effect;
     const ALuint mask = state->BufferLength-1;
@@ -149,12 +149,12 @@ ALvoid EchoProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint Sampl
         samp[0] *= gain;
         samp[1] *= gain;
 
-        SamplesOut[i][FRONT_LEFT]  += samp[0];
-        SamplesOut[i][FRONT_RIGHT] += samp[1];
-        SamplesOut[i][SIDE_LEFT]   += samp[0];
-        SamplesOut[i][SIDE_RIGHT]  += samp[1];
-        SamplesOut[i][BACK_LEFT]   += samp[0];
-        SamplesOut[i][BACK_RIGHT]  += samp[1];
+        SamplesOut[FRONT_LEFT][i]  += samp[0];
+        SamplesOut[FRONT_RIGHT][i] += samp[1];
+        SamplesOut[SIDE_LEFT][i]   += samp[0];
+        SamplesOut[SIDE_RIGHT][i]  += samp[1];
+        SamplesOut[BACK_LEFT][i]   += samp[0];
+        SamplesOut[BACK_RIGHT][i]  += samp[1];
     }
     state->Offset = offset;
 }
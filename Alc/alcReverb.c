@@ -1142,7 +1142,7 @@ static ALvoid EAXVerbUpdate(ALeffectState *effect, ALCcontext *Context, const AL
 
 // This processes the reverb state, given the input samples and an output
 // buffer.
-static ALvoid VerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[OUTPUTCHANNELS])
+static ALvoid VerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[BUFFERSIZE])
 {
     ALverbState *State = (ALverbState*)effect;
     ALuint index;
@@ -1161,20 +1161,20 @@ static ALvoid VerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuin
         out[3] = (early[3] + late[3]) * gain;
 
         // Output the results.
-        SamplesOut[index][FRONT_LEFT]   += out[0];
-        SamplesOut[index][FRONT_RIGHT]  += out[1];
-        SamplesOut[index][FRONT_CENTER] += out[3];
-        SamplesOut[index][SIDE_LEFT]    += out[0];
-        SamplesOut[index][SIDE_RIGHT]   += out[1];
-        SamplesOut[index][BACK_LEFT]    += out[0];
-        SamplesOut[index][BACK_RIGHT]   += out[1];
-        SamplesOut[index][BACK_CENTER]  += out[2];
+        SamplesOut[FRONT_LEFT][index]   += out[0];
+        SamplesOut[FRONT_RIGHT][index]  += out[1];
+        SamplesOut[FRONT_CENTER][index] += out[3];
+        SamplesOut[SIDE_LEFT][index]    += out[0];
+        SamplesOut[SIDE_RIGHT][index]   += out[1];
+        SamplesOut[BACK_LEFT][index]    += out[0];
+        SamplesOut[BACK_RIGHT][index]   += out[1];
+        SamplesOut[BACK_CENTER][index]  += out[2];
     }
 }
 
 // This processes the EAX reverb state, given the input samples and an output
 // buffer.
-static ALvoid EAXVerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[OUTPUTCHANNELS])
+static ALvoid EAXVerbProcess(ALeffectState *effect, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[BUFFERSIZE])
 {
     ALverbState *State = (ALverbState*)effect;
     ALuint index;
@@ -1189,28 +1189,28 @@ static ALvoid EAXVerbProcess(ALeffectState *effect, const ALeffectslot *Slot, AL
         // Unfortunately, while the number and configuration of gains for
         // panning adjust according to OUTPUTCHANNELS, the output from the
         // reverb engine is not so scalable.
-        SamplesOut[index][FRONT_LEFT] +=
+        SamplesOut[FRONT_LEFT][index] +=
            (State->Early.PanGain[FRONT_LEFT]*early[0] +
             State->Late.PanGain[FRONT_LEFT]*late[0]) * gain;
-        SamplesOut[index][FRONT_RIGHT] +=
+        SamplesOut[FRONT_RIGHT][index] +=
            (State->Early.PanGain[FRONT_RIGHT]*early[1] +
             State->Late.PanGain[FRONT_RIGHT]*late[1]) * gain;
-        SamplesOut[index][FRONT_CENTER] +=
+        SamplesOut[FRONT_CENTER][index] +=
            (State->Early.PanGain[FRONT_CENTER]*early[3] +
             State->Late.PanGain[FRONT_CENTER]*late[3]) * gain;
-        SamplesOut[index][SIDE_LEFT] +=
+        SamplesOut[SIDE_LEFT][index] +=
            (State->Early.PanGain[SIDE_LEFT]*early[0] +
             State->Late.PanGain[SIDE_LEFT]*late[0]) * gain;
-        SamplesOut[index][SIDE_RIGHT] +=
+        SamplesOut[SIDE_RIGHT][index] +=
            (State->Early.PanGain[SIDE_RIGHT]*early[1] +
             State->Late.PanGain[SIDE_RIGHT]*late[1]) * gain;
-        SamplesOut[index][BACK_LEFT] +=
+        SamplesOut[BACK_LEFT][index] +=
            (State->Early.PanGain[BACK_LEFT]*early[0] +
             State->Late.PanGain[BACK_LEFT]*late[0]) * gain;
-        SamplesOut[index][BACK_RIGHT] +=
+        SamplesOut[BACK_RIGHT][index] +=
            (State->Early.PanGain[BACK_RIGHT]*early[1] +
             State->Late.PanGain[BACK_RIGHT]*late[1]) * gain;
-        SamplesOut[index][BACK_CENTER] +=
+        SamplesOut[BACK_CENTER][index] +=
            (State->Early.PanGain[BACK_CENTER]*early[2] +
             State->Late.PanGain[BACK_CENTER]*late[2]) * gain;
     }
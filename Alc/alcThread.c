@@ -78,6 +78,27 @@ ALuint StopThread(ALvoid *thread)
     return (ALuint)ret;
 }
 
+
+ALvoid *CreateSem(void)
+{
+    return CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+}
+
+ALvoid DestroySem(ALvoid *sem)
+{
+    CloseHandle((HANDLE)sem);
+}
+
+ALvoid PostSem(ALvoid *sem)
+{
+    ReleaseSemaphore((HANDLE)sem, 1, NULL);
+}
+
+ALvoid WaitSem(ALvoid *sem)
+{
+    WaitForSingleObject((HANDLE)sem, INFINITE);
+}
+
 #else
 
 #include <pthread.h>
@@ -125,4 +146,62 @@ ALuint StopThread(ALvoid *thread)
     return ret;
 }
 
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    ALuint count;
+} SemInfo;
+
+ALvoid *CreateSem(void)
+{
+    SemInfo *inf = malloc(sizeof(SemInfo));
+    if(!inf) return NULL;
+
+    if(pthread_mutex_init(&inf->mutex, NULL) != 0)
+    {
+        free(inf);
+        return NULL;
+    }
+    if(pthread_cond_init(&inf->cond, NULL) != 0)
+    {
+        pthread_mutex_destroy(&inf->mutex);
+        free(inf);
+        return NULL;
+    }
+    inf->count = 0;
+
+    return inf;
+}
+
+ALvoid DestroySem(ALvoid *sem)
+{
+    SemInfo *inf = sem;
+
+    pthread_cond_destroy(&inf->cond);
+    pthread_mutex_destroy(&inf->mutex);
+    free(inf);
+}
+
+ALvoid PostSem(ALvoid *sem)
+{
+    SemInfo *inf = sem;
+
+    pthread_mutex_lock(&inf->mutex);
+    inf->count++;
+    pthread_cond_signal(&inf->cond);
+    pthread_mutex_unlock(&inf->mutex);
+}
+
+ALvoid WaitSem(ALvoid *sem)
+{
+    SemInfo *inf = sem;
+
+    pthread_mutex_lock(&inf->mutex);
+    while(inf->count == 0)
+        pthread_cond_wait(&inf->cond, &inf->mutex);
+    inf->count--;
+    pthread_mutex_unlock(&inf->mutex);
+}
+
 #endif
@@ -0,0 +1,266 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <math.h>
+
+#include "alMain.h"
+#include "alu.h"
+#include "mixer_defs.h"
+
+
+/* Filled in by InitResamplerTables */
+ALuint SincTaps = DEFAULT_SINC_TAPS;
+ALfloat SincTable[SINC_BANDS][SINC_PHASES][2][MAX_SINC_TAPS];
+
+/* Cosine interpolation weights for each position fraction */
+static ALfloat CosLerpTable[1<<FRACTIONBITS];
+
+static double Sinc(double x)
+{
+    if(fabs(x) < 1e-9)
+        return 1.0;
+    return sin(M_PI*x) / (M_PI*x);
+}
+
+/* Calculates the Blackman-windowed sinc coefficients for a sample position
+ * 'frac' (0 to 1) past the tap at index taps/2-1, normalized for unity gain.
+ * The cutoff is a fraction of the source's Nyquist frequency, and the window
+ * stays the same width. */
+static void CalcSincCoeffs(ALuint taps, double cutoff, double frac, double *coeffs)
+{
+    const double width = taps/2;
+    double sum = 0.0;
+    ALuint k;
+
+    for(k = 0;k < taps;k++)
+    {
+        double x = (double)k - (width-1.0) - frac;
+        double w = 0.0;
+        if(fabs(x) < width)
+            w = 0.42 + 0.5*cos(M_PI*x/width) + 0.08*cos(2.0*M_PI*x/width);
+        coeffs[k] = Sinc(cutoff*x) * w;
+        sum += coeffs[k];
+    }
+    for(k = 0;k < taps;k++)
+        coeffs[k] /= sum;
+}
+
+void InitResamplerTables(ALuint taps)
+{
+    double cur[MAX_SINC_TAPS], next[MAX_SINC_TAPS];
+    double cutoff;
+    ALuint b, p, k;
+
+    for(p = 0;p < (1<<FRACTIONBITS);p++)
+        CosLerpTable[p] = (1.0f-cos(p * (1.0f/(1<<FRACTIONBITS)) * M_PI)) * 0.5f;
+
+    SincTaps = taps;
+
+    /* Each phase holds its coefficients and the difference to the next
+     * phase's, for interpolating with the remaining fraction bits */
+    for(b = 0;b < SINC_BANDS;b++)
+    {
+        cutoff = 1.0 - (double)b/SINC_BANDS;
+        CalcSincCoeffs(taps, cutoff, 0.0, next);
+        for(p = 0;p < SINC_PHASES;p++)
+        {
+            memcpy(cur, next, sizeof(cur));
+            CalcSincCoeffs(taps, cutoff, (double)(p+1)/SINC_PHASES, next);
+            for(k = 0;k < MAX_SINC_TAPS;k++)
+            {
+                SincTable[b][p][0][k] = (k < SincTaps) ? (ALfloat)cur[k] : 0.0f;
+                SincTable[b][p][1][k] = (k < SincTaps) ? (ALfloat)(next[k]-cur[k]) : 0.0f;
+            }
+        }
+    }
+}
+
+
+static __inline ALfloat point(ALfloat val1, ALfloat val2, ALint frac)
+{
+    return val1;
+    (void)val2;
+    (void)frac;
+}
+static __inline ALfloat lerp(ALfloat val1, ALfloat val2, ALint frac)
+{
+    return val1 + ((val2-val1)*(frac * (1.0f/(1<<FRACTIONBITS))));
+}
+static __inline ALfloat cos_lerp(ALfloat val1, ALfloat val2, ALint frac)
+{
+    return val1 + ((val2-val1)*CosLerpTable[frac]);
+}
+
+#define DECL_TEMPLATE(sampler)                                                \
+void Resample_##sampler##_C(const ALfloat *data, ALuint step, ALuint frac,    \
+                            ALint increment, ALfloat *OutBuffer,              \
+                            ALuint BufferSize)                                \
+{                                                                             \
+    ALuint pos = 0;                                                           \
+    ALuint i;                                                                 \
+                                                                              \
+    for(i = 0;i < BufferSize;i++)                                             \
+    {                                                                         \
+        OutBuffer[i] = sampler(data[pos*step], data[(pos+1)*step], frac);     \
+                                                                              \
+        frac += increment;                                                    \
+        pos  += frac>>FRACTIONBITS;                                           \
+        frac &= FRACTIONMASK;                                                 \
+    }                                                                         \
+}
+
+DECL_TEMPLATE(point)
+DECL_TEMPLATE(lerp)
+DECL_TEMPLATE(cos_lerp)
+
+#undef DECL_TEMPLATE
+
+void MixRow_C(ALfloat *OutBuffer, const ALfloat *data, ALfloat Gain,
+              ALfloat GainStep, ALfloat scaler, ALuint BufferSize)
+{
+    ALuint j;
+
+    for(j = 0;j < BufferSize;j++)
+    {
+        Gain += GainStep;
+        OutBuffer[j] += data[j]*Gain*scaler;
+    }
+}
+
+void LoadSamples_ubyte_C(ALfloat *dst, const ALvoid *src, ALuint count)
+{
+    const ALubyte *data = src;
+    ALuint i;
+    ALint smp;
+
+    for(i = 0;i < count;i++)
+    {
+        smp = data[i];
+        dst[i] = ((smp < 0x80) ? ((smp-128)/128.0f) : ((smp-128)/127.0f));
+    }
+}
+
+void LoadSamples_short_C(ALfloat *dst, const ALvoid *src, ALuint count)
+{
+    const ALshort *data = src;
+    ALuint i;
+    ALint smp;
+
+    for(i = 0;i < count;i++)
+    {
+        smp = data[i];
+        dst[i] = ((smp < 0) ? (smp/32768.0f) : (smp/32767.0f));
+    }
+}
+
+void LoadSamples_float_C(ALfloat *dst, const ALvoid *src, ALuint count)
+{
+    memcpy(dst, src, count*sizeof(ALfloat));
+}
+
+void Resample_sinc_C(const ALfloat *data, ALuint step, ALuint frac,
+                     ALint increment, ALfloat *OutBuffer, ALuint BufferSize)
+{
+    const ALuint taps = SincTaps;
+    ALfloat (*table)[2][MAX_SINC_TAPS] = SincTable[SincBand(increment)];
+    ALuint pos = 0;
+    ALuint i, k;
+
+    data -= (taps/2 - 1)*step;
+    for(i = 0;i < BufferSize;i++)
+    {
+        const ALfloat *coeffs = table[frac>>SINC_FRAC_BITS][0];
+        const ALfloat *deltas = table[frac>>SINC_FRAC_BITS][1];
+        const ALfloat mu = (frac&SINC_FRAC_MASK) * (1.0f/(1<<SINC_FRAC_BITS));
+        const ALfloat *src = &data[pos*step];
+        ALfloat r = 0.0f;
+
+        for(k = 0;k < taps;k++)
+            r += (coeffs[k] + mu*deltas[k]) * src[k*step];
+        OutBuffer[i] = r;
+
+        frac += increment;
+        pos  += frac>>FRACTIONBITS;
+        frac &= FRACTIONMASK;
+    }
+}
+
+void CalcPlacements_C(PlacementBatch *batch, ALuint count,
+                      ALfloat matrix[4][4], const ALfloat *listenerVel)
+{
+    ALuint i;
+
+    for(i = 0;i < count;i++)
+    {
+        ALfloat px = batch->PosX[i], py = batch->PosY[i], pz = batch->PosZ[i];
+        ALfloat vx = batch->VelX[i], vy = batch->VelY[i], vz = batch->VelZ[i];
+        ALfloat dx = batch->DirX[i], dy = batch->DirY[i], dz = batch->DirZ[i];
+        ALfloat x, y, z, sx, sy, sz, len, dist;
+
+        /* Transform into listener space, same as aluMatrixVector */
+        x  = px*matrix[0][0] + py*matrix[1][0] + pz*matrix[2][0] + 1.0f*matrix[3][0];
+        y  = px*matrix[0][1] + py*matrix[1][1] + pz*matrix[2][1] + 1.0f*matrix[3][1];
+        z  = px*matrix[0][2] + py*matrix[1][2] + pz*matrix[2][2] + 1.0f*matrix[3][2];
+        sx = dx*matrix[0][0] + dy*matrix[1][0] + dz*matrix[2][0] + 0.0f*matrix[3][0];
+        sy = dx*matrix[0][1] + dy*matrix[1][1] + dz*matrix[2][1] + 0.0f*matrix[3][1];
+        sz = dx*matrix[0][2] + dy*matrix[1][2] + dz*matrix[2][2] + 0.0f*matrix[3][2];
+        dx = sx; dy = sy; dz = sz;
+        sx = vx*matrix[0][0] + vy*matrix[1][0] + vz*matrix[2][0] + 0.0f*matrix[3][0];
+        sy = vx*matrix[0][1] + vy*matrix[1][1] + vz*matrix[2][1] + 0.0f*matrix[3][1];
+        sz = vx*matrix[0][2] + vy*matrix[1][2] + vz*matrix[2][2] + 0.0f*matrix[3][2];
+        vx = sx; vy = sy; vz = sz;
+
+        /* Normalized source-to-listener vector and direction */
+        sx = -x; sy = -y; sz = -z;
+        len = aluSqrt(sx*sx + sy*sy + sz*sz);
+        if(len != 0.0f)
+        {
+            len = 1.0f/len;
+            sx *= len; sy *= len; sz *= len;
+        }
+        len = aluSqrt(dx*dx + dy*dy + dz*dz);
+        if(len != 0.0f)
+        {
+            len = 1.0f/len;
+            dx *= len; dy *= len; dz *= len;
+        }
+
+        dist = aluSqrt(x*x + y*y + z*z);
+        batch->Distance[i] = dist;
+        batch->ConeCos[i] = dx*sx + dy*sy + dz*sz;
+        batch->RearCos[i] = sz;
+        batch->SourceSpeed[i] = vx*sx + vy*sy + vz*sz;
+        batch->ListenerSpeed[i] = listenerVel[0]*sx + listenerVel[1]*sy +
+                                  listenerVel[2]*sz;
+
+        len = max(dist, batch->RefDistance[i]);
+        if(len > 0.0f)
+        {
+            len = 1.0f/len;
+            x *= len; z *= len;
+        }
+        batch->PanX[i] = x;
+        batch->PanZ[i] = z;
+        batch->DirGain[i] = aluSqrt(x*x + z*z);
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef MIXER_DEFS_H
+#define MIXER_DEFS_H
+
+#include "AL/al.h"
+#include "alu.h"
+
+#define FRACTIONBITS 14
+#define FRACTIONMASK ((1L<<FRACTIONBITS)-1)
+
+/* Resamples a block of samples from one channel of a buffer. The channel's
+ * samples are 'step' values apart, and the data must have one extra sample
+ * available past the end of the block (more for the sinc resampler, see
+ * below). */
+typedef void (*ResamplerFunc)(const ALfloat *data, ALuint step, ALuint frac,
+                              ALint increment, ALfloat *OutBuffer, ALuint BufferSize);
+
+void Resample_point_C(const ALfloat *data, ALuint step, ALuint frac,
+                      ALint increment, ALfloat *OutBuffer, ALuint BufferSize);
+void Resample_lerp_C(const ALfloat *data, ALuint step, ALuint frac,
+                     ALint increment, ALfloat *OutBuffer, ALuint BufferSize);
+void Resample_cos_lerp_C(const ALfloat *data, ALuint step, ALuint frac,
+                         ALint increment, ALfloat *OutBuffer, ALuint BufferSize);
+
+/* Fills in the tables used by the cosine and sinc resamplers. The tap count
+ * must be a multiple of 4, no more than MAX_SINC_TAPS. */
+void InitResamplerTables(ALuint taps);
+
+/* Converts a run of buffer samples to float for the resamplers. Buffers keep
+ * their samples in the type they were loaded as, and there's a loader for
+ * each type. The count is in samples, not frames. 8- and 16-bit samples are
+ * scaled to [-1, 1] separately for the negative and positive halves, so the
+ * extremes of both are exact. */
+typedef void (*LoadSamplesProc)(ALfloat *dst, const ALvoid *src, ALuint count);
+
+void LoadSamples_ubyte_C(ALfloat *dst, const ALvoid *src, ALuint count);
+void LoadSamples_short_C(ALfloat *dst, const ALvoid *src, ALuint count);
+void LoadSamples_float_C(ALfloat *dst, const ALvoid *src, ALuint count);
+
+/* SSE2 loaders, giving the same results as the C ones */
+void LoadSamples_ubyte_SSE2(ALfloat *dst, const ALvoid *src, ALuint count);
+void LoadSamples_short_SSE2(ALfloat *dst, const ALvoid *src, ALuint count);
+
+/* The sinc resampler reads SincTaps/2-1 samples before and SincTaps/2 samples
+ * after the current position. Its coefficients are stored for SINC_PHASES
+ * positions between two samples, along with the deltas to the next phase,
+ * and the remaining SINC_FRAC_BITS of the position's fraction interpolate
+ * between them. The SIMD versions sum the taps in a different order, so they
+ * may differ from the C version in the last bits.
+ *
+ * When it steps through the source faster than one sample at a time, the
+ * cutoff has to come down with the output's Nyquist frequency to avoid
+ * aliasing. There's a set of coefficients for each of SINC_BANDS cutoffs,
+ * band b cutting off at 1-b/SINC_BANDS of the source's Nyquist frequency, and
+ * SincBand picks the highest one that's low enough for the step. Steps of
+ * more than SINC_BANDS samples use the lowest cutoff. */
+#define MAX_SINC_TAPS      32
+#define DEFAULT_SINC_TAPS  16
+#define SINC_PHASE_BITS    8
+#define SINC_PHASES        (1<<SINC_PHASE_BITS)
+#define SINC_FRAC_BITS     (FRACTIONBITS-SINC_PHASE_BITS)
+#define SINC_FRAC_MASK     ((1<<SINC_FRAC_BITS)-1)
+#define SINC_BANDS         8
+
+extern ALuint SincTaps;
+extern ALfloat SincTable[SINC_BANDS][SINC_PHASES][2][MAX_SINC_TAPS];
+
+static __inline ALuint SincBand(ALint increment)
+{
+    ALuint band;
+
+    if(increment <= (1<<FRACTIONBITS))
+        return 0;
+    /* The cutoff 1-b/SINC_BANDS must be no more than 1/step */
+    band = SINC_BANDS - (SINC_BANDS<<FRACTIONBITS)/(ALuint)increment;
+    return ((band < SINC_BANDS) ? band : SINC_BANDS-1);
+}
+
+void Resample_sinc_C(const ALfloat *data, ALuint step, ALuint frac,
+                     ALint increment, ALfloat *OutBuffer, ALuint BufferSize);
+void Resample_sinc_SSE(const ALfloat *data, ALuint step, ALuint frac,
+                       ALint increment, ALfloat *OutBuffer, ALuint BufferSize);
+void Resample_sinc_Neon(const ALfloat *data, ALuint step, ALuint frac,
+                        ALint increment, ALfloat *OutBuffer, ALuint BufferSize);
+
+/* Kernel used by the mixer to accumulate a block of filtered source samples
+ * into one planar output row, which is either a channel of the device's dry
+ * buffer or an effect slot's wet buffer. The gain is stepped before every
+ * sample, and each sample is additionally multiplied by scaler (a channel
+ * matrix entry or a send attenuation). There's a plain C version, along with
+ * optional versions using CPU extensions that are selected at run-time
+ * according to CPUCapFlags. All versions must produce the same results as the
+ * C version. */
+typedef void (*MixRowProc)(ALfloat *OutBuffer, const ALfloat *data,
+                           ALfloat Gain, ALfloat GainStep, ALfloat scaler,
+                           ALuint BufferSize);
+
+/* C mixer */
+void MixRow_C(ALfloat *OutBuffer, const ALfloat *data, ALfloat Gain,
+              ALfloat GainStep, ALfloat scaler, ALuint BufferSize);
+
+/* SSE mixer */
+void MixRow_SSE(ALfloat *OutBuffer, const ALfloat *data, ALfloat Gain,
+                ALfloat GainStep, ALfloat scaler, ALuint BufferSize);
+
+/* Neon mixer */
+void MixRow_Neon(ALfloat *OutBuffer, const ALfloat *data, ALfloat Gain,
+                 ALfloat GainStep, ALfloat scaler, ALuint BufferSize);
+
+/* Calculates where a batch of sources is relative to the listener. The
+ * sources' positions, velocities and directions are given in world space,
+ * one array per component, and are transformed by the listener's matrix (see
+ * aluUpdateListener). The outputs are the distance, the cosines used for the
+ * cone and rear angles, the speeds towards the listener, and the normalized
+ * horizontal position and gain used for panning. Every version must produce
+ * the same results as CalcSourcePlacement in ALu.c, so the SIMD version
+ * keeps its order of operations. There's no Neon version, since ARMv7 Neon
+ * only has estimates for division and square roots. The batch size is a
+ * multiple of 4, and unused lanes are calculated but ignored. */
+#define PLACEMENT_BATCH  64
+
+typedef struct PlacementBatch {
+    ALfloat PosX[PLACEMENT_BATCH], PosY[PLACEMENT_BATCH], PosZ[PLACEMENT_BATCH];
+    ALfloat VelX[PLACEMENT_BATCH], VelY[PLACEMENT_BATCH], VelZ[PLACEMENT_BATCH];
+    ALfloat DirX[PLACEMENT_BATCH], DirY[PLACEMENT_BATCH], DirZ[PLACEMENT_BATCH];
+    ALfloat RefDistance[PLACEMENT_BATCH];
+
+    ALfloat Distance[PLACEMENT_BATCH];
+    ALfloat ConeCos[PLACEMENT_BATCH];
+    ALfloat RearCos[PLACEMENT_BATCH];
+    ALfloat SourceSpeed[PLACEMENT_BATCH];
+    ALfloat ListenerSpeed[PLACEMENT_BATCH];
+    ALfloat PanX[PLACEMENT_BATCH], PanZ[PLACEMENT_BATCH];
+    ALfloat DirGain[PLACEMENT_BATCH];
+} PlacementBatch;
+
+typedef void (*PlacementProc)(PlacementBatch *batch, ALuint count,
+                              ALfloat matrix[4][4], const ALfloat *listenerVel);
+
+void CalcPlacements_C(PlacementBatch *batch, ALuint count,
+                      ALfloat matrix[4][4], const ALfloat *listenerVel);
+void CalcPlacements_SSE(PlacementBatch *batch, ALuint count,
+                        ALfloat matrix[4][4], const ALfloat *listenerVel);
+
+#endif /* MIXER_DEFS_H */
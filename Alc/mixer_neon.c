@@ -0,0 +1,102 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <arm_neon.h>
+
+#include "alMain.h"
+#include "alu.h"
+#include "mixer_defs.h"
+
+
+void MixRow_Neon(ALfloat *OutBuffer, const ALfloat *data, ALfloat Gain,
+                 ALfloat GainStep, ALfloat scaler, ALuint BufferSize)
+{
+    float32x4_t gain, scale;
+    ALuint j = 0;
+
+    /* Same as the SSE mixer. Separate multiplies and adds are used instead of
+     * vmla, so the rounding matches the C mixer (aside from Neon's flushing
+     * of denormals). */
+    if(GainStep != 0.0f)
+    {
+        for(;j < BufferSize;j++)
+        {
+            Gain += GainStep;
+            OutBuffer[j] += data[j]*Gain*scaler;
+        }
+        return;
+    }
+
+    gain = vdupq_n_f32(Gain);
+    scale = vdupq_n_f32(scaler);
+    for(;BufferSize-j > 3;j += 4)
+    {
+        float32x4_t val = vmulq_f32(vmulq_f32(vld1q_f32(&data[j]), gain), scale);
+        vst1q_f32(&OutBuffer[j], vaddq_f32(vld1q_f32(&OutBuffer[j]), val));
+    }
+    for(;j < BufferSize;j++)
+        OutBuffer[j] += data[j]*Gain*scaler;
+}
+
+void Resample_sinc_Neon(const ALfloat *data, ALuint step, ALuint frac,
+                        ALint increment, ALfloat *OutBuffer, ALuint BufferSize)
+{
+    const ALuint taps = SincTaps;
+    ALfloat (*table)[2][MAX_SINC_TAPS] = SincTable[SincBand(increment)];
+    ALuint pos = 0;
+    ALuint i, k;
+
+    data -= (taps/2 - 1)*step;
+    for(i = 0;i < BufferSize;i++)
+    {
+        const ALfloat *coeffs = table[frac>>SINC_FRAC_BITS][0];
+        const ALfloat *deltas = table[frac>>SINC_FRAC_BITS][1];
+        const float32x4_t mu = vdupq_n_f32((frac&SINC_FRAC_MASK) * (1.0f/(1<<SINC_FRAC_BITS)));
+        const ALfloat *src = &data[pos*step];
+        float32x4_t r4 = vdupq_n_f32(0.0f);
+        float32x2_t r2;
+
+        for(k = 0;k < taps;k += 4)
+        {
+            const float32x4_t c = vmlaq_f32(vld1q_f32(&coeffs[k]), mu,
+                                            vld1q_f32(&deltas[k]));
+            float32x4_t s;
+            if(step == 1)
+                s = vld1q_f32(&src[k]);
+            else
+            {
+                s = vdupq_n_f32(src[k*step]);
+                s = vsetq_lane_f32(src[(k+1)*step], s, 1);
+                s = vsetq_lane_f32(src[(k+2)*step], s, 2);
+                s = vsetq_lane_f32(src[(k+3)*step], s, 3);
+            }
+            r4 = vmlaq_f32(r4, c, s);
+        }
+        r2 = vadd_f32(vget_low_f32(r4), vget_high_f32(r4));
+        r2 = vpadd_f32(r2, r2);
+        OutBuffer[i] = vget_lane_f32(r2, 0);
+
+        frac += increment;
+        pos  += frac>>FRACTIONBITS;
+        frac &= FRACTIONMASK;
+    }
+}
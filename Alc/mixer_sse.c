@@ -0,0 +1,201 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <xmmintrin.h>
+
+#include "alMain.h"
+#include "alu.h"
+#include "mixer_defs.h"
+
+
+void MixRow_SSE(ALfloat *OutBuffer, const ALfloat *data, ALfloat Gain,
+                ALfloat GainStep, ALfloat scaler, ALuint BufferSize)
+{
+    __m128 gain, scale;
+    ALuint j = 0;
+
+    /* A ramping gain has to be stepped one sample at a time to match the C
+     * mixer. Once it's steady, four samples can be done at once. The multiply
+     * order is kept the same as the C mixer, so the results are identical. */
+    if(GainStep != 0.0f)
+    {
+        for(;j < BufferSize;j++)
+        {
+            Gain += GainStep;
+            OutBuffer[j] += data[j]*Gain*scaler;
+        }
+        return;
+    }
+
+    gain = _mm_set1_ps(Gain);
+    scale = _mm_set1_ps(scaler);
+    for(;BufferSize-j > 3;j += 4)
+    {
+        __m128 val = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&data[j]), gain), scale);
+        _mm_storeu_ps(&OutBuffer[j], _mm_add_ps(_mm_loadu_ps(&OutBuffer[j]), val));
+    }
+    for(;j < BufferSize;j++)
+        OutBuffer[j] += data[j]*Gain*scaler;
+}
+
+void Resample_sinc_SSE(const ALfloat *data, ALuint step, ALuint frac,
+                       ALint increment, ALfloat *OutBuffer, ALuint BufferSize)
+{
+    const ALuint taps = SincTaps;
+    ALfloat (*table)[2][MAX_SINC_TAPS] = SincTable[SincBand(increment)];
+    ALuint pos = 0;
+    ALuint i, k;
+
+    /* The tap count is always a multiple of 4. Interleaved channels have to
+     * be gathered into a vector, but mono data can be loaded directly. */
+    data -= (taps/2 - 1)*step;
+    for(i = 0;i < BufferSize;i++)
+    {
+        const ALfloat *coeffs = table[frac>>SINC_FRAC_BITS][0];
+        const ALfloat *deltas = table[frac>>SINC_FRAC_BITS][1];
+        const __m128 mu = _mm_set1_ps((frac&SINC_FRAC_MASK) * (1.0f/(1<<SINC_FRAC_BITS)));
+        const ALfloat *src = &data[pos*step];
+        __m128 r4 = _mm_setzero_ps();
+
+        for(k = 0;k < taps;k += 4)
+        {
+            const __m128 c = _mm_add_ps(_mm_loadu_ps(&coeffs[k]),
+                                        _mm_mul_ps(mu, _mm_loadu_ps(&deltas[k])));
+            __m128 s;
+            if(step == 1)
+                s = _mm_loadu_ps(&src[k]);
+            else
+                s = _mm_setr_ps(src[k*step], src[(k+1)*step],
+                                src[(k+2)*step], src[(k+3)*step]);
+            r4 = _mm_add_ps(r4, _mm_mul_ps(c, s));
+        }
+        r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+        r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+        OutBuffer[i] = _mm_cvtss_f32(r4);
+
+        frac += increment;
+        pos  += frac>>FRACTIONBITS;
+        frac &= FRACTIONMASK;
+    }
+}
+
+/* Multiplies the lanes by the inverse of len where len != 0 (or > 0, as given
+ * by mask), leaving the other lanes as they are. */
+#define SCALE_MASKED(v, inv, mask)                                            \
+    _mm_or_ps(_mm_and_ps((mask), _mm_mul_ps((v), (inv))),                     \
+              _mm_andnot_ps((mask), (v)))
+
+void CalcPlacements_SSE(PlacementBatch *batch, ALuint count,
+                        ALfloat matrix[4][4], const ALfloat *listenerVel)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signbit = _mm_set1_ps(-0.0f);
+    __m128 m[4][3], lv[3];
+    ALuint i, r, c;
+
+    for(r = 0;r < 4;r++)
+    {
+        for(c = 0;c < 3;c++)
+            m[r][c] = _mm_set1_ps(matrix[r][c]);
+    }
+    for(c = 0;c < 3;c++)
+        lv[c] = _mm_set1_ps(listenerVel[c]);
+
+    /* Same as CalcPlacements_C, four sources at a time */
+    for(i = 0;i < count;i += 4)
+    {
+        __m128 p[3], v[3], d[3], s[3], t[3];
+        __m128 len, inv, mask, dist;
+
+        t[0] = _mm_loadu_ps(&batch->PosX[i]);
+        t[1] = _mm_loadu_ps(&batch->PosY[i]);
+        t[2] = _mm_loadu_ps(&batch->PosZ[i]);
+        for(c = 0;c < 3;c++)
+            p[c] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(t[0], m[0][c]),
+                                                    _mm_mul_ps(t[1], m[1][c])),
+                                         _mm_mul_ps(t[2], m[2][c])),
+                              _mm_mul_ps(one, m[3][c]));
+        t[0] = _mm_loadu_ps(&batch->DirX[i]);
+        t[1] = _mm_loadu_ps(&batch->DirY[i]);
+        t[2] = _mm_loadu_ps(&batch->DirZ[i]);
+        for(c = 0;c < 3;c++)
+            d[c] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(t[0], m[0][c]),
+                                                    _mm_mul_ps(t[1], m[1][c])),
+                                         _mm_mul_ps(t[2], m[2][c])),
+                              _mm_mul_ps(zero, m[3][c]));
+        t[0] = _mm_loadu_ps(&batch->VelX[i]);
+        t[1] = _mm_loadu_ps(&batch->VelY[i]);
+        t[2] = _mm_loadu_ps(&batch->VelZ[i]);
+        for(c = 0;c < 3;c++)
+            v[c] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(t[0], m[0][c]),
+                                                    _mm_mul_ps(t[1], m[1][c])),
+                                         _mm_mul_ps(t[2], m[2][c])),
+                              _mm_mul_ps(zero, m[3][c]));
+
+        for(c = 0;c < 3;c++)
+            s[c] = _mm_xor_ps(p[c], signbit);
+        len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s[0], s[0]),
+                                                _mm_mul_ps(s[1], s[1])),
+                                     _mm_mul_ps(s[2], s[2])));
+        inv = _mm_div_ps(one, len);
+        mask = _mm_cmpneq_ps(len, zero);
+        for(c = 0;c < 3;c++)
+            s[c] = SCALE_MASKED(s[c], inv, mask);
+        len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], d[0]),
+                                                _mm_mul_ps(d[1], d[1])),
+                                     _mm_mul_ps(d[2], d[2])));
+        inv = _mm_div_ps(one, len);
+        mask = _mm_cmpneq_ps(len, zero);
+        for(c = 0;c < 3;c++)
+            d[c] = SCALE_MASKED(d[c], inv, mask);
+
+        dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], p[0]),
+                                                 _mm_mul_ps(p[1], p[1])),
+                                      _mm_mul_ps(p[2], p[2])));
+        _mm_storeu_ps(&batch->Distance[i], dist);
+        _mm_storeu_ps(&batch->ConeCos[i],
+                      _mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], s[0]),
+                                            _mm_mul_ps(d[1], s[1])),
+                                 _mm_mul_ps(d[2], s[2])));
+        _mm_storeu_ps(&batch->RearCos[i], s[2]);
+        _mm_storeu_ps(&batch->SourceSpeed[i],
+                      _mm_add_ps(_mm_add_ps(_mm_mul_ps(v[0], s[0]),
+                                            _mm_mul_ps(v[1], s[1])),
+                                 _mm_mul_ps(v[2], s[2])));
+        _mm_storeu_ps(&batch->ListenerSpeed[i],
+                      _mm_add_ps(_mm_add_ps(_mm_mul_ps(lv[0], s[0]),
+                                            _mm_mul_ps(lv[1], s[1])),
+                                 _mm_mul_ps(lv[2], s[2])));
+
+        len = _mm_max_ps(dist, _mm_loadu_ps(&batch->RefDistance[i]));
+        inv = _mm_div_ps(one, len);
+        mask = _mm_cmpgt_ps(len, zero);
+        p[0] = SCALE_MASKED(p[0], inv, mask);
+        p[2] = SCALE_MASKED(p[2], inv, mask);
+        _mm_storeu_ps(&batch->PanX[i], p[0]);
+        _mm_storeu_ps(&batch->PanZ[i], p[2]);
+        _mm_storeu_ps(&batch->DirGain[i],
+                      _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(p[0], p[0]),
+                                             _mm_mul_ps(p[2], p[2]))));
+    }
+}
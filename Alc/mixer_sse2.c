@@ -0,0 +1,98 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+
+#include "config.h"
+
+#include <emmintrin.h>
+
+#include "alMain.h"
+#include "alu.h"
+#include "mixer_defs.h"
+
+
+/* Divides each sample by 32768 or 32767 (or 128 or 127 for 8-bit), depending
+ * on its sign. The samples convert to float exactly and the division is
+ * rounded the same as a single one, so the results match the C loaders. */
+static __inline __m128 ScaleSamples(__m128 smps, __m128 negscale, __m128 posscale)
+{
+    __m128 neg = _mm_cmplt_ps(smps, _mm_setzero_ps());
+    __m128 scale = _mm_or_ps(_mm_and_ps(neg, negscale),
+                             _mm_andnot_ps(neg, posscale));
+    return _mm_div_ps(smps, scale);
+}
+
+void LoadSamples_ubyte_SSE2(ALfloat *dst, const ALvoid *src, ALuint count)
+{
+    const ALubyte *data = src;
+    const __m128 negscale = _mm_set1_ps(128.0f);
+    const __m128 posscale = _mm_set1_ps(127.0f);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    ALuint i = 0;
+    ALint smp;
+
+    for(;count-i > 15;i += 16)
+    {
+        __m128i smps = _mm_loadu_si128((const __m128i*)&data[i]);
+        __m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(smps, zero), bias);
+        __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(smps, zero), bias);
+
+        /* Sign-extend the biased 16-bit values by putting them in the top
+         * half of each 32-bit lane and shifting back down */
+        _mm_storeu_ps(&dst[i   ], ScaleSamples(_mm_cvtepi32_ps(_mm_srai_epi32(
+            _mm_unpacklo_epi16(lo, lo), 16)), negscale, posscale));
+        _mm_storeu_ps(&dst[i+ 4], ScaleSamples(_mm_cvtepi32_ps(_mm_srai_epi32(
+            _mm_unpackhi_epi16(lo, lo), 16)), negscale, posscale));
+        _mm_storeu_ps(&dst[i+ 8], ScaleSamples(_mm_cvtepi32_ps(_mm_srai_epi32(
+            _mm_unpacklo_epi16(hi, hi), 16)), negscale, posscale));
+        _mm_storeu_ps(&dst[i+12], ScaleSamples(_mm_cvtepi32_ps(_mm_srai_epi32(
+            _mm_unpackhi_epi16(hi, hi), 16)), negscale, posscale));
+    }
+    for(;i < count;i++)
+    {
+        smp = data[i];
+        dst[i] = ((smp < 0x80) ? ((smp-128)/128.0f) : ((smp-128)/127.0f));
+    }
+}
+
+void LoadSamples_short_SSE2(ALfloat *dst, const ALvoid *src, ALuint count)
+{
+    const ALshort *data = src;
+    const __m128 negscale = _mm_set1_ps(32768.0f);
+    const __m128 posscale = _mm_set1_ps(32767.0f);
+    ALuint i = 0;
+    ALint smp;
+
+    for(;count-i > 7;i += 8)
+    {
+        __m128i smps = _mm_loadu_si128((const __m128i*)&data[i]);
+
+        _mm_storeu_ps(&dst[i  ], ScaleSamples(_mm_cvtepi32_ps(_mm_srai_epi32(
+            _mm_unpacklo_epi16(smps, smps), 16)), negscale, posscale));
+        _mm_storeu_ps(&dst[i+4], ScaleSamples(_mm_cvtepi32_ps(_mm_srai_epi32(
+            _mm_unpackhi_epi16(smps, smps), 16)), negscale, posscale));
+    }
+    for(;i < count;i++)
+    {
+        smp = data[i];
+        dst[i] = ((smp < 0) ? (smp/32768.0f) : (smp/32767.0f));
+    }
+}
@@ -300,7 +300,7 @@ static void stream_buffer_attr_callback(pa_stream *stream, void *pdata) //{{{
     ALCdevice *Device = pdata;
     pulse_data *data = Device->ExtraData;
 
-    SuspendContext(NULL);
+    LockDevice(Device);
 
     data->attr = *(ppa_stream_get_buffer_attr(stream));
     if(data->attr.tlength < data->attr.minreq*2)
@@ -309,7 +309,7 @@ static void stream_buffer_attr_callback(pa_stream *stream, void *pdata) //{{{
     Device->UpdateSize = data->attr.minreq / data->frame_size;
     Device->NumUpdates = data->attr.tlength/data->attr.minreq;
 
-    ProcessContext(NULL);
+    UnlockDevice(Device);
 }//}}}
 
 static void context_state_callback2(pa_context *context, void *pdata) //{{{
@@ -110,7 +110,7 @@ DWORD WINAPI CaptureThreadProc(LPVOID lpParameter)
     {
         if ((msg.message==WIM_DATA)&&(!pData->bWaveInShutdown))
         {
-            SuspendContext(NULL);
+            LockDevice(pDevice);
 
             pWaveHdr = ((LPWAVEHDR)msg.lParam);
 
@@ -149,7 +149,7 @@ DWORD WINAPI CaptureThreadProc(LPVOID lpParameter)
             waveInAddBuffer(pData->hWaveInHandle,pWaveHdr,sizeof(WAVEHDR));
             pData->lWaveInBuffersCommitted++;
 
-            ProcessContext(NULL);
+            UnlockDevice(pDevice);
         }
     }
 
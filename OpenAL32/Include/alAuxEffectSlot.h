@@ -27,6 +27,9 @@ typedef struct ALeffectslot
     ALeffectState *EffectState;
 
     ALfloat WetBuffer[BUFFERSIZE];
+    // Separate wet buffers for each extra mixing thread, summed into
+    // WetBuffer before the effect is processed
+    ALfloat (*ThreadWetBuffer)[BUFFERSIZE];
 
     ALuint refcount;
 
@@ -57,7 +60,7 @@ struct ALeffectState {
     ALvoid (*Destroy)(ALeffectState *State);
     ALboolean (*DeviceUpdate)(ALeffectState *State, ALCdevice *Device);
     ALvoid (*Update)(ALeffectState *State, ALCcontext *Context, const ALeffect *Effect);
-    ALvoid (*Process)(ALeffectState *State, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[OUTPUTCHANNELS]);
+    ALvoid (*Process)(ALeffectState *State, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[BUFFERSIZE]);
 };
 
 ALeffectState *NoneCreate(void);
@@ -2,18 +2,30 @@
 #define _AL_BUFFER_H_
 
 #include "AL/al.h"
+#include "AL/alext.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define BUFFER_PADDING 2
-
 typedef struct ALbuffer
 {
-    ALfloat *data;
+    ALvoid  *data;
     ALsizei  size;
 
+    // Set when data holds IMA4 blocks, which are decoded as they're mixed.
+    // The format and size are still those of the decoded samples.
+    ALboolean Compressed;
+    // Changes whenever the data does, so decoded copies can tell they're
+    // out of date
+    ALuint   Serial;
+
+    // Set when data belongs to the app (see alBufferDataStaticEXT), which is
+    // told through the release callback once it's no longer used
+    ALboolean Static;
+    ALBUFFERRELEASEPROCEXT Release;
+    ALvoid  *ReleaseParam;
+
     ALenum   format;
     ALenum   eOriginalFormat;
     ALsizei  frequency;
@@ -23,13 +35,23 @@ typedef struct ALbuffer
     // Index to itself
     ALuint buffer;
 
+    struct ALbuffer *prev;
     struct ALbuffer *next;
 } ALbuffer;
 
 ALvoid ALAPIENTRY alBufferSubDataEXT(ALuint buffer,ALenum format,const ALvoid *data,ALsizei offset,ALsizei length);
+ALvoid ALAPIENTRY alBufferDataStaticEXT(ALuint buffer,ALenum format,const ALvoid *data,ALsizei size,ALsizei freq,ALBUFFERRELEASEPROCEXT release,ALvoid *userptr);
+ALvoid ALAPIENTRY alBufferDataFromBankEXT(const ALchar *filename,ALsizei n,const ALuint *buffers);
 
 ALvoid ReleaseALBuffers(ALCdevice *device);
 
+ALenum CheckStaticData(const ALbuffer *ALBuf, ALenum format, const ALvoid *data, ALsizei size);
+ALvoid SetStaticData(ALCdevice *device, ALbuffer *ALBuf, ALenum format, const ALvoid *data, ALsizei size, ALsizei freq, ALBUFFERRELEASEPROCEXT release, ALvoid *userptr);
+
+ALvoid DecodeIMA4Block(ALshort *dst, const ALvoid *src, ALuint chans);
+
+extern ALboolean KeepIMA4Compressed;
+
 #ifdef __cplusplus
 }
 #endif
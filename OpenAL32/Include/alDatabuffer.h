@@ -21,6 +21,7 @@ typedef struct ALdatabuffer
     /* Index to self */
     ALuint   databuffer;
 
+    struct ALdatabuffer *prev;
     struct ALdatabuffer *next;
 } ALdatabuffer;
 
@@ -248,6 +248,7 @@ typedef struct ALeffect
     // Index to itself
     ALuint effect;
 
+    struct ALeffect *prev;
     struct ALeffect *next;
 } ALeffect;
 
@@ -100,6 +100,7 @@ typedef struct ALfilter
     // Index to itself
     ALuint filter;
 
+    struct ALfilter *prev;
     struct ALfilter *next;
 } ALfilter;
 
@@ -17,6 +17,13 @@ typedef struct ALlistener_struct
     ALfloat Up[3];
     ALfloat Gain;
     ALfloat MetersPerUnit;
+
+    // Transform into listener space, and the listener's velocity in that
+    // space. Rebuilt by aluUpdateListener whenever the listener moves, which
+    // also bumps Generation so sources know their cached placement is stale.
+    ALfloat Matrix[4][4];
+    ALfloat LocalVelocity[3];
+    ALuint  Generation;
 } ALlistener;
 
 #ifdef __cplusplus
@@ -145,6 +145,7 @@ static inline void Sleep(ALuint t)
 #endif
 
 #include "alListener.h"
+#include "alPool.h"
 #include "alu.h"
 
 #ifdef __cplusplus
@@ -179,6 +180,54 @@ static __inline ALuint NextPowerOf2(ALuint value)
     return powerOf2;
 }
 
+// Atomically stores a new value, returning the old one. This is a full
+// memory barrier, so anything written before it is visible to a thread that
+// sees the new value.
+static __inline ALuint ExchangeInt(volatile ALuint *ptr, ALuint newval)
+{
+#if defined(_WIN32)
+    return (ALuint)InterlockedExchange((volatile LONG*)ptr, (LONG)newval);
+#elif defined(__GNUC__)
+    ALuint oldval;
+    do {
+        oldval = *ptr;
+    } while(__sync_val_compare_and_swap(ptr, oldval, newval) != oldval);
+    return oldval;
+#else
+#error "No atomic exchange available for this compiler"
+#endif
+}
+
+// Keeps reads before the barrier from being done after reads following it
+// (an acquire fence)
+static __inline void ReadBarrier(void)
+{
+#if defined(__GNUC__) && defined(__ATOMIC_ACQUIRE)
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#elif defined(__GNUC__)
+    __sync_synchronize();
+#elif defined(_WIN32)
+    MemoryBarrier();
+#else
+#error "No memory barrier available for this compiler"
+#endif
+}
+
+// Keeps reads and writes before the barrier from being seen after writes
+// following it (a release fence)
+static __inline void WriteBarrier(void)
+{
+#if defined(__GNUC__) && defined(__ATOMIC_RELEASE)
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#elif defined(__GNUC__)
+    __sync_synchronize();
+#elif defined(_WIN32)
+    MemoryBarrier();
+#else
+#error "No memory barrier available for this compiler"
+#endif
+}
+
 
 typedef struct {
     ALCboolean (*OpenPlayback)(ALCdevice*, const ALCchar*);
@@ -247,6 +296,10 @@ struct ALCdevice_struct
     ALuint       MaxNoOfSources;
     // Maximum number of slots that can be created
     ALuint       AuxiliaryEffectSlotMax;
+    // Maximum number of playing sources mixed each update (0 for no limit),
+    // and space to pick the most audible ones
+    ALuint       MaxVoices;
+    struct ALsource **VoiceHeap;
 
     ALint        lNumMonoSources;
     ALint        lNumStereoSources;
@@ -255,6 +308,8 @@ struct ALCdevice_struct
     // Linked List of Buffers for this device
     struct ALbuffer *Buffers;
     ALuint          BufferCount;
+    // Last serial given to a buffer's data (see ALbuffer::Serial)
+    ALuint          BufferSerial;
 
     // Linked List of Effects for this device
     struct ALeffect *EffectList;
@@ -268,6 +323,11 @@ struct ALCdevice_struct
     struct ALdatabuffer *Databuffers;
     ALuint              DatabufferCount;
 
+    // Storage for the device's buffers, effects and filters
+    ALpool       BufferPool;
+    ALpool       EffectPool;
+    ALpool       FilterPool;
+
     // Stereo-to-binaural filter
     struct bs2b *Bs2b;
     ALCint       Bs2bLevel;
@@ -275,8 +335,19 @@ struct ALCdevice_struct
     // Simulated dampening from head occlusion
     ALfloat      HeadDampen;
 
-    // Dry path buffer mix
-    float DryBuffer[BUFFERSIZE][OUTPUTCHANNELS];
+    // Dry path buffer mix, one contiguous row per output channel
+    float DryBuffer[OUTPUTCHANNELS][BUFFERSIZE];
+
+    // Number of threads sharing the source mixing (including the device's
+    // own mixing thread), and the extra threads' state
+    ALuint NumMixThreads;
+    struct ALmixpool *MixPool;
+    // Scratch space for the device's own mixing thread
+    struct MixScratch *Scratch;
+
+    // Source parameter and placement recalculations done by the last update
+    ALuint ParamUpdates;
+    ALuint PlacementUpdates;
 
     Channel DevChannels[OUTPUTCHANNELS];
 
@@ -287,6 +358,11 @@ struct ALCdevice_struct
     BackendFuncs *Funcs;
     void         *ExtraData; // For the backend's use
 
+    // Protects the device and everything on it, including its contexts.
+    // LockCount is how many times the holding thread has taken it.
+    CRITICAL_SECTION Mutex;
+    ALuint           LockCount;
+
     ALCdevice *next;
 };
 
@@ -306,11 +382,16 @@ struct ALCcontext_struct
     ALlistener  Listener;
 
     struct ALsource *Source;
+    struct ALsource *SourceTail;
     ALuint           SourceCount;
 
     struct ALeffectslot *AuxiliaryEffectSlot;
     ALuint               AuxiliaryEffectSlotCount;
 
+    // Storage for the context's sources and their buffer queue items
+    ALpool      SourcePool;
+    ALpool      BufferListPool;
+
     struct ALdatabuffer *SampleSource;
     struct ALdatabuffer *SampleSink;
 
@@ -319,6 +400,14 @@ struct ALCcontext_struct
 
     ALboolean   Suspended;
 
+    // Set between alDeferUpdatesEXT and alProcessUpdatesEXT. Source property
+    // changes are held back until then. Listener changes go to
+    // DeferredListener instead of Listener, and UpdateSources is set instead
+    // of updating the sources.
+    ALboolean   DeferUpdates;
+    ALboolean   UpdateSources;
+    ALlistener  DeferredListener;
+
     ALenum      DistanceModel;
     ALboolean   SourceDistanceModel;
 
@@ -339,6 +428,14 @@ struct ALCcontext_struct
 
 extern ALint RTPrioLevel;
 
+enum {
+    CPU_CAP_SSE  = 1<<0,
+    CPU_CAP_NEON = 1<<1,
+    CPU_CAP_SSE2 = 1<<2
+};
+// CPU extensions usable by the mixer
+extern ALuint CPUCapFlags;
+
 ALCvoid ReleaseALC(ALCvoid);
 
 void AppendDeviceList(const ALCchar *name);
@@ -350,11 +447,23 @@ ALCvoid alcSetError(ALCdevice *device, ALenum errorCode);
 ALCvoid SuspendContext(ALCcontext *context);
 ALCvoid ProcessContext(ALCcontext *context);
 
+ALCvoid LockDevice(ALCdevice *device);
+ALCvoid UnlockDevice(ALCdevice *device);
+
 ALvoid *StartThread(ALuint (*func)(ALvoid*), ALvoid *ptr);
 ALuint StopThread(ALvoid *thread);
 
+ALvoid *CreateSem(void);
+ALvoid DestroySem(ALvoid *sem);
+ALvoid PostSem(ALvoid *sem);
+ALvoid WaitSem(ALvoid *sem);
+
 ALCcontext *GetContextSuspended(void);
 
+ALCvoid LockProps(ALCvoid);
+ALCvoid UnlockProps(ALCvoid);
+ALCcontext *GetContextProps(void);
+
 typedef struct RingBuffer RingBuffer;
 RingBuffer *CreateRingBuffer(ALsizei frame_size, ALsizei length);
 void DestroyRingBuffer(RingBuffer *ring);
@@ -0,0 +1,36 @@
+#ifndef _AL_POOL_H_
+#define _AL_POOL_H_
+
+#include "AL/al.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A pool of same-sized objects, allocated a slab at a time. Freed objects go
+ * on a free list and are handed out again by the next allocation, and the
+ * slabs are only released when the pool is destroyed. A pool has no lock of
+ * its own, so its owner's lock must be held to use it. */
+typedef struct ALpool
+{
+    ALuint ObjSize;
+    ALuint SlabObjs;
+
+    ALvoid *FreeList;
+    ALvoid *Slabs;
+
+    // Allocations taken from the free list, and ones that needed a new slab
+    ALuint Hits;
+    ALuint Misses;
+} ALpool;
+
+ALvoid InitPool(ALpool *pool, ALuint objSize, ALuint slabObjs);
+ALvoid DestroyPool(ALpool *pool);
+ALvoid *PoolAlloc(ALpool *pool);
+ALvoid PoolFree(ALpool *pool, ALvoid *obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //_AL_POOL_H_
@@ -26,6 +26,7 @@ typedef enum {
     POINT_RESAMPLER = 0,
     LINEAR_RESAMPLER,
     COSINE_RESAMPLER,
+    SINC_RESAMPLER,
 
     RESAMPLER_MAX,
     RESAMPLER_MIN = -1,
@@ -37,8 +38,47 @@ typedef struct ALbufferlistitem
 {
     struct ALbuffer         *buffer;
     struct ALbufferlistitem *next;
+    struct ALbufferlistitem *prev;
+    // Bytes queued on the source before this item. It keeps counting up as
+    // items are queued, so the offset between two items is the difference
+    // of their Starts, even after earlier items are unqueued.
+    ALuint                   Start;
 } ALbufferlistitem;
 
+/* Source properties that the app can change without waiting for the mixer.
+ * Setters update the source's own fields under the property lock, then copy
+ * them into a block which gets published to the mixer. Each source has three
+ * blocks: the one the setters fill in, the one last published, and the one
+ * the mixer is using. Publishing swaps the filled block with the published
+ * one, and the mixer swaps the published block with its own when it's
+ * marked fresh. Neither side ever waits on the other. */
+typedef struct ALsourceProps
+{
+    ALfloat Pitch;
+    ALfloat Gain;
+    ALfloat OuterGain;
+    ALfloat MinGain;
+    ALfloat MaxGain;
+    ALfloat InnerAngle;
+    ALfloat OuterAngle;
+    ALfloat RefDistance;
+    ALfloat MaxDistance;
+    ALfloat RollOffFactor;
+    ALfloat Position[3];
+    ALfloat Velocity[3];
+    ALfloat Orientation[3];
+    ALfloat OuterGainHF;
+    ALfloat AirAbsorptionFactor;
+    ALfloat RoomRolloffFactor;
+    ALfloat DopplerFactor;
+    ALfloat Priority;
+} ALsourceProps;
+
+// PropState holds the published block's index, and this flag if the mixer
+// hasn't picked it up yet
+#define PROPS_INDEX_MASK  3
+#define PROPS_FRESH       4
+
 typedef struct ALsource
 {
     ALfloat      flPitch;
@@ -67,6 +107,14 @@ typedef struct ALsource
     struct ALbuffer *Buffer;
 
     struct ALbufferlistitem *queue; // Linked list of buffers in queue
+    struct ALbufferlistitem *QueueTail;   // Last item in queue
+    struct ALbufferlistitem *CurrentItem; // Item BuffersPlayed, or NULL if
+                                          // they've all been played
+    // Queue items in order, for seeking. The queued items are entries
+    // QueueIndexHead through QueueIndexHead+BuffersInQueue-1.
+    struct ALbufferlistitem **QueueIndex;
+    ALuint       QueueIndexHead;
+    ALuint       QueueIndexSize;    // Number of entries allocated
     ALuint       BuffersInQueue;    // Number of buffers in queue
     ALuint       BuffersPlayed;     // Number of buffers played on this loop
 
@@ -86,6 +134,9 @@ typedef struct ALsource
     ALfloat RoomRolloffFactor;
     ALfloat DopplerFactor;
 
+    // Scales the source's audibility when competing for a real voice
+    ALfloat Priority;
+
     ALint  lOffset;
     ALint  lOffsetType;
 
@@ -111,14 +162,63 @@ typedef struct ALsource
 
         FILTER iirFilter;
         ALfloat history[OUTPUTCHANNELS*2];
+
+        // Where the source is relative to the listener, and what that was
+        // calculated from. It's only recalculated when one of them moves.
+        struct {
+            ALfloat Position[3];
+            ALfloat Velocity[3];
+            ALfloat Orientation[3];
+            ALfloat RefDistance;
+            ALboolean HeadRelative;
+            ALuint ListenerGen;
+            ALboolean Valid;
+
+            ALfloat Distance;
+            ALfloat ConeAngle;
+            ALfloat RearAngle;
+            // Source and listener speeds towards the listener
+            ALfloat SourceSpeed;
+            ALfloat ListenerSpeed;
+            ALint PanPos;
+            ALfloat DirGain;
+        } Placement;
     } Params;
 
+    // Set when the source lost its voice to more audible sources, so it's
+    // faded out and only has its position advanced until it gets one back.
+    // Audibility is what it was ranked by on the last update.
+    ALboolean Culled;
+    ALfloat Audibility;
+
+    // The IMA4 block last decoded by the mixer for this source, kept so it
+    // isn't decoded again while it's still being read (see LoadIMA4Frames)
+    struct {
+        const struct ALbuffer *Buffer;
+        ALuint Serial;
+        ALuint Block;
+        ALfloat Samples[65*2];
+    } IMA4Cache;
+
+    // Property blocks passed from the setters to the mixer
+    ALsourceProps Props[3];
+    volatile ALuint PropState;
+    ALuint PropWrite; // Only used with the property lock held
+    ALuint PropRead;  // Only used by the mixer
+    // Set when changes are waiting for alProcessUpdatesEXT
+    ALboolean PropsDeferred;
+
     // Index to itself
     ALuint source;
 
+    struct ALsource *prev;
     struct ALsource *next;
 } ALsource;
 
+ALvoid ALAPIENTRY alSourcesfvEXT(ALsizei n, const ALuint *sources, ALenum eParam, const ALfloat *pflValues);
+ALvoid ALAPIENTRY alGetSourcesfvEXT(ALsizei n, const ALuint *sources, ALenum eParam, ALfloat *pflValues);
+
+ALvoid ApplyDeferredSourceProps(ALCcontext *Context);
 ALvoid ReleaseALSources(ALCcontext *Context);
 
 #ifdef __cplusplus
@@ -7,6 +7,9 @@
 extern "C" {
 #endif
 
+ALvoid ALAPIENTRY alDeferUpdatesEXT(ALvoid);
+ALvoid ALAPIENTRY alProcessUpdatesEXT(ALvoid);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,29 +10,30 @@
 extern "C" {
 #endif
 
+/* The kinds of objects that have handles, so a handle for one kind of object
+ * isn't mistaken for another */
+typedef enum {
+    THUNK_SOURCE = 1,
+    THUNK_BUFFER,
+    THUNK_EFFECT,
+    THUNK_FILTER,
+    THUNK_EFFECTSLOT,
+    THUNK_DATABUFFER
+} ThunkType;
+
 void alThunkInit(void);
 void alThunkExit(void);
-ALuint alThunkAddEntry(ALvoid * ptr);
-void alThunkRemoveEntry(ALuint index);
-ALvoid *alThunkLookupEntry(ALuint index);
-
-#if (SIZEOF_VOIDP > SIZEOF_UINT)
-
-#define ALTHUNK_INIT()          alThunkInit()
-#define ALTHUNK_EXIT()          alThunkExit()
-#define ALTHUNK_ADDENTRY(p)     alThunkAddEntry(p)
-#define ALTHUNK_REMOVEENTRY(i)  alThunkRemoveEntry(i)
-#define ALTHUNK_LOOKUPENTRY(i)  alThunkLookupEntry(i)
-
-#else
-
-#define ALTHUNK_INIT()
-#define ALTHUNK_EXIT()
-#define ALTHUNK_ADDENTRY(p)     ((ALuint)p)
-#define ALTHUNK_REMOVEENTRY(i)
-#define ALTHUNK_LOOKUPENTRY(i)  ((ALvoid*)(i))
-
-#endif // (SIZEOF_VOIDP > SIZEOF_INT)
+ALuint alThunkAddEntry(ALvoid *ptr, ThunkType type, const ALvoid *owner);
+void alThunkRemoveEntry(ALuint handle);
+ALvoid *alThunkLookupEntry(ALuint handle);
+ALvoid *alThunkLookupObject(ALuint handle, ThunkType type, const ALvoid *owner);
+
+#define ALTHUNK_INIT()              alThunkInit()
+#define ALTHUNK_EXIT()              alThunkExit()
+#define ALTHUNK_ADDENTRY(p,t,o)     alThunkAddEntry((p), (t), (o))
+#define ALTHUNK_REMOVEENTRY(i)      alThunkRemoveEntry(i)
+#define ALTHUNK_LOOKUPENTRY(i)      alThunkLookupEntry(i)
+#define ALTHUNK_LOOKUPOBJECT(i,t,o) alThunkLookupObject((i), (t), (o))
 
 #ifdef __cplusplus
 }
@@ -68,7 +68,9 @@ typedef enum {
     OUTPUTCHANNELS
 } Channel;
 
-#define BUFFERSIZE 24000
+#define BUFFERSIZE 4096
+
+#define MAX_MIX_THREADS 16
 
 extern ALboolean DuplicateStereo;
 
@@ -164,8 +166,12 @@ static __inline ALint aluCart2LUTpos(ALfloat re, ALfloat im)
 }
 
 ALvoid aluInitPanning(ALCcontext *Context);
+ALvoid aluUpdateListener(ALCcontext *Context);
+ALvoid aluInitResamplers(ALvoid);
 ALvoid aluMixData(ALCdevice *device, ALvoid *buffer, ALsizei size);
 ALvoid aluHandleDisconnect(ALCdevice *device);
+ALboolean aluInitMixThreads(ALCdevice *device);
+ALvoid aluDeinitMixThreads(ALCdevice *device);
 
 #ifdef __cplusplus
 }
@@ -60,9 +60,22 @@ ALvoid AL_APIENTRY alGenAuxiliaryEffectSlots(ALsizei n, ALuint *effectslots)
                 while(i < n)
                 {
                     *list = calloc(1, sizeof(ALeffectslot));
-                    if(!(*list) || !((*list)->EffectState=NoneCreate()))
+                    if(*list && Device->NumMixThreads > 1)
+                        (*list)->ThreadWetBuffer = calloc(Device->NumMixThreads-1,
+                                                          sizeof(*(*list)->ThreadWetBuffer));
+                    if(*list)
+                        (*list)->effectslot = ALTHUNK_ADDENTRY(*list, THUNK_EFFECTSLOT, Context);
+                    if(!(*list) || !(*list)->effectslot ||
+                       (Device->NumMixThreads > 1 && !(*list)->ThreadWetBuffer) ||
+                       !((*list)->EffectState=NoneCreate()))
                     {
                         // We must have run out or memory
+                        if(*list)
+                        {
+                            if((*list)->effectslot)
+                                ALTHUNK_REMOVEENTRY((*list)->effectslot);
+                            free((*list)->ThreadWetBuffer);
+                        }
                         free(*list); *list = NULL;
                         alDeleteAuxiliaryEffectSlots(i, effectslots);
                         alSetError(AL_OUT_OF_MEMORY);
@@ -75,8 +88,7 @@ ALvoid AL_APIENTRY alGenAuxiliaryEffectSlots(ALsizei n, ALuint *effectslots)
                         (*list)->WetBuffer[j] = 0.0f;
                     (*list)->refcount = 0;
 
-                    effectslots[i] = (ALuint)ALTHUNK_ADDENTRY(*list);
-                    (*list)->effectslot = effectslots[i];
+                    effectslots[i] = (*list)->effectslot;
 
                     Context->AuxiliaryEffectSlotCount++;
                     i++;
@@ -145,6 +157,7 @@ ALvoid AL_APIENTRY alDeleteAuxiliaryEffectSlots(ALsizei n, ALuint *effectslots)
 
                     if(ALAuxiliaryEffectSlot->EffectState)
                         ALEffect_Destroy(ALAuxiliaryEffectSlot->EffectState);
+                    free(ALAuxiliaryEffectSlot->ThreadWetBuffer);
 
                     memset(ALAuxiliaryEffectSlot, 0, sizeof(ALeffectslot));
                     free(ALAuxiliaryEffectSlot);
@@ -163,18 +176,17 @@ ALvoid AL_APIENTRY alDeleteAuxiliaryEffectSlots(ALsizei n, ALuint *effectslots)
 ALboolean AL_APIENTRY alIsAuxiliaryEffectSlot(ALuint effectslot)
 {
     ALCcontext *Context;
-    ALeffectslot **list;
+    ALeffectslot *ALEffectSlot;
 
     Context = GetContextSuspended();
     if(!Context) return AL_FALSE;
 
-    list = &Context->AuxiliaryEffectSlot;
-    while(*list && (*list)->effectslot != effectslot)
-        list = &(*list)->next;
+    ALEffectSlot = (ALeffectslot*)ALTHUNK_LOOKUPOBJECT(effectslot, THUNK_EFFECTSLOT,
+                                                       Context);
 
     ProcessContext(Context);
 
-    return (*list ? AL_TRUE : AL_FALSE);
+    return (ALEffectSlot ? AL_TRUE : AL_FALSE);
 }
 
 ALvoid AL_APIENTRY alAuxiliaryEffectSloti(ALuint effectslot, ALenum param, ALint iValue)
@@ -455,7 +467,7 @@ static ALvoid NoneUpdate(ALeffectState *State, ALCcontext *Context, const ALeffe
     (void)Context;
     (void)Effect;
 }
-static ALvoid NoneProcess(ALeffectState *State, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[OUTPUTCHANNELS])
+static ALvoid NoneProcess(ALeffectState *State, const ALeffectslot *Slot, ALuint SamplesToDo, const ALfloat *SamplesIn, ALfloat (*SamplesOut)[BUFFERSIZE])
 {
     (void)State;
     (void)Slot;
@@ -525,6 +537,7 @@ ALvoid ReleaseALAuxiliaryEffectSlots(ALCcontext *Context)
         // Release effectslot structure
         if(temp->EffectState)
             ALEffect_Destroy(temp->EffectState);
+        free(temp->ThreadWetBuffer);
         ALTHUNK_REMOVEENTRY(temp->effectslot);
 
         memset(temp, 0, sizeof(ALeffectslot));
@@ -33,9 +33,12 @@
 
 
 static void LoadData(ALbuffer *ALBuf, const ALubyte *data, ALsizei size, ALuint freq, ALenum OrigFormat, ALenum NewFormat);
-static void ConvertData(ALfloat *dst, const ALvoid *src, ALint origBytes, ALsizei len);
-static void ConvertDataRear(ALfloat *dst, const ALvoid *src, ALint origBytes, ALsizei len);
-static void ConvertDataIMA4(ALfloat *dst, const ALvoid *src, ALint origChans, ALsizei len);
+static ALvoid *ReallocData(ALbuffer *ALBuf, ALsizei size);
+static void FreeData(ALbuffer *ALBuf);
+static ALenum StaticFormat(ALenum format, ALboolean *Compressed);
+static void ConvertData(ALvoid *dst, ALint newBytes, const ALvoid *src, ALint origBytes, ALsizei len);
+static void ConvertDataRear(ALvoid *dst, ALint newBytes, const ALvoid *src, ALint origBytes, ALsizei len);
+static void ConvertDataIMA4(ALshort *dst, const ALvoid *src, ALint origChans, ALsizei len);
 
 /*
  *  AL Buffer Functions
@@ -50,6 +53,12 @@ static void ConvertDataIMA4(ALfloat *dst, const ALvoid *src, ALint origChans, AL
 * Global Variables
 */
 
+/*
+ * Set by the ima4-compressed config option, to keep IMA4 buffers compressed
+ * instead of decoding them when they're loaded
+ */
+ALboolean KeepIMA4Compressed = AL_FALSE;
+
 static const long g_IMAStep_size[89]={            // IMA ADPCM Stepsize table
        7,    8,    9,   10,   11,   12,   13,   14,   16,   17,   19,   21,   23,   25,   28,   31,
       34,   37,   41,   45,   50,   55,   60,   66,   73,   80,   88,   97,  107,  118,  130,  143,
@@ -90,28 +99,29 @@ ALAPI ALvoid ALAPIENTRY alGenBuffers(ALsizei n,ALuint *puiBuffers)
         // Check the pointer is valid (and points to enough memory to store Buffer Names)
         if (!IsBadWritePtr((void*)puiBuffers, n * sizeof(ALuint)))
         {
-            ALbuffer **list = &device->Buffers;
-            while(*list)
-                list = &(*list)->next;
-
             // Create all the new Buffers
             while(i < n)
             {
-                *list = calloc(1, sizeof(ALbuffer));
-                if(!(*list))
+                ALbuffer *ALBuf = PoolAlloc(&device->BufferPool);
+                if(ALBuf)
+                    ALBuf->buffer = ALTHUNK_ADDENTRY(ALBuf, THUNK_BUFFER, device);
+                if(!ALBuf || !ALBuf->buffer)
                 {
+                    PoolFree(&device->BufferPool, ALBuf);
                     alDeleteBuffers(i, puiBuffers);
                     alSetError(AL_OUT_OF_MEMORY);
                     break;
                 }
+                puiBuffers[i] = ALBuf->buffer;
 
-                puiBuffers[i] = (ALuint)ALTHUNK_ADDENTRY(*list);
-                (*list)->buffer = puiBuffers[i];
+                // The device's list isn't in any particular order
+                ALBuf->next = device->Buffers;
+                if(ALBuf->next)
+                    ALBuf->next->prev = ALBuf;
+                device->Buffers = ALBuf;
 
                 device->BufferCount++;
                 i++;
-
-                list = &(*list)->next;
             }
         }
         else
@@ -177,23 +187,22 @@ ALAPI ALvoid ALAPIENTRY alDeleteBuffers(ALsizei n, const ALuint *puiBuffers)
             {
                 if (puiBuffers[i] && alIsBuffer(puiBuffers[i]))
                 {
-                    ALbuffer **list = &device->Buffers;
-
                     ALBuf=((ALbuffer *)ALTHUNK_LOOKUPENTRY(puiBuffers[i]));
-                    while(*list && *list != ALBuf)
-                        list = &(*list)->next;
-
-                    if(*list)
-                        *list = (*list)->next;
+                    if(ALBuf->prev)
+                        ALBuf->prev->next = ALBuf->next;
+                    else
+                        device->Buffers = ALBuf->next;
+                    if(ALBuf->next)
+                        ALBuf->next->prev = ALBuf->prev;
 
                     // Release the memory used to store audio data
-                    free(ALBuf->data);
+                    FreeData(ALBuf);
 
                     // Release buffer structure
                     ALTHUNK_REMOVEENTRY(puiBuffers[i]);
                     memset(ALBuf, 0, sizeof(ALbuffer));
                     device->BufferCount--;
-                    free(ALBuf);
+                    PoolFree(&device->BufferPool, ALBuf);
                 }
             }
         }
@@ -213,30 +222,15 @@ ALAPI ALboolean ALAPIENTRY alIsBuffer(ALuint uiBuffer)
 {
     ALCcontext *Context;
     ALboolean result=AL_FALSE;
-    ALbuffer *ALBuf;
-    ALbuffer *TgtALBuf;
 
     Context = GetContextSuspended();
     if(!Context) return AL_FALSE;
 
     if (uiBuffer)
     {
-        ALCdevice *device = Context->Device;
-
-        TgtALBuf = (ALbuffer *)ALTHUNK_LOOKUPENTRY(uiBuffer);
-
-        // Check through list of generated buffers for uiBuffer
-        ALBuf = device->Buffers;
-        while (ALBuf)
-        {
-            if (ALBuf == TgtALBuf)
-            {
-                result = AL_TRUE;
-                break;
-            }
-
-            ALBuf = ALBuf->next;
-        }
+        // Only buffers generated on this device are found
+        if(ALTHUNK_LOOKUPOBJECT(uiBuffer, THUNK_BUFFER, Context->Device))
+            result = AL_TRUE;
     }
     else
     {
@@ -284,31 +278,29 @@ ALAPI ALvoid ALAPIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid *d
 
         if ((ALBuf->refcount==0)&&(data))
         {
+            ALBuf->Serial = ++Context->Device->BufferSerial;
             switch(format)
             {
                 case AL_FORMAT_MONO8:
                 case AL_FORMAT_MONO16:
                 case AL_FORMAT_MONO_FLOAT32:
-                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_MONO_FLOAT32);
+                    LoadData(ALBuf, data, size, freq, format, format);
                     break;
 
                 case AL_FORMAT_STEREO8:
                 case AL_FORMAT_STEREO16:
                 case AL_FORMAT_STEREO_FLOAT32:
-                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_STEREO_FLOAT32);
+                    LoadData(ALBuf, data, size, freq, format, format);
                     break;
 
                 case AL_FORMAT_REAR8:
                 case AL_FORMAT_REAR16:
                 case AL_FORMAT_REAR32: {
-                    ALuint NewFormat = AL_FORMAT_QUAD32;
-                    ALuint NewChannels = aluChannelsFromFormat(NewFormat);
+                    ALuint NewFormat = ((format==AL_FORMAT_REAR8) ? AL_FORMAT_QUAD8 :
+                                        ((format==AL_FORMAT_REAR16) ? AL_FORMAT_QUAD16 :
+                                         AL_FORMAT_QUAD32));
                     ALuint NewBytes = aluBytesFromFormat(NewFormat);
-                    ALuint OrigBytes = ((format==AL_FORMAT_REAR8) ? 1 :
-                                        ((format==AL_FORMAT_REAR16) ? 2 :
-                                         4));
-
-                    assert(aluBytesFromFormat(NewFormat) == 2);
+                    ALuint OrigBytes = NewBytes;
 
                     if((size%(OrigBytes*2)) != 0)
                     {
@@ -319,13 +311,14 @@ ALAPI ALvoid ALAPIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid *d
                     size /= OrigBytes;
                     size *= 2;
 
-                    // Samples are converted here
-                    temp = realloc(ALBuf->data, (BUFFER_PADDING*NewChannels + size) * NewBytes);
+                    // The rear channels are copied into a quad layout here
+                    temp = ReallocData(ALBuf, size*NewBytes);
                     if(temp)
                     {
                         ALBuf->data = temp;
-                        ConvertDataRear(ALBuf->data, data, OrigBytes, size);
+                        ConvertDataRear(ALBuf->data, NewBytes, data, OrigBytes, size);
 
+                        ALBuf->Compressed = AL_FALSE;
                         ALBuf->format = NewFormat;
                         ALBuf->eOriginalFormat = format;
                         ALBuf->size = size*NewBytes;
@@ -336,37 +329,44 @@ ALAPI ALvoid ALAPIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid *d
                 }   break;
 
                 case AL_FORMAT_QUAD8_LOKI:
+                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_QUAD8);
+                    break;
+
                 case AL_FORMAT_QUAD16_LOKI:
+                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_QUAD16);
+                    break;
+
                 case AL_FORMAT_QUAD8:
                 case AL_FORMAT_QUAD16:
                 case AL_FORMAT_QUAD32:
-                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_QUAD32);
+                    LoadData(ALBuf, data, size, freq, format, format);
                     break;
 
                 case AL_FORMAT_51CHN8:
                 case AL_FORMAT_51CHN16:
                 case AL_FORMAT_51CHN32:
-                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_51CHN32);
+                    LoadData(ALBuf, data, size, freq, format, format);
                     break;
 
                 case AL_FORMAT_61CHN8:
                 case AL_FORMAT_61CHN16:
                 case AL_FORMAT_61CHN32:
-                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_61CHN32);
+                    LoadData(ALBuf, data, size, freq, format, format);
                     break;
 
                 case AL_FORMAT_71CHN8:
                 case AL_FORMAT_71CHN16:
                 case AL_FORMAT_71CHN32:
-                    LoadData(ALBuf, data, size, freq, format, AL_FORMAT_71CHN32);
+                    LoadData(ALBuf, data, size, freq, format, format);
                     break;
 
                 case AL_FORMAT_MONO_IMA4:
                 case AL_FORMAT_STEREO_IMA4: {
                     int OrigChans = ((format==AL_FORMAT_MONO_IMA4) ? 1 : 2);
-                    ALuint NewFormat = ((OrigChans==1) ? AL_FORMAT_MONO_FLOAT32 :
-                                                         AL_FORMAT_STEREO_FLOAT32);
+                    ALuint NewFormat = ((OrigChans==1) ? AL_FORMAT_MONO16 :
+                                                         AL_FORMAT_STEREO16);
                     ALuint NewBytes = aluBytesFromFormat(NewFormat);
+                    ALsizei DataSize = size;
 
                     // Here is where things vary:
                     // nVidia and Apple use 64+1 samples per channel per block => block_size=36*chans bytes
@@ -380,13 +380,20 @@ ALAPI ALvoid ALAPIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid *d
                     size /= 36;
                     size *= 65;
 
-                    // Allocate extra padding samples
-                    temp = realloc(ALBuf->data, (BUFFER_PADDING*OrigChans + size)*NewBytes);
+                    // Compressed blocks are stored as-is, while the format
+                    // and size describe the samples they decode to
+                    if(!KeepIMA4Compressed)
+                        DataSize = size*NewBytes;
+                    temp = ReallocData(ALBuf, DataSize);
                     if(temp)
                     {
                         ALBuf->data = temp;
-                        ConvertDataIMA4(ALBuf->data, data, OrigChans, size/65);
+                        if(KeepIMA4Compressed)
+                            memcpy(ALBuf->data, data, DataSize);
+                        else
+                            ConvertDataIMA4(ALBuf->data, data, OrigChans, size/65);
 
+                        ALBuf->Compressed = KeepIMA4Compressed;
                         ALBuf->format = NewFormat;
                         ALBuf->eOriginalFormat = format;
                         ALBuf->size = size*NewBytes;
@@ -416,6 +423,50 @@ ALAPI ALvoid ALAPIENTRY alBufferData(ALuint buffer,ALenum format,const ALvoid *d
     ProcessContext(Context);
 }
 
+/*
+*    alBufferDataStaticEXT(ALuint buffer,ALenum format,const ALvoid *data,ALsizei size,ALsizei freq,ALBUFFERRELEASEPROCEXT release,ALvoid *userptr)
+*
+*    Gives the buffer the app's own memory to play from, without copying it.
+*    The samples must already be in a format that's stored as-is (anything
+*    but the REAR formats), aligned to the sample size. The memory must stay
+*    valid and unchanged until release is called with the buffer, the data
+*    and userptr, which happens once the buffer is given other data or
+*    deleted, or its device is closed. The device is locked when release is
+*    called, so it shouldn't make any AL calls.
+*/
+ALvoid ALAPIENTRY alBufferDataStaticEXT(ALuint buffer,ALenum format,const ALvoid *data,ALsizei size,ALsizei freq,ALBUFFERRELEASEPROCEXT release,ALvoid *userptr)
+{
+    ALCcontext *Context;
+    ALbuffer *ALBuf;
+    ALenum err;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    if(alIsBuffer(buffer) && buffer != 0)
+    {
+        ALBuf = (ALbuffer*)ALTHUNK_LOOKUPENTRY(buffer);
+
+        if(Context->SampleSource)
+        {
+            // a databuffer's storage isn't the app's to give
+            alSetError(AL_INVALID_OPERATION);
+        }
+        else if((err=CheckStaticData(ALBuf, format, data, size)) != AL_NO_ERROR)
+            alSetError(err);
+        else
+            SetStaticData(Context->Device, ALBuf, format, data, size, freq,
+                          release, userptr);
+    }
+    else
+    {
+        // Invalid Buffer Name
+        alSetError(AL_INVALID_NAME);
+    }
+
+    ProcessContext(Context);
+}
+
 /*
 *    alBufferSubDataEXT(ALuint buffer,ALenum format,ALvoid *data,ALsizei offset,ALsizei length)
 *
@@ -458,6 +509,16 @@ ALvoid ALAPIENTRY alBufferSubDataEXT(ALuint buffer,ALenum format,const ALvoid *d
             // data is NULL or offset/length is negative
             alSetError(AL_INVALID_VALUE);
         }
+        else if(ALBuf->Static)
+        {
+            // the app's memory is only ever read
+            alSetError(AL_INVALID_OPERATION);
+        }
+        else if(ALBuf->Compressed && ALBuf->eOriginalFormat != format)
+        {
+            // compressed buffers can only be given more compressed blocks
+            alSetError(AL_INVALID_ENUM);
+        }
         else
         {
             switch(format)
@@ -470,9 +531,12 @@ ALvoid ALAPIENTRY alBufferSubDataEXT(ALuint buffer,ALenum format,const ALvoid *d
                                          4));
                     ALuint NewBytes = aluBytesFromFormat(ALBuf->format);
 
-                    if(ALBuf->eOriginalFormat != AL_FORMAT_REAR8 &&
-                       ALBuf->eOriginalFormat != AL_FORMAT_REAR16 &&
-                       ALBuf->eOriginalFormat != AL_FORMAT_REAR32)
+                    // Smaller samples are widened to the stored type, but
+                    // larger ones would lose precision
+                    if((ALBuf->eOriginalFormat != AL_FORMAT_REAR8 &&
+                        ALBuf->eOriginalFormat != AL_FORMAT_REAR16 &&
+                        ALBuf->eOriginalFormat != AL_FORMAT_REAR32) ||
+                       OrigBytes > NewBytes)
                     {
                         alSetError(AL_INVALID_ENUM);
                         break;
@@ -484,7 +548,8 @@ ALvoid ALAPIENTRY alBufferSubDataEXT(ALuint buffer,ALenum format,const ALvoid *d
                         break;
                     }
 
-                    ConvertDataRear(&ALBuf->data[offset*4], data, OrigBytes, length*2);
+                    ConvertDataRear(&((ALubyte*)ALBuf->data)[offset*4*NewBytes], NewBytes, data, OrigBytes, length*4);
+                    ALBuf->Serial = ++Context->Device->BufferSerial;
                 }   break;
 
                 case AL_FORMAT_MONO_IMA4:
@@ -505,15 +570,23 @@ ALvoid ALAPIENTRY alBufferSubDataEXT(ALuint buffer,ALenum format,const ALvoid *d
                         break;
                     }
 
-                    ConvertDataIMA4(&ALBuf->data[offset*Channels], data, Channels, length/65*Channels);
+                    if(ALBuf->Compressed)
+                        memcpy(&((ALubyte*)ALBuf->data)[offset/65*36*Channels], data, length/65*36*Channels);
+                    else
+                        ConvertDataIMA4(&((ALshort*)ALBuf->data)[offset*Channels], data, Channels, length/65*Channels);
+                    ALBuf->Serial = ++Context->Device->BufferSerial;
                 }   break;
 
                 default: {
                     ALuint Channels = aluChannelsFromFormat(format);
-                    ALuint Bytes = aluBytesFromFormat(format);
+                    ALuint OrigBytes = aluBytesFromFormat(format);
                     ALuint NewBytes = aluBytesFromFormat(ALBuf->format);
 
-                    if(Channels != aluChannelsFromFormat(ALBuf->format))
+                    // Samples are stored as they were loaded. Smaller ones
+                    // are widened to the stored type, but larger ones would
+                    // lose precision.
+                    if(Channels != aluChannelsFromFormat(ALBuf->format) ||
+                       OrigBytes > NewBytes)
                     {
                         alSetError(AL_INVALID_ENUM);
                         break;
@@ -525,7 +598,8 @@ ALvoid ALAPIENTRY alBufferSubDataEXT(ALuint buffer,ALenum format,const ALvoid *d
                         break;
                     }
 
-                    ConvertData(&ALBuf->data[offset*Channels], data, Bytes, length*Channels);
+                    ConvertData(&((ALubyte*)ALBuf->data)[offset*Channels*NewBytes], NewBytes, data, OrigBytes, length*Channels);
+                    ALBuf->Serial = ++Context->Device->BufferSerial;
                 }   break;
             }
         }
@@ -927,9 +1001,10 @@ ALAPI void ALAPIENTRY alGetBufferiv(ALuint buffer, ALenum eParam, ALint* plValue
  * LoadData
  *
  * Loads the specified data into the buffer, using the specified formats.
- * Currently, the new format must be 32-bit float, and must have the same
- * channel configuration as the original format. This does NOT handle
- * compressed formats (eg. IMA4).
+ * Samples are kept in their original type, and converted to float as they're
+ * mixed, so the new format must have the same sample size and channel
+ * configuration as the original format (it only differs for formats that are
+ * aliases of another). This does NOT handle compressed formats (eg. IMA4).
  */
 static void LoadData(ALbuffer *ALBuf, const ALubyte *data, ALsizei size, ALuint freq, ALenum OrigFormat, ALenum NewFormat)
 {
@@ -939,7 +1014,7 @@ static void LoadData(ALbuffer *ALBuf, const ALubyte *data, ALsizei size, ALuint
     ALuint OrigChannels = aluChannelsFromFormat(OrigFormat);
     ALvoid *temp;
 
-    assert(NewBytes == 4);
+    assert(NewBytes == OrigBytes);
     assert(NewChannels == OrigChannels);
 
     if ((size%(OrigBytes*OrigChannels)) != 0)
@@ -948,48 +1023,183 @@ static void LoadData(ALbuffer *ALBuf, const ALubyte *data, ALsizei size, ALuint
         return;
     }
 
-    // Samples are converted here
-    size /= OrigBytes;
-    temp = realloc(ALBuf->data, (BUFFER_PADDING*NewChannels + size) * NewBytes);
+    temp = ReallocData(ALBuf, size);
     if(temp)
     {
         ALBuf->data = temp;
-        ConvertData(ALBuf->data, data, OrigBytes, size);
+        memcpy(ALBuf->data, data, size);
 
+        ALBuf->Compressed = AL_FALSE;
         ALBuf->format = NewFormat;
         ALBuf->eOriginalFormat = OrigFormat;
-        ALBuf->size = size*NewBytes;
+        ALBuf->size = size;
         ALBuf->frequency = freq;
     }
     else
         alSetError(AL_OUT_OF_MEMORY);
 }
 
-static void ConvertData(ALfloat *dst, const ALvoid *src, ALint origBytes, ALsizei len)
+/*
+ * ReallocData
+ *
+ * Resizes the buffer's storage for new data, returning NULL if it can't. The
+ * app's memory can't be resized, so it's swapped for new storage instead,
+ * and only released if that could be allocated.
+ */
+static ALvoid *ReallocData(ALbuffer *ALBuf, ALsizei size)
+{
+    ALvoid *temp;
+
+    // Always allocate something, since reallocating to 0 bytes may free the
+    // old data.
+    if(!ALBuf->Static)
+        return realloc(ALBuf->data, max(size, 1));
+
+    temp = malloc(max(size, 1));
+    if(temp)
+        FreeData(ALBuf);
+    return temp;
+}
+
+/*
+ * FreeData
+ *
+ * Frees the buffer's storage, or hands the app's memory back to it.
+ */
+static void FreeData(ALbuffer *ALBuf)
+{
+    if(!ALBuf->Static)
+        free(ALBuf->data);
+    else if(ALBuf->Release)
+        ALBuf->Release(ALBuf->buffer, ALBuf->data, ALBuf->ReleaseParam);
+
+    ALBuf->data = NULL;
+    ALBuf->Static = AL_FALSE;
+    ALBuf->Release = NULL;
+    ALBuf->ReleaseParam = NULL;
+}
+
+/*
+ * StaticFormat
+ *
+ * Gives the format a static buffer's data is stored as, and whether it's
+ * kept as IMA4 blocks. Only formats the mixer can read as-is are usable.
+ */
+static ALenum StaticFormat(ALenum format, ALboolean *Compressed)
+{
+    *Compressed = AL_FALSE;
+    switch(format)
+    {
+        case AL_FORMAT_QUAD8_LOKI:
+            return AL_FORMAT_QUAD8;
+        case AL_FORMAT_QUAD16_LOKI:
+            return AL_FORMAT_QUAD16;
+        case AL_FORMAT_MONO_IMA4:
+            *Compressed = AL_TRUE;
+            return AL_FORMAT_MONO16;
+        case AL_FORMAT_STEREO_IMA4:
+            *Compressed = AL_TRUE;
+            return AL_FORMAT_STEREO16;
+    }
+    return format;
+}
+
+/*
+ * CheckStaticData
+ *
+ * Returns the error to set if the data can't be used in place as the
+ * buffer's storage, or AL_NO_ERROR if it can. The device must be locked.
+ */
+ALenum CheckStaticData(const ALbuffer *ALBuf, ALenum format, const ALvoid *data, ALsizei size)
+{
+    ALboolean Compressed;
+    ALenum NewFormat = StaticFormat(format, &Compressed);
+    ALuint Channels = aluChannelsFromFormat(NewFormat);
+    ALuint Bytes = aluBytesFromFormat(NewFormat);
+    ALuint FrameSize, Align;
+
+    // IMA4 blocks are kept compressed, and read a word at a time
+    FrameSize = (Compressed ? 36*Channels : Channels*Bytes);
+    Align = (Compressed ? 4 : Bytes);
+
+    // Buffer is in use, or data is a NULL pointer
+    if(ALBuf->refcount != 0 || !data)
+        return AL_INVALID_VALUE;
+    if(Channels == 0)
+        return AL_INVALID_ENUM;
+    if(size < 0 || (size%FrameSize) != 0 || ((size_t)data%Align) != 0)
+        return AL_INVALID_VALUE;
+    return AL_NO_ERROR;
+}
+
+/*
+ * SetStaticData
+ *
+ * Makes data, already checked with CheckStaticData, the buffer's storage.
+ * The buffer's old data is released first.
+ */
+ALvoid SetStaticData(ALCdevice *device, ALbuffer *ALBuf, ALenum format, const ALvoid *data, ALsizei size, ALsizei freq, ALBUFFERRELEASEPROCEXT release, ALvoid *userptr)
+{
+    ALboolean Compressed;
+    ALenum NewFormat = StaticFormat(format, &Compressed);
+
+    ALBuf->Serial = ++device->BufferSerial;
+    FreeData(ALBuf);
+
+    ALBuf->data = (ALvoid*)data;
+    ALBuf->Static = AL_TRUE;
+    ALBuf->Release = release;
+    ALBuf->ReleaseParam = userptr;
+
+    ALBuf->Compressed = Compressed;
+    ALBuf->format = NewFormat;
+    ALBuf->eOriginalFormat = format;
+    ALBuf->size = size;
+    if(Compressed)
+    {
+        ALuint Channels = aluChannelsFromFormat(NewFormat);
+        ALuint Bytes = aluBytesFromFormat(NewFormat);
+        ALBuf->size = size/(36*Channels) * 65*Channels*Bytes;
+    }
+    ALBuf->frequency = freq;
+}
+
+/* Converts len samples to a type at least as large, scaled the same way the
+ * mixer reads them, so they sound the same after widening. */
+static void ConvertData(ALvoid *dst, ALint newBytes, const ALvoid *src, ALint origBytes, ALsizei len)
 {
     ALsizei i;
-    ALint smp;
-    switch(origBytes)
+
+    if(newBytes == origBytes)
+    {
+        memcpy(dst, src, len*origBytes);
+        return;
+    }
+
+    switch(origBytes*4 + newBytes)
     {
-        case 1:
+        case 1*4 + 2:
             for(i = 0;i < len;i++)
             {
-                smp = ((ALubyte*)src)[i];
-                dst[i] = ((smp < 0x80) ? ((smp-128)/128.0f) : ((smp-128)/127.0f));
+                ALint smp = ((const ALubyte*)src)[i] - 128;
+                ((ALshort*)dst)[i] = ((smp < 0) ? smp*256 : smp*32767/127);
             }
             break;
 
-        case 2:
+        case 1*4 + 4:
             for(i = 0;i < len;i++)
             {
-                smp = ((ALshort*)src)[i];
-                dst[i] = ((smp < 0) ? (smp/32768.0f) : (smp/32767.0f));
+                ALint smp = ((const ALubyte*)src)[i] - 128;
+                ((ALfloat*)dst)[i] = ((smp < 0) ? (smp/128.0f) : (smp/127.0f));
             }
             break;
 
-        case 4:
+        case 2*4 + 4:
             for(i = 0;i < len;i++)
-                dst[i] = ((ALfloat*)src)[i];
+            {
+                ALint smp = ((const ALshort*)src)[i];
+                ((ALfloat*)dst)[i] = ((smp < 0) ? (smp/32768.0f) : (smp/32767.0f));
+            }
             break;
 
         default:
@@ -997,97 +1207,81 @@ static void ConvertData(ALfloat *dst, const ALvoid *src, ALint origBytes, ALsize
     }
 }
 
-static void ConvertDataRear(ALfloat *dst, const ALvoid *src, ALint origBytes, ALsizei len)
+/* Copies the two rear channels into the back half of each quad frame, with
+ * silence in front. The samples are widened to newBytes, and 8-bit silence
+ * is 0x80. */
+static void ConvertDataRear(ALvoid *dst, ALint newBytes, const ALvoid *src, ALint origBytes, ALsizei len)
 {
+    ALubyte *out = dst;
     ALsizei i;
-    ALint smp;
-    switch(origBytes)
-    {
-        case 1:
-            for(i = 0;i < len;i+=4)
-            {
-                dst[i+0] = 0;
-                dst[i+1] = 0;
-                smp = ((ALubyte*)src)[i/2+0];
-                dst[i+2] = ((smp < 0x80) ? ((smp-128)/128.0f) : ((smp-128)/127.0f));
-                smp = ((ALubyte*)src)[i/2+1];
-                dst[i+3] = ((smp < 0x80) ? ((smp-128)/128.0f) : ((smp-128)/127.0f));
-            }
-            break;
 
-        case 2:
-            for(i = 0;i < len;i+=4)
-            {
-                dst[i+0] = 0;
-                dst[i+1] = 0;
-                smp = ((ALshort*)src)[i/2+0];
-                dst[i+2] = ((smp < 0) ? (smp/32768.0f) : (smp/32767.0f));
-                smp = ((ALshort*)src)[i/2+1];
-                dst[i+3] = ((smp < 0) ? (smp/32768.0f) : (smp/32767.0f));
-            }
-            break;
+    for(i = 0;i < len;i+=4)
+    {
+        memset(out, ((newBytes==1) ? 0x80 : 0), 2*newBytes);
+        ConvertData(out + 2*newBytes, newBytes,
+                    (const ALubyte*)src + i/2*origBytes, origBytes, 2);
+        out += 4*newBytes;
+    }
+}
 
-        case 4:
-            for(i = 0;i < len;i+=4)
-            {
-                dst[i+0] = 0;
-                dst[i+1] = 0;
-                dst[i+2] = ((ALfloat*)src)[i/2+0];
-                dst[i+3] = ((ALfloat*)src)[i/2+1];
-            }
-            break;
+static void ConvertDataIMA4(ALshort *dst, const ALvoid *src, ALint origChans, ALsizei len)
+{
+    ALsizei i;
 
-        default:
-            assert(0);
-    }
+    for(i = 0;i < len/origChans;i++)
+        DecodeIMA4Block(&dst[i*65*origChans], (const ALubyte*)src + i*36*origChans, origChans);
 }
 
-static void ConvertDataIMA4(ALfloat *dst, const ALvoid *src, ALint origChans, ALsizei len)
+/*
+ * DecodeIMA4Block
+ *
+ * Decodes one IMA4 block of 65 sample frames (36 bytes per channel) into
+ * interleaved 16-bit samples. Blocks don't depend on each other, so the mixer
+ * can also decode compressed buffers a block at a time.
+ */
+ALvoid DecodeIMA4Block(ALshort *dst, const ALvoid *src, ALuint chans)
 {
     const ALuint *IMAData;
     ALint Sample[2],Index[2];
     ALuint IMACode[2];
-    ALsizei i,j,k,c;
+    ALuint j,k,c;
 
-    assert(origChans <= 2);
+    assert(chans <= 2);
 
     IMAData = src;
-    for(i = 0;i < len/origChans;i++)
+    for(c = 0;c < chans;c++)
     {
-        for(c = 0;c < origChans;c++)
-        {
-            Sample[c] = ((ALshort*)IMAData)[0];
-            Index[c] = ((ALshort*)IMAData)[1];
+        Sample[c] = ((ALshort*)IMAData)[0];
+        Index[c] = ((ALshort*)IMAData)[1];
 
-            Index[c] = ((Index[c]<0) ? 0 : Index[c]);
-            Index[c] = ((Index[c]>88) ? 88 : Index[c]);
+        Index[c] = ((Index[c]<0) ? 0 : Index[c]);
+        Index[c] = ((Index[c]>88) ? 88 : Index[c]);
 
-            dst[i*65*origChans + c] = ((Sample[c] < 0) ? (Sample[c]/32768.0f) : (Sample[c]/32767.0f));
+        dst[c] = Sample[c];
 
-            IMAData++;
-        }
+        IMAData++;
+    }
 
-        for(j = 1;j < 65;j += 8)
-        {
-            for(c = 0;c < origChans;c++)
-                IMACode[c] = *(IMAData++);
+    for(j = 1;j < 65;j += 8)
+    {
+        for(c = 0;c < chans;c++)
+            IMACode[c] = *(IMAData++);
 
-            for(k = 0;k < 8;k++)
+        for(k = 0;k < 8;k++)
+        {
+            for(c = 0;c < chans;c++)
             {
-                for(c = 0;c < origChans;c++)
-                {
-                    Sample[c] += ((g_IMAStep_size[Index[c]]*g_IMACodeword_4[IMACode[c]&15])/8);
-                    Index[c] += g_IMAIndex_adjust_4[IMACode[c]&15];
+                Sample[c] += ((g_IMAStep_size[Index[c]]*g_IMACodeword_4[IMACode[c]&15])/8);
+                Index[c] += g_IMAIndex_adjust_4[IMACode[c]&15];
 
-                    if(Sample[c] < -32768) Sample[c] = -32768;
-                    else if(Sample[c] > 32767) Sample[c] = 32767;
+                if(Sample[c] < -32768) Sample[c] = -32768;
+                else if(Sample[c] > 32767) Sample[c] = 32767;
 
-                    if(Index[c]<0) Index[c] = 0;
-                    else if(Index[c]>88) Index[c] = 88;
+                if(Index[c]<0) Index[c] = 0;
+                else if(Index[c]>88) Index[c] = 88;
 
-                    dst[(i*65+j+k)*origChans + c] = ((Sample[c] < 0) ? (Sample[c]/32768.0f) : (Sample[c]/32767.0f));
-                    IMACode[c] >>= 4;
-                }
+                dst[(j+k)*chans + c] = Sample[c];
+                IMACode[c] >>= 4;
             }
         }
     }
@@ -1107,13 +1301,14 @@ ALvoid ReleaseALBuffers(ALCdevice *device)
     while(ALBuffer)
     {
         // Release sample data
-        free(ALBuffer->data);
+        FreeData(ALBuffer);
 
         // Release Buffer structure
         ALBufferTemp = ALBuffer;
         ALBuffer = ALBuffer->next;
+        ALTHUNK_REMOVEENTRY(ALBufferTemp->buffer);
         memset(ALBufferTemp, 0, sizeof(ALbuffer));
-        free(ALBufferTemp);
+        PoolFree(&device->BufferPool, ALBufferTemp);
     }
     device->Buffers = NULL;
     device->BufferCount = 0;
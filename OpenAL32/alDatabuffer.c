@@ -54,28 +54,30 @@ ALvoid ALAPIENTRY alGenDatabuffersEXT(ALsizei n,ALuint *puiBuffers)
          * Databuffer Names) */
         if(!IsBadWritePtr((void*)puiBuffers, n * sizeof(ALuint)))
         {
-            ALdatabuffer **list = &device->Databuffers;
-            while(*list)
-                list = &(*list)->next;
-
             /* Create all the new Databuffers */
             while(i < n)
             {
-                *list = calloc(1, sizeof(ALdatabuffer));
-                if(!(*list))
+                ALdatabuffer *ALBuf = calloc(1, sizeof(ALdatabuffer));
+                if(ALBuf)
+                    ALBuf->databuffer = ALTHUNK_ADDENTRY(ALBuf, THUNK_DATABUFFER, device);
+                if(!ALBuf || !ALBuf->databuffer)
                 {
+                    free(ALBuf);
                     alDeleteDatabuffersEXT(i, puiBuffers);
                     alSetError(AL_OUT_OF_MEMORY);
                     break;
                 }
+                puiBuffers[i] = ALBuf->databuffer;
+                ALBuf->state = UNMAPPED;
+
+                /* The device's list isn't in any particular order */
+                ALBuf->next = device->Databuffers;
+                if(ALBuf->next)
+                    ALBuf->next->prev = ALBuf;
+                device->Databuffers = ALBuf;
 
-                puiBuffers[i] = (ALuint)ALTHUNK_ADDENTRY(*list);
-                (*list)->databuffer = puiBuffers[i];
-                (*list)->state = UNMAPPED;
                 device->DatabufferCount++;
                 i++;
-
-                list = &(*list)->next;
             }
         }
         else
@@ -140,14 +142,14 @@ ALvoid ALAPIENTRY alDeleteDatabuffersEXT(ALsizei n, const ALuint *puiBuffers)
             {
                 if(puiBuffers[i] && alIsDatabufferEXT(puiBuffers[i]))
                 {
-                    ALdatabuffer **list = &device->Databuffers;
-
                     ALBuf = (ALdatabuffer*)ALTHUNK_LOOKUPENTRY(puiBuffers[i]);
-                    while(*list && *list != ALBuf)
-                        list = &(*list)->next;
 
-                    if(*list)
-                        *list = (*list)->next;
+                    if(ALBuf->prev)
+                        ALBuf->prev->next = ALBuf->next;
+                    else
+                        device->Databuffers = ALBuf->next;
+                    if(ALBuf->next)
+                        ALBuf->next->prev = ALBuf->prev;
 
                     if(ALBuf == Context->SampleSource)
                         Context->SampleSource = NULL;
@@ -185,10 +187,8 @@ ALboolean ALAPIENTRY alIsDatabufferEXT(ALuint uiBuffer)
     Context = GetContextSuspended();
     if(!Context) return AL_FALSE;
 
-    /* Check through list of generated databuffers for uiBuffer */
-    ALBuf = Context->Device->Databuffers;
-    while(ALBuf && ALBuf->databuffer != uiBuffer)
-        ALBuf = ALBuf->next;
+    ALBuf = (ALdatabuffer*)ALTHUNK_LOOKUPOBJECT(uiBuffer, THUNK_DATABUFFER,
+                                                Context->Device);
 
     ProcessContext(Context);
 
@@ -628,6 +628,7 @@ ALvoid ReleaseALDatabuffers(ALCdevice *device)
         // Release Buffer structure
         ALBufferTemp = ALBuffer;
         ALBuffer = ALBuffer->next;
+        ALTHUNK_REMOVEENTRY(ALBufferTemp->databuffer);
         memset(ALBufferTemp, 0, sizeof(ALdatabuffer));
         free(ALBufferTemp);
     }
@@ -52,30 +52,30 @@ ALvoid AL_APIENTRY alGenEffects(ALsizei n, ALuint *effects)
         // Check that enough memory has been allocted in the 'effects' array for n Effects
         if (!IsBadWritePtr((void*)effects, n * sizeof(ALuint)))
         {
-            ALeffect **list = &device->EffectList;
-            while(*list)
-                list = &(*list)->next;
-
             i = 0;
             while(i < n)
             {
-                *list = calloc(1, sizeof(ALeffect));
-                if(!(*list))
+                ALeffect *ALEffect = PoolAlloc(&device->EffectPool);
+                if(ALEffect)
+                    ALEffect->effect = ALTHUNK_ADDENTRY(ALEffect, THUNK_EFFECT, device);
+                if(!ALEffect || !ALEffect->effect)
                 {
                     // We must have run out or memory
+                    PoolFree(&device->EffectPool, ALEffect);
                     alDeleteEffects(i, effects);
                     alSetError(AL_OUT_OF_MEMORY);
                     break;
                 }
+                effects[i] = ALEffect->effect;
 
-                effects[i] = (ALuint)ALTHUNK_ADDENTRY(*list);
-                (*list)->effect = effects[i];
+                ALEffect->next = device->EffectList;
+                if(ALEffect->next)
+                    ALEffect->next->prev = ALEffect;
+                device->EffectList = ALEffect;
 
-                InitEffectParams(*list, AL_EFFECT_NULL);
+                InitEffectParams(ALEffect, AL_EFFECT_NULL);
                 device->EffectCount++;
                 i++;
-
-                list = &(*list)->next;
             }
         }
     }
@@ -114,21 +114,18 @@ ALvoid AL_APIENTRY alDeleteEffects(ALsizei n, ALuint *effects)
                 // Recheck that the effect is valid, because there could be duplicated names
                 if (effects[i] && alIsEffect(effects[i]))
                 {
-                    ALeffect **list;
-
                     ALEffect = ((ALeffect*)ALTHUNK_LOOKUPENTRY(effects[i]));
 
-                    // Remove Source from list of Sources
-                    list = &device->EffectList;
-                    while(*list && *list != ALEffect)
-                         list = &(*list)->next;
-
-                    if(*list)
-                        *list = (*list)->next;
+                    if(ALEffect->prev)
+                        ALEffect->prev->next = ALEffect->next;
+                    else
+                        device->EffectList = ALEffect->next;
+                    if(ALEffect->next)
+                        ALEffect->next->prev = ALEffect->prev;
                     ALTHUNK_REMOVEENTRY(ALEffect->effect);
 
                     memset(ALEffect, 0, sizeof(ALeffect));
-                    free(ALEffect);
+                    PoolFree(&device->EffectPool, ALEffect);
 
                     device->EffectCount--;
                 }
@@ -144,18 +141,16 @@ ALvoid AL_APIENTRY alDeleteEffects(ALsizei n, ALuint *effects)
 ALboolean AL_APIENTRY alIsEffect(ALuint effect)
 {
     ALCcontext *Context;
-    ALeffect *list;
+    ALeffect *ALEffect;
 
     Context = GetContextSuspended();
     if(!Context) return AL_FALSE;
 
-    list = Context->Device->EffectList;
-    while(list && list->effect != effect)
-        list = list->next;
+    ALEffect = ALTHUNK_LOOKUPOBJECT(effect, THUNK_EFFECT, Context->Device);
 
     ProcessContext(Context);
 
-    return ((list || !effect) ? AL_TRUE : AL_FALSE);
+    return ((ALEffect || !effect) ? AL_TRUE : AL_FALSE);
 }
 
 ALvoid AL_APIENTRY alEffecti(ALuint effect, ALenum param, ALint iValue)
@@ -1168,10 +1163,11 @@ ALvoid ReleaseALEffects(ALCdevice *device)
     {
         ALeffect *temp = list;
         list = list->next;
+        ALTHUNK_REMOVEENTRY(temp->effect);
 
         // Release effect structure
         memset(temp, 0, sizeof(ALeffect));
-        free(temp);
+        PoolFree(&device->EffectPool, temp);
     }
     device->EffectList = NULL;
     device->EffectCount = 0;
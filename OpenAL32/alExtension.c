@@ -32,6 +32,7 @@
 #include "alDatabuffer.h"
 #include "alSource.h"
 #include "alBuffer.h"
+#include "alState.h"
 #include "AL/al.h"
 #include "AL/alc.h"
 
@@ -147,6 +148,8 @@ static ALfunction  function[]=   {
     { "alGetAuxiliaryEffectSlotfv", (ALvoid *) alGetAuxiliaryEffectSlotfv},
 
     { "alBufferSubDataEXT",         (ALvoid *) alBufferSubDataEXT        },
+    { "alBufferDataStaticEXT",      (ALvoid *) alBufferDataStaticEXT     },
+    { "alBufferDataFromBankEXT",    (ALvoid *) alBufferDataFromBankEXT   },
 
     { "alGenDatabuffersEXT",        (ALvoid *) alGenDatabuffersEXT       },
     { "alDeleteDatabuffersEXT",     (ALvoid *) alDeleteDatabuffersEXT    },
@@ -166,6 +169,12 @@ static ALfunction  function[]=   {
     { "alMapDatabufferEXT",         (ALvoid *) alMapDatabufferEXT        },
     { "alUnmapDatabufferEXT",       (ALvoid *) alUnmapDatabufferEXT      },
 
+    { "alDeferUpdatesEXT",          (ALvoid *) alDeferUpdatesEXT         },
+    { "alProcessUpdatesEXT",        (ALvoid *) alProcessUpdatesEXT       },
+
+    { "alSourcesfvEXT",             (ALvoid *) alSourcesfvEXT            },
+    { "alGetSourcesfvEXT",          (ALvoid *) alGetSourcesfvEXT         },
+
     { NULL,                         (ALvoid *) NULL                      } };
 
 static ALenums enumeration[]={
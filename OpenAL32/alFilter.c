@@ -48,30 +48,30 @@ ALvoid AL_APIENTRY alGenFilters(ALsizei n, ALuint *filters)
         // Check that enough memory has been allocted in the 'filters' array for n Filters
         if (!IsBadWritePtr((void*)filters, n * sizeof(ALuint)))
         {
-            ALfilter **list = &device->FilterList;
-            while(*list)
-                list = &(*list)->next;
-
             i = 0;
             while(i < n)
             {
-                *list = calloc(1, sizeof(ALfilter));
-                if(!(*list))
+                ALfilter *ALFilter = PoolAlloc(&device->FilterPool);
+                if(ALFilter)
+                    ALFilter->filter = ALTHUNK_ADDENTRY(ALFilter, THUNK_FILTER, device);
+                if(!ALFilter || !ALFilter->filter)
                 {
                     // We must have run out or memory
+                    PoolFree(&device->FilterPool, ALFilter);
                     alDeleteFilters(i, filters);
                     alSetError(AL_OUT_OF_MEMORY);
                     break;
                 }
+                filters[i] = ALFilter->filter;
 
-                filters[i] = (ALuint)ALTHUNK_ADDENTRY(*list);
-                (*list)->filter = filters[i];
+                ALFilter->next = device->FilterList;
+                if(ALFilter->next)
+                    ALFilter->next->prev = ALFilter;
+                device->FilterList = ALFilter;
 
-                InitFilterParams(*list, AL_FILTER_NULL);
+                InitFilterParams(ALFilter, AL_FILTER_NULL);
                 device->FilterCount++;
                 i++;
-
-                list = &(*list)->next;
             }
         }
     }
@@ -110,21 +110,18 @@ ALvoid AL_APIENTRY alDeleteFilters(ALsizei n, ALuint *filters)
                 // Recheck that the filter is valid, because there could be duplicated names
                 if (filters[i] && alIsFilter(filters[i]))
                 {
-                    ALfilter **list;
-
                     ALFilter = ((ALfilter*)ALTHUNK_LOOKUPENTRY(filters[i]));
 
-                    // Remove Source from list of Sources
-                    list = &device->FilterList;
-                    while(*list && *list != ALFilter)
-                         list = &(*list)->next;
-
-                    if(*list)
-                        *list = (*list)->next;
+                    if(ALFilter->prev)
+                        ALFilter->prev->next = ALFilter->next;
+                    else
+                        device->FilterList = ALFilter->next;
+                    if(ALFilter->next)
+                        ALFilter->next->prev = ALFilter->prev;
                     ALTHUNK_REMOVEENTRY(ALFilter->filter);
 
                     memset(ALFilter, 0, sizeof(ALfilter));
-                    free(ALFilter);
+                    PoolFree(&device->FilterPool, ALFilter);
 
                     device->FilterCount--;
                 }
@@ -140,18 +137,16 @@ ALvoid AL_APIENTRY alDeleteFilters(ALsizei n, ALuint *filters)
 ALboolean AL_APIENTRY alIsFilter(ALuint filter)
 {
     ALCcontext *Context;
-    ALfilter *list;
+    ALfilter *ALFilter;
 
     Context = GetContextSuspended();
     if(!Context) return AL_FALSE;
 
-    list = Context->Device->FilterList;
-    while(list && list->filter != filter)
-        list = list->next;
+    ALFilter = ALTHUNK_LOOKUPOBJECT(filter, THUNK_FILTER, Context->Device);
 
     ProcessContext(Context);
 
-    return ((list || !filter) ? AL_TRUE : AL_FALSE);
+    return ((ALFilter || !filter) ? AL_TRUE : AL_FALSE);
 }
 
 ALvoid AL_APIENTRY alFilteri(ALuint filter, ALenum param, ALint iValue)
@@ -406,10 +401,11 @@ ALvoid ReleaseALFilters(ALCdevice *device)
     {
         ALfilter *temp = list;
         list = list->next;
+        ALTHUNK_REMOVEENTRY(temp->filter);
 
         // Release filter structure
         memset(temp, 0, sizeof(ALfilter));
-        free(temp);
+        PoolFree(&device->FilterPool, temp);
     }
     device->FilterList = NULL;
     device->FilterCount = 0;
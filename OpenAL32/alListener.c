@@ -25,21 +25,33 @@
 #include "alError.h"
 #include "alListener.h"
 #include "alSource.h"
+#include "alu.h"
+
+/* Changes made while updates are deferred, and what's read back meanwhile,
+ * go to a copy of the listener that alProcessUpdatesEXT applies */
+static __inline ALlistener *GetListener(ALCcontext *pContext)
+{
+    if(pContext->DeferUpdates)
+        return &pContext->DeferredListener;
+    return &pContext->Listener;
+}
 
 ALAPI ALvoid ALAPIENTRY alListenerf(ALenum eParam, ALfloat flValue)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
     ALboolean updateAll = AL_FALSE;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     switch(eParam)
     {
         case AL_GAIN:
             if(flValue >= 0.0f)
             {
-                pContext->Listener.Gain = flValue;
+                Listener->Gain = flValue;
                 updateAll = AL_TRUE;
             }
             else
@@ -49,7 +61,7 @@ ALAPI ALvoid ALAPIENTRY alListenerf(ALenum eParam, ALfloat flValue)
         case AL_METERS_PER_UNIT:
             if(flValue > 0.0f)
             {
-                pContext->Listener.MetersPerUnit = flValue;
+                Listener->MetersPerUnit = flValue;
                 updateAll = AL_TRUE;
             }
             else
@@ -63,7 +75,9 @@ ALAPI ALvoid ALAPIENTRY alListenerf(ALenum eParam, ALfloat flValue)
 
     // Force updating the sources for these parameters, since even head-
     // relative sources are affected
-    if(updateAll)
+    if(updateAll && pContext->DeferUpdates)
+        pContext->UpdateSources = AL_TRUE;
+    else if(updateAll)
     {
         ALsource *source = pContext->Source;
         while(source)
@@ -80,24 +94,26 @@ ALAPI ALvoid ALAPIENTRY alListenerf(ALenum eParam, ALfloat flValue)
 ALAPI ALvoid ALAPIENTRY alListener3f(ALenum eParam, ALfloat flValue1, ALfloat flValue2, ALfloat flValue3)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
     ALboolean updateWorld = AL_FALSE;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     switch(eParam)
     {
         case AL_POSITION:
-            pContext->Listener.Position[0] = flValue1;
-            pContext->Listener.Position[1] = flValue2;
-            pContext->Listener.Position[2] = flValue3;
+            Listener->Position[0] = flValue1;
+            Listener->Position[1] = flValue2;
+            Listener->Position[2] = flValue3;
             updateWorld = AL_TRUE;
             break;
 
         case AL_VELOCITY:
-            pContext->Listener.Velocity[0] = flValue1;
-            pContext->Listener.Velocity[1] = flValue2;
-            pContext->Listener.Velocity[2] = flValue3;
+            Listener->Velocity[0] = flValue1;
+            Listener->Velocity[1] = flValue2;
+            Listener->Velocity[2] = flValue3;
             updateWorld = AL_TRUE;
             break;
 
@@ -106,9 +122,13 @@ ALAPI ALvoid ALAPIENTRY alListener3f(ALenum eParam, ALfloat flValue1, ALfloat fl
             break;
     }
 
-    if(updateWorld)
+    if(updateWorld && pContext->DeferUpdates)
+        pContext->UpdateSources = AL_TRUE;
+    else if(updateWorld)
     {
         ALsource *source = pContext->Source;
+
+        aluUpdateListener(pContext);
         while(source)
         {
             if(!source->bHeadRelative)
@@ -124,10 +144,12 @@ ALAPI ALvoid ALAPIENTRY alListener3f(ALenum eParam, ALfloat flValue1, ALfloat fl
 ALAPI ALvoid ALAPIENTRY alListenerfv(ALenum eParam, const ALfloat *pflValues)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
     ALboolean updateWorld = AL_FALSE;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     if(pflValues)
     {
@@ -145,12 +167,12 @@ ALAPI ALvoid ALAPIENTRY alListenerfv(ALenum eParam, const ALfloat *pflValues)
 
             case AL_ORIENTATION:
                 // AT then UP
-                pContext->Listener.Forward[0] = pflValues[0];
-                pContext->Listener.Forward[1] = pflValues[1];
-                pContext->Listener.Forward[2] = pflValues[2];
-                pContext->Listener.Up[0] = pflValues[3];
-                pContext->Listener.Up[1] = pflValues[4];
-                pContext->Listener.Up[2] = pflValues[5];
+                Listener->Forward[0] = pflValues[0];
+                Listener->Forward[1] = pflValues[1];
+                Listener->Forward[2] = pflValues[2];
+                Listener->Up[0] = pflValues[3];
+                Listener->Up[1] = pflValues[4];
+                Listener->Up[2] = pflValues[5];
                 updateWorld = AL_TRUE;
                 break;
 
@@ -162,9 +184,13 @@ ALAPI ALvoid ALAPIENTRY alListenerfv(ALenum eParam, const ALfloat *pflValues)
     else
         alSetError(AL_INVALID_VALUE);
 
-    if(updateWorld)
+    if(updateWorld && pContext->DeferUpdates)
+        pContext->UpdateSources = AL_TRUE;
+    else if(updateWorld)
     {
         ALsource *source = pContext->Source;
+
+        aluUpdateListener(pContext);
         while(source)
         {
             if(!source->bHeadRelative)
@@ -265,20 +291,22 @@ ALAPI void ALAPIENTRY alListeneriv( ALenum eParam, const ALint* plValues )
 ALAPI ALvoid ALAPIENTRY alGetListenerf(ALenum eParam, ALfloat *pflValue)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     if(pflValue)
     {
         switch(eParam)
         {
             case AL_GAIN:
-                *pflValue = pContext->Listener.Gain;
+                *pflValue = Listener->Gain;
                 break;
 
             case AL_METERS_PER_UNIT:
-                *pflValue = pContext->Listener.MetersPerUnit;
+                *pflValue = Listener->MetersPerUnit;
                 break;
 
             default:
@@ -296,24 +324,26 @@ ALAPI ALvoid ALAPIENTRY alGetListenerf(ALenum eParam, ALfloat *pflValue)
 ALAPI ALvoid ALAPIENTRY alGetListener3f(ALenum eParam, ALfloat *pflValue1, ALfloat *pflValue2, ALfloat *pflValue3)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     if(pflValue1 && pflValue2 && pflValue3)
     {
         switch(eParam)
         {
             case AL_POSITION:
-                *pflValue1 = pContext->Listener.Position[0];
-                *pflValue2 = pContext->Listener.Position[1];
-                *pflValue3 = pContext->Listener.Position[2];
+                *pflValue1 = Listener->Position[0];
+                *pflValue2 = Listener->Position[1];
+                *pflValue3 = Listener->Position[2];
                 break;
 
             case AL_VELOCITY:
-                *pflValue1 = pContext->Listener.Velocity[0];
-                *pflValue2 = pContext->Listener.Velocity[1];
-                *pflValue3 = pContext->Listener.Velocity[2];
+                *pflValue1 = Listener->Velocity[0];
+                *pflValue2 = Listener->Velocity[1];
+                *pflValue3 = Listener->Velocity[2];
                 break;
 
             default:
@@ -331,42 +361,44 @@ ALAPI ALvoid ALAPIENTRY alGetListener3f(ALenum eParam, ALfloat *pflValue1, ALflo
 ALAPI ALvoid ALAPIENTRY alGetListenerfv(ALenum eParam, ALfloat *pflValues)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     if(pflValues)
     {
         switch(eParam)
         {
             case AL_GAIN:
-                pflValues[0] = pContext->Listener.Gain;
+                pflValues[0] = Listener->Gain;
                 break;
 
             case AL_METERS_PER_UNIT:
-                pflValues[0] = pContext->Listener.MetersPerUnit;
+                pflValues[0] = Listener->MetersPerUnit;
                 break;
 
             case AL_POSITION:
-                pflValues[0] = pContext->Listener.Position[0];
-                pflValues[1] = pContext->Listener.Position[1];
-                pflValues[2] = pContext->Listener.Position[2];
+                pflValues[0] = Listener->Position[0];
+                pflValues[1] = Listener->Position[1];
+                pflValues[2] = Listener->Position[2];
                 break;
 
             case AL_VELOCITY:
-                pflValues[0] = pContext->Listener.Velocity[0];
-                pflValues[1] = pContext->Listener.Velocity[1];
-                pflValues[2] = pContext->Listener.Velocity[2];
+                pflValues[0] = Listener->Velocity[0];
+                pflValues[1] = Listener->Velocity[1];
+                pflValues[2] = Listener->Velocity[2];
                 break;
 
             case AL_ORIENTATION:
                 // AT then UP
-                pflValues[0] = pContext->Listener.Forward[0];
-                pflValues[1] = pContext->Listener.Forward[1];
-                pflValues[2] = pContext->Listener.Forward[2];
-                pflValues[3] = pContext->Listener.Up[0];
-                pflValues[4] = pContext->Listener.Up[1];
-                pflValues[5] = pContext->Listener.Up[2];
+                pflValues[0] = Listener->Forward[0];
+                pflValues[1] = Listener->Forward[1];
+                pflValues[2] = Listener->Forward[2];
+                pflValues[3] = Listener->Up[0];
+                pflValues[4] = Listener->Up[1];
+                pflValues[5] = Listener->Up[2];
                 break;
 
             default:
@@ -407,24 +439,26 @@ ALAPI ALvoid ALAPIENTRY alGetListeneri(ALenum eParam, ALint *plValue)
 ALAPI void ALAPIENTRY alGetListener3i(ALenum eParam, ALint *plValue1, ALint *plValue2, ALint *plValue3)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     if(plValue1 && plValue2 && plValue3)
     {
         switch (eParam)
         {
             case AL_POSITION:
-                *plValue1 = (ALint)pContext->Listener.Position[0];
-                *plValue2 = (ALint)pContext->Listener.Position[1];
-                *plValue3 = (ALint)pContext->Listener.Position[2];
+                *plValue1 = (ALint)Listener->Position[0];
+                *plValue2 = (ALint)Listener->Position[1];
+                *plValue3 = (ALint)Listener->Position[2];
                 break;
 
             case AL_VELOCITY:
-                *plValue1 = (ALint)pContext->Listener.Velocity[0];
-                *plValue2 = (ALint)pContext->Listener.Velocity[1];
-                *plValue3 = (ALint)pContext->Listener.Velocity[2];
+                *plValue1 = (ALint)Listener->Velocity[0];
+                *plValue2 = (ALint)Listener->Velocity[1];
+                *plValue3 = (ALint)Listener->Velocity[2];
                 break;
 
             default:
@@ -442,34 +476,36 @@ ALAPI void ALAPIENTRY alGetListener3i(ALenum eParam, ALint *plValue1, ALint *plV
 ALAPI void ALAPIENTRY alGetListeneriv(ALenum eParam, ALint* plValues)
 {
     ALCcontext *pContext;
+    ALlistener *Listener;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    Listener = GetListener(pContext);
 
     if(plValues)
     {
         switch(eParam)
         {
             case AL_POSITION:
-                plValues[0] = (ALint)pContext->Listener.Position[0];
-                plValues[1] = (ALint)pContext->Listener.Position[1];
-                plValues[2] = (ALint)pContext->Listener.Position[2];
+                plValues[0] = (ALint)Listener->Position[0];
+                plValues[1] = (ALint)Listener->Position[1];
+                plValues[2] = (ALint)Listener->Position[2];
                 break;
 
             case AL_VELOCITY:
-                plValues[0] = (ALint)pContext->Listener.Velocity[0];
-                plValues[1] = (ALint)pContext->Listener.Velocity[1];
-                plValues[2] = (ALint)pContext->Listener.Velocity[2];
+                plValues[0] = (ALint)Listener->Velocity[0];
+                plValues[1] = (ALint)Listener->Velocity[1];
+                plValues[2] = (ALint)Listener->Velocity[2];
                 break;
 
             case AL_ORIENTATION:
                 // AT then UP
-                plValues[0] = (ALint)pContext->Listener.Forward[0];
-                plValues[1] = (ALint)pContext->Listener.Forward[1];
-                plValues[2] = (ALint)pContext->Listener.Forward[2];
-                plValues[3] = (ALint)pContext->Listener.Up[0];
-                plValues[4] = (ALint)pContext->Listener.Up[1];
-                plValues[5] = (ALint)pContext->Listener.Up[2];
+                plValues[0] = (ALint)Listener->Forward[0];
+                plValues[1] = (ALint)Listener->Forward[1];
+                plValues[2] = (ALint)Listener->Forward[2];
+                plValues[3] = (ALint)Listener->Up[0];
+                plValues[4] = (ALint)Listener->Up[1];
+                plValues[5] = (ALint)Listener->Up[2];
                 break;
 
             default:
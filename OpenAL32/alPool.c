@@ -0,0 +1,96 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+
+#include "alMain.h"
+#include "alPool.h"
+
+/* Objects are kept as aligned as malloc would give them. Each slab starts
+ * with a pointer to the next slab, padded out to the same alignment, and a
+ * free object holds a pointer to the next free object. */
+#define POOL_ALIGN  16
+#define POOL_ROUND(x)  (((x)+POOL_ALIGN-1) & ~(POOL_ALIGN-1))
+
+ALvoid InitPool(ALpool *pool, ALuint objSize, ALuint slabObjs)
+{
+    pool->ObjSize = POOL_ROUND(objSize);
+    pool->SlabObjs = slabObjs;
+    pool->FreeList = NULL;
+    pool->Slabs = NULL;
+    pool->Hits = 0;
+    pool->Misses = 0;
+}
+
+ALvoid DestroyPool(ALpool *pool)
+{
+    while(pool->Slabs)
+    {
+        ALvoid *next = *(ALvoid**)pool->Slabs;
+        free(pool->Slabs);
+        pool->Slabs = next;
+    }
+    pool->FreeList = NULL;
+}
+
+/* Returns a zeroed object, or NULL if a new slab couldn't be allocated */
+ALvoid *PoolAlloc(ALpool *pool)
+{
+    ALvoid *obj;
+
+    if(pool->FreeList)
+        pool->Hits++;
+    else
+    {
+        ALubyte *slab;
+        ALuint i;
+
+        slab = malloc(POOL_ROUND(sizeof(ALvoid*)) +
+                      (size_t)pool->ObjSize*pool->SlabObjs);
+        if(!slab)
+            return NULL;
+        *(ALvoid**)slab = pool->Slabs;
+        pool->Slabs = slab;
+
+        slab += POOL_ROUND(sizeof(ALvoid*));
+        for(i = pool->SlabObjs;i > 0;i--)
+        {
+            ALvoid *newobj = slab + (size_t)pool->ObjSize*(i-1);
+            *(ALvoid**)newobj = pool->FreeList;
+            pool->FreeList = newobj;
+        }
+        pool->Misses++;
+    }
+
+    obj = pool->FreeList;
+    pool->FreeList = *(ALvoid**)obj;
+    memset(obj, 0, pool->ObjSize);
+    return obj;
+}
+
+ALvoid PoolFree(ALpool *pool, ALvoid *obj)
+{
+    if(!obj)
+        return;
+    *(ALvoid**)obj = pool->FreeList;
+    pool->FreeList = obj;
+}
@@ -0,0 +1,298 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 1999-2007 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ *  Boston, MA  02111-1307, USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "alMain.h"
+#include "AL/al.h"
+#include "AL/alc.h"
+#include "AL/alext.h"
+#include "alError.h"
+#include "alBuffer.h"
+#include "alThunk.h"
+
+#ifndef _WIN32
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#endif
+
+
+/*
+ * A sound bank is a file of sample data that can be played straight from a
+ * read-only mapping of it. Everything in it is little-endian:
+ *
+ *   ALubyte  magic[4];     "ALSB"
+ *   ALuint   version;      1
+ *   ALuint   count;        number of entries
+ *   struct {
+ *       ALuint format;     an AL_FORMAT_* value (not the REAR formats)
+ *       ALuint frequency;
+ *       ALuint offset;     from the start of the file
+ *       ALuint size;       in bytes
+ *   } entries[count];
+ *
+ * followed by the entries' data. Each entry's data must be a whole number of
+ * sample frames (or 36-byte-per-channel IMA4 blocks), starting at an offset
+ * that's a multiple of the sample size (or of 4 for IMA4).
+ */
+#define BANK_HEADER_SIZE  12
+#define BANK_ENTRY_SIZE   16
+#define BANK_VERSION      1
+
+typedef struct ALsoundbank
+{
+    const ALubyte *base;
+    size_t length;
+
+    // Number of buffers still using the mapping
+    ALuint refcount;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE map;
+#endif
+} ALsoundbank;
+
+
+static ALuint ReadLE32(const ALubyte *ptr)
+{
+    return  (ALuint)ptr[0]      | ((ALuint)ptr[1]<<8) |
+           ((ALuint)ptr[2]<<16) | ((ALuint)ptr[3]<<24);
+}
+
+#ifdef _WIN32
+static ALenum MapBank(ALsoundbank *bank, const ALchar *filename)
+{
+    LARGE_INTEGER fsize;
+
+    bank->file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(bank->file == INVALID_HANDLE_VALUE)
+        return AL_INVALID_VALUE;
+    if(!GetFileSizeEx(bank->file, &fsize) || fsize.QuadPart < BANK_HEADER_SIZE ||
+       (ULONGLONG)fsize.QuadPart > (size_t)-1)
+    {
+        CloseHandle(bank->file);
+        return AL_INVALID_VALUE;
+    }
+    bank->length = (size_t)fsize.QuadPart;
+
+    bank->map = CreateFileMappingA(bank->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(bank->map)
+        bank->base = MapViewOfFile(bank->map, FILE_MAP_READ, 0, 0, 0);
+    if(!bank->map || !bank->base)
+    {
+        if(bank->map)
+            CloseHandle(bank->map);
+        CloseHandle(bank->file);
+        return AL_OUT_OF_MEMORY;
+    }
+    return AL_NO_ERROR;
+}
+
+static void UnmapBank(ALsoundbank *bank)
+{
+    UnmapViewOfFile(bank->base);
+    CloseHandle(bank->map);
+    CloseHandle(bank->file);
+}
+#elif defined(HAVE_MMAP)
+static ALenum MapBank(ALsoundbank *bank, const ALchar *filename)
+{
+    struct stat st;
+    void *ptr;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if(fd == -1)
+        return AL_INVALID_VALUE;
+    if(fstat(fd, &st) != 0 || st.st_size < BANK_HEADER_SIZE ||
+       (unsigned long long)st.st_size > (size_t)-1)
+    {
+        close(fd);
+        return AL_INVALID_VALUE;
+    }
+    bank->length = (size_t)st.st_size;
+
+    // Pages are only read in once the mixer first touches them, and are
+    // shared with anything else mapping or caching the same file
+    ptr = mmap(NULL, bank->length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(ptr == MAP_FAILED)
+        return AL_OUT_OF_MEMORY;
+    bank->base = ptr;
+    return AL_NO_ERROR;
+}
+
+static void UnmapBank(ALsoundbank *bank)
+{
+    munmap((void*)bank->base, bank->length);
+}
+#else
+static ALenum MapBank(ALsoundbank *bank, const ALchar *filename)
+{
+    (void)bank;
+    (void)filename;
+    // No way to map files here
+    return AL_INVALID_OPERATION;
+}
+
+static void UnmapBank(ALsoundbank *bank)
+{
+    (void)bank;
+}
+#endif
+
+/* Release callback for buffers playing from a bank. Called with the device
+ * locked, which keeps the count safe. */
+static ALvoid AL_APIENTRY ReleaseBankData(ALuint buffer, const ALvoid *data, ALvoid *userptr)
+{
+    ALsoundbank *bank = userptr;
+    (void)buffer;
+    (void)data;
+
+    if(--bank->refcount == 0)
+    {
+        UnmapBank(bank);
+        free(bank);
+    }
+}
+
+
+/*
+*    alBufferDataFromBankEXT(const ALchar *filename,ALsizei n,const ALuint *buffers)
+*
+*    Maps the sound bank file and gives each of the n buffers the data of the
+*    matching entry, the way alBufferDataStaticEXT would. The data isn't read
+*    or copied until it's played, and the mapping stays open until the last
+*    of the buffers is given other data or deleted. Nothing is changed if any
+*    buffer or entry can't be used.
+*/
+ALvoid ALAPIENTRY alBufferDataFromBankEXT(const ALchar *filename,ALsizei n,const ALuint *buffers)
+{
+    static const union { ALuint u; ALubyte b[4]; } EndianTest = { 1 };
+    ALCcontext *Context;
+    ALsoundbank *bank;
+    const ALubyte *entry;
+    ALuint count;
+    ALenum err;
+    ALsizei i;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    if(n < 0 || (n > 0 && (!filename || !buffers)))
+    {
+        alSetError(AL_INVALID_VALUE);
+        ProcessContext(Context);
+        return;
+    }
+    for(i = 0;i < n;i++)
+    {
+        if(!alIsBuffer(buffers[i]) || buffers[i] == 0)
+        {
+            alSetError(AL_INVALID_NAME);
+            ProcessContext(Context);
+            return;
+        }
+    }
+    if(Context->SampleSource || EndianTest.b[0] != 1)
+    {
+        // a databuffer's storage isn't the app's to give, and samples aren't
+        // swapped for big-endian systems
+        alSetError(AL_INVALID_OPERATION);
+        ProcessContext(Context);
+        return;
+    }
+    if(n == 0)
+    {
+        ProcessContext(Context);
+        return;
+    }
+
+    bank = calloc(1, sizeof(ALsoundbank));
+    if(!bank)
+    {
+        alSetError(AL_OUT_OF_MEMORY);
+        ProcessContext(Context);
+        return;
+    }
+    if((err=MapBank(bank, filename)) != AL_NO_ERROR)
+    {
+        free(bank);
+        alSetError(err);
+        ProcessContext(Context);
+        return;
+    }
+
+    // Check the whole request before touching any buffer
+    err = AL_NO_ERROR;
+    count = ReadLE32(bank->base+8);
+    if(memcmp(bank->base, "ALSB", 4) != 0 ||
+       ReadLE32(bank->base+4) != BANK_VERSION ||
+       (ALuint)n > count ||
+       count > (bank->length-BANK_HEADER_SIZE) / BANK_ENTRY_SIZE)
+        err = AL_INVALID_VALUE;
+    for(i = 0;i < n && err == AL_NO_ERROR;i++)
+    {
+        ALbuffer *ALBuf = (ALbuffer*)ALTHUNK_LOOKUPENTRY(buffers[i]);
+        ALuint offset, size;
+
+        entry = bank->base + BANK_HEADER_SIZE + i*BANK_ENTRY_SIZE;
+        offset = ReadLE32(entry+8);
+        size = ReadLE32(entry+12);
+        if(offset > bank->length || size > bank->length-offset ||
+           size > (ALuint)INT_MAX)
+            err = AL_INVALID_VALUE;
+        else
+            err = CheckStaticData(ALBuf, (ALenum)ReadLE32(entry),
+                                  bank->base+offset, (ALsizei)size);
+    }
+    if(err != AL_NO_ERROR)
+    {
+        UnmapBank(bank);
+        free(bank);
+        alSetError(err);
+        ProcessContext(Context);
+        return;
+    }
+
+    bank->refcount = n;
+    for(i = 0;i < n;i++)
+    {
+        ALbuffer *ALBuf = (ALbuffer*)ALTHUNK_LOOKUPENTRY(buffers[i]);
+
+        entry = bank->base + BANK_HEADER_SIZE + i*BANK_ENTRY_SIZE;
+        SetStaticData(Context->Device, ALBuf, (ALenum)ReadLE32(entry),
+                      bank->base+ReadLE32(entry+8), (ALsizei)ReadLE32(entry+12),
+                      (ALsizei)ReadLE32(entry+4), ReleaseBankData, bank);
+    }
+
+    ProcessContext(Context);
+}
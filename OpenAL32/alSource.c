@@ -33,9 +33,59 @@
 #include "alAuxEffectSlot.h"
 
 static ALvoid InitSourceParams(ALsource *pSource);
+static ALvoid SetSourceOffset(ALuint source, ALenum eParam, ALfloat flValue);
+static ALsource *LookupSource(ALCcontext *Context, ALuint source);
+static ALenum SetSourcefProp(ALsource *pSource, ALenum eParam, ALfloat flValue);
+static ALenum SetSource3fProp(ALsource *pSource, ALenum eParam, ALfloat flValue1, ALfloat flValue2, ALfloat flValue3);
+static ALenum GetSourcefProp(ALsource *pSource, ALenum eParam, ALfloat *pflValue, ALuint updateSize);
+static ALenum GetSource3fProp(ALsource *pSource, ALenum eParam, ALfloat *pflValues);
+static ALvoid CommitSourceProps(ALCcontext *pContext, ALsource *pSource);
+static ALvoid PublishSourceProps(ALsource *pSource);
 static ALboolean GetSourceOffset(ALsource *pSource, ALenum eName, ALfloat *pflOffset, ALuint updateSize);
 static ALboolean ApplyOffset(ALsource *pSource);
-static ALint GetByteOffset(ALsource *pSource);
+static ALint GetByteOffset(const ALsource *pSource, ALint lOffsetType, ALint lOffset);
+
+static __inline ALuint GetItemSize(const ALbufferlistitem *item)
+{
+    return (item->buffer ? item->buffer->size : 0);
+}
+
+// Total bytes of all the buffers in the source's queue
+static __inline ALuint GetQueueSize(const ALsource *pSource)
+{
+    if(!pSource->queue)
+        return 0;
+    return pSource->QueueTail->Start + GetItemSize(pSource->QueueTail) -
+           pSource->queue->Start;
+}
+
+// Makes room in the queue index for n more items after the queued ones.
+// The index is left as it was if there's no memory.
+static ALboolean ReserveQueueIndex(ALsource *pSource, ALuint n)
+{
+    ALbufferlistitem **temp;
+    ALuint count = pSource->BuffersInQueue;
+    ALuint size;
+
+    if(pSource->QueueIndexHead+count+n <= pSource->QueueIndexSize)
+        return AL_TRUE;
+
+    // Keep at least half the index free after moving the queued items to
+    // the front, so unqueued entries don't get moved on every call
+    if((count+n)*2 > pSource->QueueIndexSize)
+    {
+        size = NextPowerOf2((count+n)*2);
+        temp = realloc(pSource->QueueIndex, size * sizeof(*temp));
+        if(!temp)
+            return AL_FALSE;
+        pSource->QueueIndex = temp;
+        pSource->QueueIndexSize = size;
+    }
+    memmove(pSource->QueueIndex, pSource->QueueIndex+pSource->QueueIndexHead,
+            count * sizeof(*pSource->QueueIndex));
+    pSource->QueueIndexHead = 0;
+    return AL_TRUE;
+}
 
 ALAPI ALvoid ALAPIENTRY alGenSources(ALsizei n,ALuint *sources)
 {
@@ -45,6 +95,7 @@ ALAPI ALvoid ALAPIENTRY alGenSources(ALsizei n,ALuint *sources)
 
     Context = GetContextSuspended();
     if(!Context) return;
+    LockProps();
 
     if(n > 0)
     {
@@ -56,29 +107,32 @@ ALAPI ALvoid ALAPIENTRY alGenSources(ALsizei n,ALuint *sources)
             // Check that the requested number of sources can be generated
             if((Context->SourceCount + n) <= Device->MaxNoOfSources)
             {
-                ALsource **list = &Context->Source;
-                while(*list)
-                    list = &(*list)->next;
-
-                // Add additional sources to the list (Source->next points to the location for the next Source structure)
+                // Add additional sources to the end of the list, so they're mixed in the order they were made
                 while(i < n)
                 {
-                    *list = calloc(1, sizeof(ALsource));
-                    if(!(*list))
+                    ALsource *ALSource = PoolAlloc(&Context->SourcePool);
+                    if(ALSource)
+                        ALSource->source = ALTHUNK_ADDENTRY(ALSource, THUNK_SOURCE, Context);
+                    if(!ALSource || !ALSource->source)
                     {
+                        PoolFree(&Context->SourcePool, ALSource);
                         alDeleteSources(i, sources);
                         alSetError(AL_OUT_OF_MEMORY);
                         break;
                     }
+                    sources[i] = ALSource->source;
+
+                    InitSourceParams(ALSource);
 
-                    sources[i] = (ALuint)ALTHUNK_ADDENTRY(*list);
-                    (*list)->source = sources[i];
+                    ALSource->prev = Context->SourceTail;
+                    if(ALSource->prev)
+                        ALSource->prev->next = ALSource;
+                    else
+                        Context->Source = ALSource;
+                    Context->SourceTail = ALSource;
 
-                    InitSourceParams(*list);
                     Context->SourceCount++;
                     i++;
-
-                    list = &(*list)->next;
                 }
             }
             else
@@ -94,6 +148,7 @@ ALAPI ALvoid ALAPIENTRY alGenSources(ALsizei n,ALuint *sources)
         }
     }
 
+    UnlockProps();
     ProcessContext(Context);
 }
 
@@ -103,13 +158,13 @@ ALAPI ALvoid ALAPIENTRY alDeleteSources(ALsizei n, const ALuint *sources)
     ALCcontext *Context;
     ALCdevice  *Device;
     ALsource *ALSource;
-    ALsource **list;
     ALsizei i, j;
     ALbufferlistitem *ALBufferList;
     ALboolean bSourcesValid = AL_TRUE;
 
     Context = GetContextSuspended();
     if(!Context) return;
+    LockProps();
 
     if(n >= 0)
     {
@@ -147,8 +202,9 @@ ALAPI ALvoid ALAPIENTRY alDeleteSources(ALsizei n, const ALuint *sources)
                         // Update queue to point to next element in list
                         ALSource->queue = ALBufferList->next;
                         // Release memory allocated for buffer list item
-                        free(ALBufferList);
+                        PoolFree(&Context->BufferListPool, ALBufferList);
                     }
+                    free(ALSource->QueueIndex);
 
                     for(j = 0;j < MAX_SENDS;++j)
                     {
@@ -161,16 +217,18 @@ ALAPI ALvoid ALAPIENTRY alDeleteSources(ALsizei n, const ALuint *sources)
                     Context->SourceCount--;
 
                     // Remove Source from list of Sources
-                    list = &Context->Source;
-                    while(*list && *list != ALSource)
-                        list = &(*list)->next;
-
-                    if(*list)
-                        *list = (*list)->next;
+                    if(ALSource->prev)
+                        ALSource->prev->next = ALSource->next;
+                    else
+                        Context->Source = ALSource->next;
+                    if(ALSource->next)
+                        ALSource->next->prev = ALSource->prev;
+                    else
+                        Context->SourceTail = ALSource->prev;
                     ALTHUNK_REMOVEENTRY(ALSource->source);
 
                     memset(ALSource,0,sizeof(ALsource));
-                    free(ALSource);
+                    PoolFree(&Context->SourcePool, ALSource);
                 }
             }
         }
@@ -178,6 +236,7 @@ ALAPI ALvoid ALAPIENTRY alDeleteSources(ALsizei n, const ALuint *sources)
     else
         alSetError(AL_INVALID_VALUE);
 
+    UnlockProps();
     ProcessContext(Context);
 }
 
@@ -186,23 +245,12 @@ ALAPI ALboolean ALAPIENTRY alIsSource(ALuint source)
 {
     ALboolean result=AL_FALSE;
     ALCcontext *Context;
-    ALsource *Source;
 
     Context = GetContextSuspended();
     if(!Context) return AL_FALSE;
 
-    // To determine if this is a valid Source name, look through the list of generated Sources
-    Source = Context->Source;
-    while(Source)
-    {
-        if(Source->source == source)
-        {
-            result = AL_TRUE;
-            break;
-        }
-
-        Source = Source->next;
-    }
+    if(LookupSource(Context, source))
+        result = AL_TRUE;
 
     ProcessContext(Context);
 
@@ -214,193 +262,35 @@ ALAPI ALvoid ALAPIENTRY alSourcef(ALuint source, ALenum eParam, ALfloat flValue)
 {
     ALCcontext    *pContext;
     ALsource    *pSource;
+    ALenum      err;
 
-    pContext = GetContextSuspended();
-    if(!pContext) return;
-
-    if(alIsSource(source))
+    if(eParam == AL_SEC_OFFSET || eParam == AL_SAMPLE_OFFSET ||
+       eParam == AL_BYTE_OFFSET)
     {
-        pSource = (ALsource*)ALTHUNK_LOOKUPENTRY(source);
-
-        switch(eParam)
-        {
-            case AL_PITCH:
-                if(flValue >= 0.0f)
-                {
-                    pSource->flPitch = flValue;
-                    if(pSource->flPitch < 0.001f)
-                        pSource->flPitch = 0.001f;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_CONE_INNER_ANGLE:
-                if(flValue >= 0.0f && flValue <= 360.0f)
-                {
-                    pSource->flInnerAngle = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_CONE_OUTER_ANGLE:
-                if(flValue >= 0.0f && flValue <= 360.0f)
-                {
-                    pSource->flOuterAngle = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_GAIN:
-                if(flValue >= 0.0f)
-                {
-                    pSource->flGain = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_MAX_DISTANCE:
-                if(flValue >= 0.0f)
-                {
-                    pSource->flMaxDistance = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_ROLLOFF_FACTOR:
-                if(flValue >= 0.0f)
-                {
-                    pSource->flRollOffFactor = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_REFERENCE_DISTANCE:
-                if(flValue >= 0.0f)
-                {
-                    pSource->flRefDistance = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_MIN_GAIN:
-                if(flValue >= 0.0f && flValue <= 1.0f)
-                {
-                    pSource->flMinGain = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_MAX_GAIN:
-                if(flValue >= 0.0f && flValue <= 1.0f)
-                {
-                    pSource->flMaxGain = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_CONE_OUTER_GAIN:
-                if(flValue >= 0.0f && flValue <= 1.0f)
-                {
-                    pSource->flOuterGain = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_CONE_OUTER_GAINHF:
-                if(flValue >= 0.0f && flValue <= 1.0f)
-                {
-                    pSource->OuterGainHF = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_AIR_ABSORPTION_FACTOR:
-                if(flValue >= 0.0f && flValue <= 10.0f)
-                {
-                    pSource->AirAbsorptionFactor = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_ROOM_ROLLOFF_FACTOR:
-                if(flValue >= 0.0f && flValue <= 10.0f)
-                {
-                    pSource->RoomRolloffFactor = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_DOPPLER_FACTOR:
-                if(flValue >= 0.0f && flValue <= 1.0f)
-                {
-                    pSource->DopplerFactor = flValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_SEC_OFFSET:
-            case AL_SAMPLE_OFFSET:
-            case AL_BYTE_OFFSET:
-                if(flValue >= 0.0f)
-                {
-                    pSource->lOffsetType = eParam;
-
-                    // Store Offset (convert Seconds into Milliseconds)
-                    if(eParam == AL_SEC_OFFSET)
-                        pSource->lOffset = (ALint)(flValue * 1000.0f);
-                    else
-                        pSource->lOffset = (ALint)flValue;
+        SetSourceOffset(source, eParam, flValue);
+        return;
+    }
 
-                    if ((pSource->state == AL_PLAYING) || (pSource->state == AL_PAUSED))
-                    {
-                        if(ApplyOffset(pSource) == AL_FALSE)
-                            alSetError(AL_INVALID_VALUE);
-                    }
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
+    pContext = GetContextProps();
+    if(!pContext) return;
 
-            default:
-                alSetError(AL_INVALID_ENUM);
-                break;
-        }
+    if((pSource=LookupSource(pContext, source)) != NULL)
+    {
+        err = SetSourcefProp(pSource, eParam, flValue);
+        if(err == AL_NO_ERROR)
+            CommitSourceProps(pContext, pSource);
     }
     else
     {
         // Invalid Source Name
-        alSetError(AL_INVALID_NAME);
+        err = AL_INVALID_NAME;
     }
 
-    ProcessContext(pContext);
+    UnlockProps();
+
+    // Setting the error needs the context lock, so it's done after unlocking
+    if(err != AL_NO_ERROR)
+        alSetError(err);
 }
 
 
@@ -408,98 +298,72 @@ ALAPI ALvoid ALAPIENTRY alSource3f(ALuint source, ALenum eParam, ALfloat flValue
 {
     ALCcontext    *pContext;
     ALsource    *pSource;
+    ALenum      err;
 
-    pContext = GetContextSuspended();
+    pContext = GetContextProps();
     if(!pContext) return;
 
-    if(alIsSource(source))
+    if((pSource=LookupSource(pContext, source)) != NULL)
     {
-        pSource = (ALsource*)ALTHUNK_LOOKUPENTRY(source);
-        switch(eParam)
-        {
-            case AL_POSITION:
-                pSource->vPosition[0] = flValue1;
-                pSource->vPosition[1] = flValue2;
-                pSource->vPosition[2] = flValue3;
-                pSource->NeedsUpdate = AL_TRUE;
-                break;
-
-            case AL_VELOCITY:
-                pSource->vVelocity[0] = flValue1;
-                pSource->vVelocity[1] = flValue2;
-                pSource->vVelocity[2] = flValue3;
-                pSource->NeedsUpdate = AL_TRUE;
-                break;
-
-            case AL_DIRECTION:
-                pSource->vOrientation[0] = flValue1;
-                pSource->vOrientation[1] = flValue2;
-                pSource->vOrientation[2] = flValue3;
-                pSource->NeedsUpdate = AL_TRUE;
-                break;
-
-            default:
-                alSetError(AL_INVALID_ENUM);
-                break;
-        }
+        err = SetSource3fProp(pSource, eParam, flValue1, flValue2, flValue3);
+        if(err == AL_NO_ERROR)
+            CommitSourceProps(pContext, pSource);
     }
     else
-        alSetError(AL_INVALID_NAME);
+        err = AL_INVALID_NAME;
 
-    ProcessContext(pContext);
+    UnlockProps();
+
+    if(err != AL_NO_ERROR)
+        alSetError(err);
 }
 
 
 ALAPI ALvoid ALAPIENTRY alSourcefv(ALuint source, ALenum eParam, const ALfloat *pflValues)
 {
-    ALCcontext    *pContext;
-
-    pContext = GetContextSuspended();
-    if(!pContext) return;
+    if(!pflValues)
+    {
+        alSetError(AL_INVALID_VALUE);
+        return;
+    }
 
-    if(pflValues)
+    /* No lock is held while forwarding, so properties set through here don't
+     * wait for the mixer either. The source is validated by the call. */
+    switch(eParam)
     {
-        if(alIsSource(source))
-        {
-            switch(eParam)
-            {
-                case AL_PITCH:
-                case AL_CONE_INNER_ANGLE:
-                case AL_CONE_OUTER_ANGLE:
-                case AL_GAIN:
-                case AL_MAX_DISTANCE:
-                case AL_ROLLOFF_FACTOR:
-                case AL_REFERENCE_DISTANCE:
-                case AL_MIN_GAIN:
-                case AL_MAX_GAIN:
-                case AL_CONE_OUTER_GAIN:
-                case AL_CONE_OUTER_GAINHF:
-                case AL_SEC_OFFSET:
-                case AL_SAMPLE_OFFSET:
-                case AL_BYTE_OFFSET:
-                case AL_AIR_ABSORPTION_FACTOR:
-                case AL_ROOM_ROLLOFF_FACTOR:
-                    alSourcef(source, eParam, pflValues[0]);
-                    break;
+        case AL_PITCH:
+        case AL_CONE_INNER_ANGLE:
+        case AL_CONE_OUTER_ANGLE:
+        case AL_GAIN:
+        case AL_MAX_DISTANCE:
+        case AL_ROLLOFF_FACTOR:
+        case AL_REFERENCE_DISTANCE:
+        case AL_MIN_GAIN:
+        case AL_MAX_GAIN:
+        case AL_CONE_OUTER_GAIN:
+        case AL_CONE_OUTER_GAINHF:
+        case AL_SEC_OFFSET:
+        case AL_SAMPLE_OFFSET:
+        case AL_BYTE_OFFSET:
+        case AL_AIR_ABSORPTION_FACTOR:
+        case AL_ROOM_ROLLOFF_FACTOR:
+        case AL_SOURCE_PRIORITY:
+            alSourcef(source, eParam, pflValues[0]);
+            break;
 
-                case AL_POSITION:
-                case AL_VELOCITY:
-                case AL_DIRECTION:
-                    alSource3f(source, eParam, pflValues[0], pflValues[1], pflValues[2]);
-                    break;
+        case AL_POSITION:
+        case AL_VELOCITY:
+        case AL_DIRECTION:
+            alSource3f(source, eParam, pflValues[0], pflValues[1], pflValues[2]);
+            break;
 
-                default:
-                    alSetError(AL_INVALID_ENUM);
-                    break;
-            }
-        }
-        else
-            alSetError(AL_INVALID_NAME);
+        default:
+            if(alIsSource(source))
+                alSetError(AL_INVALID_ENUM);
+            else
+                alSetError(AL_INVALID_NAME);
+            break;
     }
-    else
-        alSetError(AL_INVALID_VALUE);
-
-    ProcessContext(pContext);
 }
 
 
@@ -521,6 +385,8 @@ ALAPI ALvoid ALAPIENTRY alSourcei(ALuint source,ALenum eParam,ALint lValue)
             case AL_MAX_DISTANCE:
             case AL_ROLLOFF_FACTOR:
             case AL_REFERENCE_DISTANCE:
+            case AL_CONE_INNER_ANGLE:
+            case AL_CONE_OUTER_ANGLE:
                 alSourcef(source, eParam, (ALfloat)lValue);
                 break;
 
@@ -534,26 +400,6 @@ ALAPI ALvoid ALAPIENTRY alSourcei(ALuint source,ALenum eParam,ALint lValue)
                     alSetError(AL_INVALID_VALUE);
                 break;
 
-            case AL_CONE_INNER_ANGLE:
-                if(lValue >= 0 && lValue <= 360)
-                {
-                    pSource->flInnerAngle = (float)lValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
-            case AL_CONE_OUTER_ANGLE:
-                if(lValue >= 0 && lValue <= 360)
-                {
-                    pSource->flOuterAngle = (float)lValue;
-                    pSource->NeedsUpdate = AL_TRUE;
-                }
-                else
-                    alSetError(AL_INVALID_VALUE);
-                break;
-
             case AL_LOOPING:
                 if(lValue == AL_FALSE || lValue == AL_TRUE)
                     pSource->bLooping = (ALboolean)lValue;
@@ -567,6 +413,23 @@ ALAPI ALvoid ALAPIENTRY alSourcei(ALuint source,ALenum eParam,ALint lValue)
                     if(alIsBuffer(lValue))
                     {
                         ALbuffer *buffer = NULL;
+                        ALbufferlistitem *pNewItem = NULL;
+
+                        // Get the new queue item first, so the source is
+                        // left alone if there's no memory for it
+                        if(lValue != 0)
+                        {
+                            pNewItem = PoolAlloc(&pContext->BufferListPool);
+                            // A non-empty queue already has index entries,
+                            // which get reused once it's cleared
+                            if(!pNewItem || (pSource->QueueIndexSize == 0 &&
+                                             !ReserveQueueIndex(pSource, 1)))
+                            {
+                                PoolFree(&pContext->BufferListPool, pNewItem);
+                                alSetError(AL_OUT_OF_MEMORY);
+                                break;
+                            }
+                        }
 
                         // Remove all elements in the queue
                         while(pSource->queue != NULL)
@@ -577,10 +440,13 @@ ALAPI ALvoid ALAPIENTRY alSourcei(ALuint source,ALenum eParam,ALint lValue)
                             if(pALBufferListItem->buffer)
                                 pALBufferListItem->buffer->refcount--;
                             // Release memory for buffer list item
-                            free(pALBufferListItem);
+                            PoolFree(&pContext->BufferListPool, pALBufferListItem);
                             // Decrement the number of buffers in the queue
                             pSource->BuffersInQueue--;
                         }
+                        pSource->QueueTail = NULL;
+                        pSource->CurrentItem = NULL;
+                        pSource->QueueIndexHead = 0;
 
                         // Add the buffer to the queue (as long as it is NOT the NULL buffer)
                         if(lValue != 0)
@@ -591,12 +457,18 @@ ALAPI ALvoid ALAPIENTRY alSourcei(ALuint source,ALenum eParam,ALint lValue)
                             pSource->lSourceType = AL_STATIC;
 
                             // Add the selected buffer to the queue
-                            pALBufferListItem = malloc(sizeof(ALbufferlistitem));
+                            pALBufferListItem = pNewItem;
                             pALBufferListItem->buffer = buffer;
                             pALBufferListItem->next = NULL;
+                            pALBufferListItem->prev = NULL;
+                            pALBufferListItem->Start = 0;
 
                             pSource->queue = pALBufferListItem;
+                            pSource->QueueTail = pALBufferListItem;
+                            pSource->QueueIndex[0] = pALBufferListItem;
                             pSource->BuffersInQueue = 1;
+                            if(pSource->BuffersPlayed == 0)
+                                pSource->CurrentItem = pALBufferListItem;
 
                             // Increment reference counter for buffer
                             buffer->refcount++;
@@ -844,10 +716,11 @@ ALAPI ALvoid ALAPIENTRY alGetSourcef(ALuint source, ALenum eParam, ALfloat *pflV
 {
     ALCcontext    *pContext;
     ALsource    *pSource;
-    ALfloat        flOffset[2];
+    ALenum      err;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    LockProps();
 
     if(pflValue)
     {
@@ -855,89 +728,10 @@ ALAPI ALvoid ALAPIENTRY alGetSourcef(ALuint source, ALenum eParam, ALfloat *pflV
         {
             pSource = (ALsource*)ALTHUNK_LOOKUPENTRY(source);
 
-            switch(eParam)
-            {
-                case AL_PITCH:
-                    *pflValue = pSource->flPitch;
-                    break;
-
-                case AL_GAIN:
-                    *pflValue = pSource->flGain;
-                    break;
-
-                case AL_MIN_GAIN:
-                    *pflValue = pSource->flMinGain;
-                    break;
-
-                case AL_MAX_GAIN:
-                    *pflValue = pSource->flMaxGain;
-                    break;
-
-                case AL_MAX_DISTANCE:
-                    *pflValue = pSource->flMaxDistance;
-                    break;
-
-                case AL_ROLLOFF_FACTOR:
-                    *pflValue = pSource->flRollOffFactor;
-                    break;
-
-                case AL_CONE_OUTER_GAIN:
-                    *pflValue = pSource->flOuterGain;
-                    break;
-
-                case AL_CONE_OUTER_GAINHF:
-                    *pflValue = pSource->OuterGainHF;
-                    break;
-
-                case AL_SEC_OFFSET:
-                case AL_SAMPLE_OFFSET:
-                case AL_BYTE_OFFSET:
-                    if(GetSourceOffset(pSource, eParam, flOffset, pContext->Device->UpdateSize))
-                        *pflValue = flOffset[0];
-                    else
-                        alSetError(AL_INVALID_OPERATION);
-                    break;
-
-                case AL_SEC_RW_OFFSETS_EXT:
-                case AL_SAMPLE_RW_OFFSETS_EXT:
-                case AL_BYTE_RW_OFFSETS_EXT:
-                    if(GetSourceOffset(pSource, eParam, flOffset, pContext->Device->UpdateSize))
-                    {
-                        pflValue[0] = flOffset[0];
-                        pflValue[1] = flOffset[1];
-                    }
-                    else
-                        alSetError(AL_INVALID_OPERATION);
-                    break;
-
-                case AL_CONE_INNER_ANGLE:
-                    *pflValue = pSource->flInnerAngle;
-                    break;
-
-                case AL_CONE_OUTER_ANGLE:
-                    *pflValue = pSource->flOuterAngle;
-                    break;
-
-                case AL_REFERENCE_DISTANCE:
-                    *pflValue = pSource->flRefDistance;
-                    break;
-
-                case AL_AIR_ABSORPTION_FACTOR:
-                    *pflValue = pSource->AirAbsorptionFactor;
-                    break;
-
-                case AL_ROOM_ROLLOFF_FACTOR:
-                    *pflValue = pSource->RoomRolloffFactor;
-                    break;
-
-                case AL_DOPPLER_FACTOR:
-                    *pflValue = pSource->DopplerFactor;
-                    break;
-
-                default:
-                    alSetError(AL_INVALID_ENUM);
-                    break;
-            }
+            err = GetSourcefProp(pSource, eParam, pflValue,
+                                 pContext->Device->UpdateSize);
+            if(err != AL_NO_ERROR)
+                alSetError(err);
         }
         else
             alSetError(AL_INVALID_NAME);
@@ -945,6 +739,7 @@ ALAPI ALvoid ALAPIENTRY alGetSourcef(ALuint source, ALenum eParam, ALfloat *pflV
     else
         alSetError(AL_INVALID_VALUE);
 
+    UnlockProps();
     ProcessContext(pContext);
 }
 
@@ -953,9 +748,12 @@ ALAPI ALvoid ALAPIENTRY alGetSource3f(ALuint source, ALenum eParam, ALfloat* pfl
 {
     ALCcontext    *pContext;
     ALsource    *pSource;
+    ALfloat     flValues[3];
+    ALenum      err;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    LockProps();
 
     if(pflValue1 && pflValue2 && pflValue3)
     {
@@ -963,30 +761,15 @@ ALAPI ALvoid ALAPIENTRY alGetSource3f(ALuint source, ALenum eParam, ALfloat* pfl
         {
             pSource = (ALsource*)ALTHUNK_LOOKUPENTRY(source);
 
-            switch(eParam)
+            err = GetSource3fProp(pSource, eParam, flValues);
+            if(err == AL_NO_ERROR)
             {
-                case AL_POSITION:
-                    *pflValue1 = pSource->vPosition[0];
-                    *pflValue2 = pSource->vPosition[1];
-                    *pflValue3 = pSource->vPosition[2];
-                    break;
-
-                case AL_VELOCITY:
-                    *pflValue1 = pSource->vVelocity[0];
-                    *pflValue2 = pSource->vVelocity[1];
-                    *pflValue3 = pSource->vVelocity[2];
-                    break;
-
-                case AL_DIRECTION:
-                    *pflValue1 = pSource->vOrientation[0];
-                    *pflValue2 = pSource->vOrientation[1];
-                    *pflValue3 = pSource->vOrientation[2];
-                    break;
-
-                default:
-                    alSetError(AL_INVALID_ENUM);
-                    break;
+                *pflValue1 = flValues[0];
+                *pflValue2 = flValues[1];
+                *pflValue3 = flValues[2];
             }
+            else
+                alSetError(err);
         }
         else
             alSetError(AL_INVALID_NAME);
@@ -994,6 +777,7 @@ ALAPI ALvoid ALAPIENTRY alGetSource3f(ALuint source, ALenum eParam, ALfloat* pfl
     else
         alSetError(AL_INVALID_VALUE);
 
+    UnlockProps();
     ProcessContext(pContext);
 }
 
@@ -1002,9 +786,11 @@ ALAPI ALvoid ALAPIENTRY alGetSourcefv(ALuint source, ALenum eParam, ALfloat *pfl
 {
     ALCcontext    *pContext;
     ALsource    *pSource;
+    ALenum      err;
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    LockProps();
 
     if(pflValues)
     {
@@ -1031,31 +817,23 @@ ALAPI ALvoid ALAPIENTRY alGetSourcefv(ALuint source, ALenum eParam, ALfloat *pfl
                 case AL_CONE_OUTER_GAINHF:
                 case AL_AIR_ABSORPTION_FACTOR:
                 case AL_ROOM_ROLLOFF_FACTOR:
-                    alGetSourcef(source, eParam, pflValues);
+                case AL_SOURCE_PRIORITY:
+                    err = GetSourcefProp(pSource, eParam, pflValues,
+                                         pContext->Device->UpdateSize);
                     break;
 
                 case AL_POSITION:
-                    pflValues[0] = pSource->vPosition[0];
-                    pflValues[1] = pSource->vPosition[1];
-                    pflValues[2] = pSource->vPosition[2];
-                    break;
-
                 case AL_VELOCITY:
-                    pflValues[0] = pSource->vVelocity[0];
-                    pflValues[1] = pSource->vVelocity[1];
-                    pflValues[2] = pSource->vVelocity[2];
-                    break;
-
                 case AL_DIRECTION:
-                    pflValues[0] = pSource->vOrientation[0];
-                    pflValues[1] = pSource->vOrientation[1];
-                    pflValues[2] = pSource->vOrientation[2];
+                    err = GetSource3fProp(pSource, eParam, pflValues);
                     break;
 
                 default:
-                    alSetError(AL_INVALID_ENUM);
+                    err = AL_INVALID_ENUM;
                     break;
             }
+            if(err != AL_NO_ERROR)
+                alSetError(err);
         }
         else
             alSetError(AL_INVALID_NAME);
@@ -1063,6 +841,7 @@ ALAPI ALvoid ALAPIENTRY alGetSourcefv(ALuint source, ALenum eParam, ALfloat *pfl
     else
         alSetError(AL_INVALID_VALUE);
 
+    UnlockProps();
     ProcessContext(pContext);
 }
 
@@ -1075,6 +854,7 @@ ALAPI ALvoid ALAPIENTRY alGetSourcei(ALuint source, ALenum eParam, ALint *plValu
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    LockProps();
 
     if(plValue)
     {
@@ -1195,6 +975,7 @@ ALAPI ALvoid ALAPIENTRY alGetSourcei(ALuint source, ALenum eParam, ALint *plValu
     else
         alSetError(AL_INVALID_VALUE);
 
+    UnlockProps();
     ProcessContext(pContext);
 }
 
@@ -1206,6 +987,7 @@ ALAPI void ALAPIENTRY alGetSource3i(ALuint source, ALenum eParam, ALint* plValue
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    LockProps();
 
     if(plValue1 && plValue2 && plValue3)
     {
@@ -1244,6 +1026,7 @@ ALAPI void ALAPIENTRY alGetSource3i(ALuint source, ALenum eParam, ALint* plValue
     else
         alSetError(AL_INVALID_VALUE);
 
+    UnlockProps();
     ProcessContext(pContext);
 }
 
@@ -1255,6 +1038,7 @@ ALAPI void ALAPIENTRY alGetSourceiv(ALuint source, ALenum eParam, ALint* plValue
 
     pContext = GetContextSuspended();
     if(!pContext) return;
+    LockProps();
 
     if(plValues)
     {
@@ -1317,6 +1101,190 @@ ALAPI void ALAPIENTRY alGetSourceiv(ALuint source, ALenum eParam, ALint* plValue
     else
         alSetError(AL_INVALID_VALUE);
 
+    UnlockProps();
+    ProcessContext(pContext);
+}
+
+
+/*
+    alSourcesfvEXT
+
+    Sets the same float property on n sources, reading the values for each
+    source from a packed array (three values per source for the vector
+    properties, one otherwise). All the names and values are checked before
+    anything is changed, so an error leaves every source as it was, and the
+    context is only locked once for the whole list.
+*/
+ALAPI ALvoid ALAPIENTRY alSourcesfvEXT(ALsizei n, const ALuint *sources, ALenum eParam, const ALfloat *pflValues)
+{
+    ALCcontext    *pContext;
+    ALsource    *pSource;
+    ALenum      err = AL_NO_ERROR;
+    ALsizei     i;
+
+    if(n < 0 || (n > 0 && (!sources || !pflValues)))
+    {
+        alSetError(AL_INVALID_VALUE);
+        return;
+    }
+
+    if(eParam == AL_SEC_OFFSET || eParam == AL_SAMPLE_OFFSET ||
+       eParam == AL_BYTE_OFFSET)
+    {
+        pContext = GetContextSuspended();
+        if(!pContext) return;
+
+        for(i = 0;i < n;i++)
+        {
+            if(!LookupSource(pContext, sources[i]))
+            {
+                err = AL_INVALID_NAME;
+                break;
+            }
+        }
+        // Playing and paused sources move to the offset straight away, so it
+        // has to be within their queue
+        for(i = 0;i < n && err == AL_NO_ERROR;i++)
+        {
+            pSource = LookupSource(pContext, sources[i]);
+            if(!(pflValues[i] >= 0.0f))
+                err = AL_INVALID_VALUE;
+            else if((pSource->state == AL_PLAYING || pSource->state == AL_PAUSED) &&
+                    GetByteOffset(pSource, eParam, ((eParam == AL_SEC_OFFSET) ?
+                                                    (ALint)(pflValues[i] * 1000.0f) :
+                                                    (ALint)pflValues[i])) == -1)
+                err = AL_INVALID_VALUE;
+        }
+        if(err == AL_NO_ERROR)
+        {
+            for(i = 0;i < n;i++)
+                SetSourceOffset(sources[i], eParam, pflValues[i]);
+        }
+        else
+            alSetError(err);
+
+        ProcessContext(pContext);
+        return;
+    }
+
+    pContext = GetContextProps();
+    if(!pContext) return;
+
+    for(i = 0;i < n;i++)
+    {
+        if(!LookupSource(pContext, sources[i]))
+        {
+            err = AL_INVALID_NAME;
+            break;
+        }
+    }
+
+    switch(eParam)
+    {
+        case AL_POSITION:
+        case AL_VELOCITY:
+        case AL_DIRECTION:
+            for(i = 0;i < n && err == AL_NO_ERROR;i++)
+            {
+                pSource = LookupSource(pContext, sources[i]);
+                err = SetSource3fProp(pSource, eParam, pflValues[i*3 + 0],
+                                      pflValues[i*3 + 1], pflValues[i*3 + 2]);
+                if(err == AL_NO_ERROR)
+                    CommitSourceProps(pContext, pSource);
+            }
+            break;
+
+        default:
+            // Check every value before setting any
+            for(i = 0;i < n && err == AL_NO_ERROR;i++)
+                err = SetSourcefProp(NULL, eParam, pflValues[i]);
+            for(i = 0;i < n && err == AL_NO_ERROR;i++)
+            {
+                pSource = LookupSource(pContext, sources[i]);
+                SetSourcefProp(pSource, eParam, pflValues[i]);
+                CommitSourceProps(pContext, pSource);
+            }
+            break;
+    }
+
+    UnlockProps();
+
+    if(err != AL_NO_ERROR)
+        alSetError(err);
+}
+
+
+/*
+    alGetSourcesfvEXT
+
+    Gets the same float property from n sources into a packed array, with
+    three values per source for the vector properties, two for the
+    read/write offsets, and one otherwise. Nothing is written if any of the
+    names are invalid.
+*/
+ALAPI ALvoid ALAPIENTRY alGetSourcesfvEXT(ALsizei n, const ALuint *sources, ALenum eParam, ALfloat *pflValues)
+{
+    ALCcontext    *pContext;
+    ALsource    *pSource;
+    ALenum      err = AL_NO_ERROR;
+    ALsizei     i;
+
+    if(n < 0 || (n > 0 && (!sources || !pflValues)))
+    {
+        alSetError(AL_INVALID_VALUE);
+        return;
+    }
+
+    pContext = GetContextSuspended();
+    if(!pContext) return;
+    LockProps();
+
+    for(i = 0;i < n;i++)
+    {
+        if(!LookupSource(pContext, sources[i]))
+        {
+            err = AL_INVALID_NAME;
+            break;
+        }
+    }
+
+    switch(eParam)
+    {
+        case AL_POSITION:
+        case AL_VELOCITY:
+        case AL_DIRECTION:
+            for(i = 0;i < n && err == AL_NO_ERROR;i++)
+            {
+                pSource = LookupSource(pContext, sources[i]);
+                err = GetSource3fProp(pSource, eParam, &pflValues[i*3]);
+            }
+            break;
+
+        case AL_SEC_RW_OFFSETS_EXT:
+        case AL_SAMPLE_RW_OFFSETS_EXT:
+        case AL_BYTE_RW_OFFSETS_EXT:
+            for(i = 0;i < n && err == AL_NO_ERROR;i++)
+            {
+                pSource = LookupSource(pContext, sources[i]);
+                err = GetSourcefProp(pSource, eParam, &pflValues[i*2],
+                                     pContext->Device->UpdateSize);
+            }
+            break;
+
+        default:
+            for(i = 0;i < n && err == AL_NO_ERROR;i++)
+            {
+                pSource = LookupSource(pContext, sources[i]);
+                err = GetSourcefProp(pSource, eParam, &pflValues[i],
+                                     pContext->Device->UpdateSize);
+            }
+            break;
+    }
+
+    if(err != AL_NO_ERROR)
+        alSetError(err);
+
+    UnlockProps();
     ProcessContext(pContext);
 }
 
@@ -1385,6 +1353,7 @@ ALAPI ALvoid ALAPIENTRY alSourcePlayv(ALsizei n, const ALuint *pSourceList)
                         pSource->position = 0;
                         pSource->position_fraction = 0;
                         pSource->BuffersPlayed = 0;
+                        pSource->CurrentItem = pSource->queue;
 
                         pSource->Buffer = pSource->queue->buffer;
                     }
@@ -1406,12 +1375,16 @@ ALAPI ALvoid ALAPIENTRY alSourcePlayv(ALsizei n, const ALuint *pSourceList)
                     {
                         pSource->state = AL_STOPPED;
                         pSource->BuffersPlayed = pSource->BuffersInQueue;
+                        pSource->CurrentItem = NULL;
                         pSource->position = 0;
                         pSource->position_fraction = 0;
                     }
                 }
                 else
+                {
                     pSource->BuffersPlayed = pSource->BuffersInQueue;
+                    pSource->CurrentItem = NULL;
+                }
             }
         }
     }
@@ -1508,6 +1481,7 @@ ALAPI ALvoid ALAPIENTRY alSourceStopv(ALsizei n, const ALuint *sources)
                 {
                     Source->state = AL_STOPPED;
                     Source->BuffersPlayed = Source->BuffersInQueue;
+                    Source->CurrentItem = NULL;
                 }
                 Source->lOffset = 0;
             }
@@ -1561,6 +1535,7 @@ ALAPI ALvoid ALAPIENTRY alSourceRewindv(ALsizei n, const ALuint *sources)
                     Source->position = 0;
                     Source->position_fraction = 0;
                     Source->BuffersPlayed = 0;
+                    Source->CurrentItem = Source->queue;
                     if(Source->queue)
                         Source->Buffer = Source->queue->buffer;
                 }
@@ -1651,6 +1626,31 @@ ALAPI ALvoid ALAPIENTRY alSourceQueueBuffers( ALuint source, ALsizei n, const AL
                 }
             }
 
+            // Get all the new queue items before changing anything
+            ALBufferListStart = NULL;
+            if(bBuffersValid)
+            {
+                for(i = 0; i < n; i++)
+                {
+                    ALBufferList = PoolAlloc(&Context->BufferListPool);
+                    if(!ALBufferList)
+                        break;
+                    ALBufferList->next = ALBufferListStart;
+                    ALBufferListStart = ALBufferList;
+                }
+                if(i < n || !ReserveQueueIndex(ALSource, n))
+                {
+                    while(ALBufferListStart)
+                    {
+                        ALBufferList = ALBufferListStart;
+                        ALBufferListStart = ALBufferList->next;
+                        PoolFree(&Context->BufferListPool, ALBufferList);
+                    }
+                    alSetError(AL_OUT_OF_MEMORY);
+                    bBuffersValid = AL_FALSE;
+                }
+            }
+
             if(bBuffersValid)
             {
                 ALbuffer *buffer = NULL;
@@ -1658,29 +1658,26 @@ ALAPI ALvoid ALAPIENTRY alSourceQueueBuffers( ALuint source, ALsizei n, const AL
                 // Change Source Type
                 ALSource->lSourceType = AL_STREAMING;
 
-                buffer = (ALbuffer*)ALTHUNK_LOOKUPENTRY(buffers[0]);
-
-                // All buffers are valid - so add them to the list
-                ALBufferListStart = malloc(sizeof(ALbufferlistitem));
-                ALBufferListStart->buffer = buffer;
-                ALBufferListStart->next = NULL;
-
-                // Increment reference counter for buffer
-                if(buffer) buffer->refcount++;
-
+                // All buffers are valid - so add them to the end of the list
                 ALBufferList = ALBufferListStart;
-
-                for(i = 1; i < n; i++)
+                ALBufferList->prev = ALSource->QueueTail;
+                for(i = 0; i < n; i++)
                 {
                     buffer = (ALbuffer*)ALTHUNK_LOOKUPENTRY(buffers[i]);
-
-                    ALBufferList->next = malloc(sizeof(ALbufferlistitem));
-                    ALBufferList->next->buffer = buffer;
-                    ALBufferList->next->next = NULL;
+                    ALBufferList->buffer = buffer;
+                    ALSource->QueueIndex[ALSource->QueueIndexHead +
+                                         ALSource->BuffersInQueue + i] = ALBufferList;
+                    if(ALBufferList->prev)
+                        ALBufferList->Start = ALBufferList->prev->Start +
+                                              GetItemSize(ALBufferList->prev);
 
                     // Increment reference counter for buffer
                     if(buffer) buffer->refcount++;
 
+                    if(ALBufferList->next)
+                        ALBufferList->next->prev = ALBufferList;
+                    else
+                        ALSource->QueueTail = ALBufferList;
                     ALBufferList = ALBufferList->next;
                 }
 
@@ -1691,14 +1688,11 @@ ALAPI ALvoid ALAPIENTRY alSourceQueueBuffers( ALuint source, ALsizei n, const AL
                     ALSource->Buffer = ALBufferListStart->buffer;
                 }
                 else
-                {
-                    // Find end of queue
-                    ALBufferList = ALSource->queue;
-                    while(ALBufferList->next != NULL)
-                        ALBufferList = ALBufferList->next;
+                    ALBufferListStart->prev->next = ALBufferListStart;
 
-                    ALBufferList->next = ALBufferListStart;
-                }
+                // The new buffers are next if all the old ones were played
+                if(ALSource->BuffersPlayed == ALSource->BuffersInQueue)
+                    ALSource->CurrentItem = ALBufferListStart;
 
                 // Update number of buffers in queue
                 ALSource->BuffersInQueue += n;
@@ -1761,9 +1755,19 @@ ALAPI ALvoid ALAPIENTRY alSourceUnqueueBuffers( ALuint source, ALsizei n, ALuint
                     ALBufferList->buffer->refcount--;
 
                 // Release memory for buffer list item
-                free(ALBufferList);
+                PoolFree(&Context->BufferListPool, ALBufferList);
                 ALSource->BuffersInQueue--;
             }
+            if(ALSource->queue)
+            {
+                ALSource->queue->prev = NULL;
+                ALSource->QueueIndexHead += n;
+            }
+            else
+            {
+                ALSource->QueueTail = NULL;
+                ALSource->QueueIndexHead = 0;
+            }
 
             if(ALSource->state != AL_PLAYING)
             {
@@ -1821,6 +1825,7 @@ static ALvoid InitSourceParams(ALsource *pSource)
     pSource->AirAbsorptionFactor = 0.0f;
     pSource->RoomRolloffFactor = 0.0f;
     pSource->DopplerFactor = 1.0f;
+    pSource->Priority = 1.0f;
 
     pSource->DistanceModel = AL_INVERSE_DISTANCE_CLAMPED;
 
@@ -1832,6 +1837,454 @@ static ALvoid InitSourceParams(ALsource *pSource)
     pSource->NeedsUpdate = AL_TRUE;
 
     pSource->Buffer = NULL;
+
+    pSource->PropWrite = 0;
+    pSource->PropState = 1;
+    pSource->PropRead = 2;
+    PublishSourceProps(pSource);
+}
+
+
+/*
+    SetSourceOffset
+
+    Offsets change the source's playback state, which the mixer uses, so they
+    need the context lock instead of the property lock
+*/
+static ALvoid SetSourceOffset(ALuint source, ALenum eParam, ALfloat flValue)
+{
+    ALCcontext    *pContext;
+    ALsource    *pSource;
+
+    pContext = GetContextSuspended();
+    if(!pContext) return;
+
+    if(alIsSource(source))
+    {
+        pSource = (ALsource*)ALTHUNK_LOOKUPENTRY(source);
+
+        if(flValue >= 0.0f)
+        {
+            pSource->lOffsetType = eParam;
+
+            // Store Offset (convert Seconds into Milliseconds)
+            if(eParam == AL_SEC_OFFSET)
+                pSource->lOffset = (ALint)(flValue * 1000.0f);
+            else
+                pSource->lOffset = (ALint)flValue;
+
+            if ((pSource->state == AL_PLAYING) || (pSource->state == AL_PAUSED))
+            {
+                if(ApplyOffset(pSource) == AL_FALSE)
+                    alSetError(AL_INVALID_VALUE);
+            }
+        }
+        else
+            alSetError(AL_INVALID_VALUE);
+    }
+    else
+        alSetError(AL_INVALID_NAME);
+
+    ProcessContext(pContext);
+}
+
+
+/*
+    LookupSource
+
+    Finds the named source in the context. The caller must hold the context
+    lock or the property lock, so the source can't be deleted while it's in
+    use.
+*/
+static ALsource *LookupSource(ALCcontext *Context, ALuint source)
+{
+    return (ALsource*)ALTHUNK_LOOKUPOBJECT(source, THUNK_SOURCE, Context);
+}
+
+
+/*
+    SetSourcefProp
+
+    Sets one of the source's single-value properties that are passed to the
+    mixer through its property blocks. The caller must hold the property lock
+    and commit the change (see CommitSourceProps). With a NULL source, the
+    value is only checked.
+*/
+static ALenum SetSourcefProp(ALsource *pSource, ALenum eParam, ALfloat flValue)
+{
+    ALenum err = AL_NO_ERROR;
+
+    switch(eParam)
+    {
+        case AL_PITCH:
+            if(!(flValue >= 0.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+            {
+                pSource->flPitch = flValue;
+                if(pSource->flPitch < 0.001f)
+                    pSource->flPitch = 0.001f;
+            }
+            break;
+
+        case AL_CONE_INNER_ANGLE:
+            if(!(flValue >= 0.0f && flValue <= 360.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flInnerAngle = flValue;
+            break;
+
+        case AL_CONE_OUTER_ANGLE:
+            if(!(flValue >= 0.0f && flValue <= 360.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flOuterAngle = flValue;
+            break;
+
+        case AL_GAIN:
+            if(!(flValue >= 0.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flGain = flValue;
+            break;
+
+        case AL_MAX_DISTANCE:
+            if(!(flValue >= 0.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flMaxDistance = flValue;
+            break;
+
+        case AL_ROLLOFF_FACTOR:
+            if(!(flValue >= 0.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flRollOffFactor = flValue;
+            break;
+
+        case AL_REFERENCE_DISTANCE:
+            if(!(flValue >= 0.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flRefDistance = flValue;
+            break;
+
+        case AL_MIN_GAIN:
+            if(!(flValue >= 0.0f && flValue <= 1.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flMinGain = flValue;
+            break;
+
+        case AL_MAX_GAIN:
+            if(!(flValue >= 0.0f && flValue <= 1.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flMaxGain = flValue;
+            break;
+
+        case AL_CONE_OUTER_GAIN:
+            if(!(flValue >= 0.0f && flValue <= 1.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->flOuterGain = flValue;
+            break;
+
+        case AL_CONE_OUTER_GAINHF:
+            if(!(flValue >= 0.0f && flValue <= 1.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->OuterGainHF = flValue;
+            break;
+
+        case AL_AIR_ABSORPTION_FACTOR:
+            if(!(flValue >= 0.0f && flValue <= 10.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->AirAbsorptionFactor = flValue;
+            break;
+
+        case AL_ROOM_ROLLOFF_FACTOR:
+            if(!(flValue >= 0.0f && flValue <= 10.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->RoomRolloffFactor = flValue;
+            break;
+
+        case AL_DOPPLER_FACTOR:
+            if(!(flValue >= 0.0f && flValue <= 1.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->DopplerFactor = flValue;
+            break;
+
+        case AL_SOURCE_PRIORITY:
+            if(!(flValue >= 0.0f))
+                err = AL_INVALID_VALUE;
+            else if(pSource)
+                pSource->Priority = flValue;
+            break;
+
+        default:
+            err = AL_INVALID_ENUM;
+            break;
+    }
+
+    return err;
+}
+
+
+/*
+    SetSource3fProp
+
+    Same as SetSourcefProp, for the vector properties
+*/
+static ALenum SetSource3fProp(ALsource *pSource, ALenum eParam, ALfloat flValue1, ALfloat flValue2, ALfloat flValue3)
+{
+    ALenum err = AL_NO_ERROR;
+
+    switch(eParam)
+    {
+        case AL_POSITION:
+            pSource->vPosition[0] = flValue1;
+            pSource->vPosition[1] = flValue2;
+            pSource->vPosition[2] = flValue3;
+            break;
+
+        case AL_VELOCITY:
+            pSource->vVelocity[0] = flValue1;
+            pSource->vVelocity[1] = flValue2;
+            pSource->vVelocity[2] = flValue3;
+            break;
+
+        case AL_DIRECTION:
+            pSource->vOrientation[0] = flValue1;
+            pSource->vOrientation[1] = flValue2;
+            pSource->vOrientation[2] = flValue3;
+            break;
+
+        default:
+            err = AL_INVALID_ENUM;
+            break;
+    }
+
+    return err;
+}
+
+
+/*
+    GetSourcefProp
+
+    Gets one of the source's single-value properties. The playback offsets
+    are calculated using the device's update size, and the read/write offset
+    queries return two values. The caller must hold the context lock.
+*/
+static ALenum GetSourcefProp(ALsource *pSource, ALenum eParam, ALfloat *pflValue, ALuint updateSize)
+{
+    ALfloat flOffset[2];
+    ALenum  err = AL_NO_ERROR;
+
+    switch(eParam)
+    {
+        case AL_PITCH:
+            *pflValue = pSource->flPitch;
+            break;
+
+        case AL_GAIN:
+            *pflValue = pSource->flGain;
+            break;
+
+        case AL_MIN_GAIN:
+            *pflValue = pSource->flMinGain;
+            break;
+
+        case AL_MAX_GAIN:
+            *pflValue = pSource->flMaxGain;
+            break;
+
+        case AL_MAX_DISTANCE:
+            *pflValue = pSource->flMaxDistance;
+            break;
+
+        case AL_ROLLOFF_FACTOR:
+            *pflValue = pSource->flRollOffFactor;
+            break;
+
+        case AL_CONE_OUTER_GAIN:
+            *pflValue = pSource->flOuterGain;
+            break;
+
+        case AL_CONE_OUTER_GAINHF:
+            *pflValue = pSource->OuterGainHF;
+            break;
+
+        case AL_SEC_OFFSET:
+        case AL_SAMPLE_OFFSET:
+        case AL_BYTE_OFFSET:
+            if(GetSourceOffset(pSource, eParam, flOffset, updateSize))
+                *pflValue = flOffset[0];
+            else
+                err = AL_INVALID_OPERATION;
+            break;
+
+        case AL_SEC_RW_OFFSETS_EXT:
+        case AL_SAMPLE_RW_OFFSETS_EXT:
+        case AL_BYTE_RW_OFFSETS_EXT:
+            if(GetSourceOffset(pSource, eParam, flOffset, updateSize))
+            {
+                pflValue[0] = flOffset[0];
+                pflValue[1] = flOffset[1];
+            }
+            else
+                err = AL_INVALID_OPERATION;
+            break;
+
+        case AL_CONE_INNER_ANGLE:
+            *pflValue = pSource->flInnerAngle;
+            break;
+
+        case AL_CONE_OUTER_ANGLE:
+            *pflValue = pSource->flOuterAngle;
+            break;
+
+        case AL_REFERENCE_DISTANCE:
+            *pflValue = pSource->flRefDistance;
+            break;
+
+        case AL_AIR_ABSORPTION_FACTOR:
+            *pflValue = pSource->AirAbsorptionFactor;
+            break;
+
+        case AL_ROOM_ROLLOFF_FACTOR:
+            *pflValue = pSource->RoomRolloffFactor;
+            break;
+
+        case AL_DOPPLER_FACTOR:
+            *pflValue = pSource->DopplerFactor;
+            break;
+
+        case AL_SOURCE_PRIORITY:
+            *pflValue = pSource->Priority;
+            break;
+
+        default:
+            err = AL_INVALID_ENUM;
+            break;
+    }
+
+    return err;
+}
+
+
+/*
+    GetSource3fProp
+
+    Same as GetSourcefProp, for the vector properties
+*/
+static ALenum GetSource3fProp(ALsource *pSource, ALenum eParam, ALfloat *pflValues)
+{
+    ALenum err = AL_NO_ERROR;
+
+    switch(eParam)
+    {
+        case AL_POSITION:
+            pflValues[0] = pSource->vPosition[0];
+            pflValues[1] = pSource->vPosition[1];
+            pflValues[2] = pSource->vPosition[2];
+            break;
+
+        case AL_VELOCITY:
+            pflValues[0] = pSource->vVelocity[0];
+            pflValues[1] = pSource->vVelocity[1];
+            pflValues[2] = pSource->vVelocity[2];
+            break;
+
+        case AL_DIRECTION:
+            pflValues[0] = pSource->vOrientation[0];
+            pflValues[1] = pSource->vOrientation[1];
+            pflValues[2] = pSource->vOrientation[2];
+            break;
+
+        default:
+            err = AL_INVALID_ENUM;
+            break;
+    }
+
+    return err;
+}
+
+
+/*
+    CommitSourceProps
+
+    Hands the source's changed properties to the mixer, or holds them back
+    if updates are deferred. The caller must hold the property lock.
+*/
+static ALvoid CommitSourceProps(ALCcontext *pContext, ALsource *pSource)
+{
+    if(pContext->DeferUpdates)
+        pSource->PropsDeferred = AL_TRUE;
+    else
+        PublishSourceProps(pSource);
+}
+
+
+/*
+    PublishSourceProps
+
+    Copies the source's mixer-visible properties into its spare block and
+    hands it to the mixer. The caller must hold the property lock.
+*/
+static ALvoid PublishSourceProps(ALsource *pSource)
+{
+    ALsourceProps *Props = &pSource->Props[pSource->PropWrite];
+
+    Props->Pitch         = pSource->flPitch;
+    Props->Gain          = pSource->flGain;
+    Props->OuterGain     = pSource->flOuterGain;
+    Props->MinGain       = pSource->flMinGain;
+    Props->MaxGain       = pSource->flMaxGain;
+    Props->InnerAngle    = pSource->flInnerAngle;
+    Props->OuterAngle    = pSource->flOuterAngle;
+    Props->RefDistance   = pSource->flRefDistance;
+    Props->MaxDistance   = pSource->flMaxDistance;
+    Props->RollOffFactor = pSource->flRollOffFactor;
+    memcpy(Props->Position,    pSource->vPosition,    sizeof(Props->Position));
+    memcpy(Props->Velocity,    pSource->vVelocity,    sizeof(Props->Velocity));
+    memcpy(Props->Orientation, pSource->vOrientation, sizeof(Props->Orientation));
+    Props->OuterGainHF         = pSource->OuterGainHF;
+    Props->AirAbsorptionFactor = pSource->AirAbsorptionFactor;
+    Props->RoomRolloffFactor   = pSource->RoomRolloffFactor;
+    Props->DopplerFactor       = pSource->DopplerFactor;
+    Props->Priority            = pSource->Priority;
+
+    pSource->PropWrite = ExchangeInt(&pSource->PropState,
+                                     pSource->PropWrite|PROPS_FRESH) &
+                         PROPS_INDEX_MASK;
+}
+
+
+/*
+    ApplyDeferredSourceProps
+
+    Publishes the source changes held back by alDeferUpdatesEXT, and updates
+    the sources if the listener changed meanwhile. The caller must hold the
+    context lock and the property lock.
+*/
+ALvoid ApplyDeferredSourceProps(ALCcontext *Context)
+{
+    ALsource *pSource;
+
+    for(pSource = Context->Source;pSource;pSource = pSource->next)
+    {
+        if(pSource->PropsDeferred)
+        {
+            PublishSourceProps(pSource);
+            pSource->PropsDeferred = AL_FALSE;
+        }
+        if(Context->UpdateSources)
+            pSource->NeedsUpdate = AL_TRUE;
+    }
 }
 
 
@@ -1843,7 +2296,6 @@ static ALvoid InitSourceParams(ALsource *pSource)
 */
 static ALboolean GetSourceOffset(ALsource *pSource, ALenum eName, ALfloat *pflOffset, ALuint updateSize)
 {
-    ALbufferlistitem *pBufferList;
     ALbuffer         *pBuffer;
     ALfloat        flBufferFreq;
     ALint        lChannels, lBytes;
@@ -1851,7 +2303,6 @@ static ALboolean GetSourceOffset(ALsource *pSource, ALenum eName, ALfloat *pflOf
     ALenum        eOriginalFormat;
     ALboolean    bReturn = AL_TRUE;
     ALint        lTotalBufferDataSize;
-    ALuint       i;
 
     if((pSource->state == AL_PLAYING || pSource->state == AL_PAUSED) && pSource->Buffer)
     {
@@ -1862,30 +2313,21 @@ static ALboolean GetSourceOffset(ALsource *pSource, ALenum eName, ALfloat *pflOf
         lChannels = aluChannelsFromFormat(pBuffer->format);
         lBytes = aluBytesFromFormat(pBuffer->format);
 
+        lTotalBufferDataSize = GetQueueSize(pSource);
+
         // Get Current BytesPlayed
         readPos = pSource->position * lChannels * lBytes; // NOTE : This is the byte offset into the *current* buffer
         // Add byte length of any processed buffers in the queue
-        pBufferList = pSource->queue;
-        for(i = 0;i < pSource->BuffersPlayed && pBufferList;i++)
-        {
-            readPos += pBufferList->buffer->size;
-            pBufferList = pBufferList->next;
-        }
+        if(pSource->CurrentItem)
+            readPos += pSource->CurrentItem->Start - pSource->queue->Start;
+        else
+            readPos += lTotalBufferDataSize;
 
         if(pSource->state == AL_PLAYING)
             writePos = readPos + (updateSize * lChannels * lBytes);
         else
             writePos = readPos;
 
-        lTotalBufferDataSize = 0;
-        pBufferList = pSource->queue;
-        while (pBufferList)
-        {
-            if (pBufferList->buffer)
-                lTotalBufferDataSize += pBufferList->buffer->size;
-            pBufferList = pBufferList->next;
-        }
-
         if (pSource->bLooping)
         {
             if(readPos < 0)
@@ -1980,51 +2422,52 @@ static ALboolean GetSourceOffset(ALsource *pSource, ALenum eName, ALfloat *pflOf
 */
 static ALboolean ApplyOffset(ALsource *pSource)
 {
+    ALbufferlistitem   **pItems;
     ALbufferlistitem    *pBufferList;
     ALbuffer            *pBuffer;
-    ALint                lBufferSize, lTotalBufferSize;
+    ALuint               lItemOffset;
     ALint                lByteOffset;
+    ALuint               lLow, lHigh, lMid;
 
-    // Get true byte offset
-    lByteOffset = GetByteOffset(pSource);
+    // Get true byte offset, and clear the requested one
+    lByteOffset = GetByteOffset(pSource, pSource->lOffsetType, pSource->lOffset);
+    pSource->lOffset = 0;
 
     // If the offset is invalid, don't apply it
     if(lByteOffset == -1)
         return AL_FALSE;
 
-    // Sort out the queue (pending and processed states)
-    pBufferList = pSource->queue;
-    lTotalBufferSize = 0;
-    pSource->BuffersPlayed = 0;
+    // Sort out the queue (pending and processed states). Where each item
+    // ends only goes up along the queue, so binary search the index for the
+    // first item that ends past the offset. The ones before it are played.
+    pItems = pSource->QueueIndex + pSource->QueueIndexHead;
+    lLow = 0;
+    lHigh = pSource->BuffersInQueue;
+    while(lLow < lHigh)
+    {
+        lMid = lLow + (lHigh-lLow)/2;
+        lItemOffset = pItems[lMid]->Start - pSource->queue->Start;
+        if(lItemOffset + GetItemSize(pItems[lMid]) <= (ALuint)lByteOffset)
+            lLow = lMid+1;
+        else
+            lHigh = lMid;
+    }
+    pSource->BuffersPlayed = lLow;
 
-    while(pBufferList)
+    if(lLow < pSource->BuffersInQueue)
     {
+        // Offset is within this buffer
+        // Set Current Buffer
+        pBufferList = pItems[lLow];
+        lItemOffset = pBufferList->Start - pSource->queue->Start;
         pBuffer = pBufferList->buffer;
-        lBufferSize = pBuffer ? pBuffer->size : 0;
-
-        if(lTotalBufferSize+lBufferSize <= lByteOffset)
-        {
-            // Offset is past this buffer so increment BuffersPlayed
-            pSource->BuffersPlayed++;
-        }
-        else if(lTotalBufferSize <= lByteOffset)
-        {
-            // Offset is within this buffer
-            // Set Current Buffer
-            pSource->Buffer = pBufferList->buffer;
-
-            // SW Mixer Positions are in Samples
-            pSource->position = (lByteOffset - lTotalBufferSize) /
-                                aluBytesFromFormat(pBuffer->format) /
-                                aluChannelsFromFormat(pBuffer->format);
-            break;
-        }
+        pSource->Buffer = pBuffer;
+        pSource->CurrentItem = pBufferList;
 
-        // Increment the TotalBufferSize
-        lTotalBufferSize += lBufferSize;
-
-        // Move on to next buffer in the Queue
-        pBufferList = pBufferList->next;
+        // SW Mixer Positions are in Samples
+        pSource->position = (lByteOffset - lItemOffset) /
+                            aluBytesFromFormat(pBuffer->format) /
+                            aluChannelsFromFormat(pBuffer->format);
     }
 
     return AL_TRUE;
@@ -2035,10 +2478,10 @@ static ALboolean ApplyOffset(ALsource *pSource)
     GetByteOffset
 
     Returns the 'true' byte offset into the Source's queue (from the Sample, Byte or Millisecond
-    offset supplied by the application).   This takes into account the fact that the buffer format
-    may have been modifed by AL (e.g 8bit samples are converted to float)
+    offset supplied by the application), or -1 if it's past the end.   This takes into account the
+    fact that the buffer format may have been modifed by AL (e.g 8bit samples are converted to float)
 */
-static ALint GetByteOffset(ALsource *pSource)
+static ALint GetByteOffset(const ALsource *pSource, ALint lOffsetType, ALint lOffset)
 {
     ALbuffer *pBuffer = NULL;
     ALbufferlistitem *pBufferList;
@@ -2068,7 +2511,7 @@ static ALint GetByteOffset(ALsource *pSource)
         OriginalFormat = pBuffer->eOriginalFormat;
 
         // Determine the ByteOffset (and ensure it is block aligned)
-        switch (pSource->lOffsetType)
+        switch (lOffsetType)
         {
         case AL_BYTE_OFFSET:
             // Take into consideration the original format
@@ -2076,62 +2519,52 @@ static ALint GetByteOffset(ALsource *pSource)
                OriginalFormat == AL_FORMAT_STEREO_IMA4)
             {
                 // Round down to nearest ADPCM block
-                lByteOffset = pSource->lOffset / (36 * lChannels);
+                lByteOffset = lOffset / (36 * lChannels);
                 // Multiply by compression rate
                 lByteOffset = lByteOffset * 65 * lChannels * lBytes;
                 lByteOffset -= (lByteOffset % (lChannels * lBytes));
             }
             else if(OriginalFormat == AL_FORMAT_REAR8)
             {
-                lByteOffset = pSource->lOffset / 1 * lBytes * 2;
+                lByteOffset = lOffset / 1 * lBytes * 2;
                 lByteOffset -= (lByteOffset % (lChannels * lBytes));
             }
             else if(OriginalFormat == AL_FORMAT_REAR16)
             {
-                lByteOffset = pSource->lOffset / 2 * lBytes * 2;
+                lByteOffset = lOffset / 2 * lBytes * 2;
                 lByteOffset -= (lByteOffset % (lChannels * lBytes));
             }
             else if(OriginalFormat == AL_FORMAT_REAR32)
             {
-                lByteOffset = pSource->lOffset / 4 * lBytes * 2;
+                lByteOffset = lOffset / 4 * lBytes * 2;
                 lByteOffset -= (lByteOffset % (lChannels * lBytes));
             }
             else
             {
                 ALuint OrigBytes = aluBytesFromFormat(OriginalFormat);
-                lByteOffset = pSource->lOffset / OrigBytes * lBytes;
+                lByteOffset = lOffset / OrigBytes * lBytes;
                 lByteOffset -= (lByteOffset % (lChannels * lBytes));
             }
             break;
 
         case AL_SAMPLE_OFFSET:
-            lByteOffset = pSource->lOffset * lChannels * lBytes;
+            lByteOffset = lOffset * lChannels * lBytes;
             break;
 
         case AL_SEC_OFFSET:
             // Note - lOffset is internally stored as Milliseconds
-            lByteOffset = (ALint)(pSource->lOffset / 1000.0f * flBufferFreq);
+            lByteOffset = (ALint)(lOffset / 1000.0f * flBufferFreq);
             lByteOffset *= lChannels * lBytes;
             break;
         }
 
-        lTotalBufferDataSize = 0;
-        pBufferList = pSource->queue;
-        while (pBufferList)
-        {
-            if (pBufferList->buffer)
-                lTotalBufferDataSize += pBufferList->buffer->size;
-            pBufferList = pBufferList->next;
-        }
+        lTotalBufferDataSize = GetQueueSize(pSource);
 
         // Finally, if the ByteOffset is beyond the length of all the buffers in the queue, return -1
         if (lByteOffset >= lTotalBufferDataSize)
             lByteOffset = -1;
     }
 
-    // Clear Offset
-    pSource->lOffset = 0;
-
     return lByteOffset;
 }
 
@@ -2155,8 +2588,9 @@ ALvoid ReleaseALSources(ALCcontext *Context)
             // Update queue to point to next element in list
             temp->queue = ALBufferList->next;
             // Release memory allocated for buffer list item
-            free(ALBufferList);
+            PoolFree(&Context->BufferListPool, ALBufferList);
         }
+        free(temp->QueueIndex);
 
         for(j = 0;j < MAX_SENDS;++j)
         {
@@ -2167,7 +2601,8 @@ ALvoid ReleaseALSources(ALCcontext *Context)
         // Release source structure
         ALTHUNK_REMOVEENTRY(temp->source);
         memset(temp, 0, sizeof(ALsource));
-        free(temp);
+        PoolFree(&Context->SourcePool, temp);
     }
+    Context->SourceTail = NULL;
     Context->SourceCount = 0;
 }
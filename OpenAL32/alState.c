@@ -21,6 +21,7 @@
 #include "config.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include "alMain.h"
 #include "AL/alc.h"
 #include "AL/alext.h"
@@ -28,6 +29,7 @@
 #include "alSource.h"
 #include "alState.h"
 #include "alDatabuffer.h"
+#include "alu.h"
 
 static const ALchar alVendor[] = "OpenAL Community";
 static const ALchar alVersion[] = "1.1 ALSOFT "ALSOFT_VERSION;
@@ -161,6 +163,10 @@ ALAPI ALboolean ALAPIENTRY alGetBoolean(ALenum pname)
                 value = AL_TRUE;
             break;
 
+        case AL_DEFERRED_UPDATES_EXT:
+            value = Context->DeferUpdates;
+            break;
+
         default:
             alSetError(AL_INVALID_ENUM);
             break;
@@ -197,6 +203,10 @@ ALAPI ALdouble ALAPIENTRY alGetDouble(ALenum pname)
             value = (double)Context->flSpeedOfSound;
             break;
 
+        case AL_DEFERRED_UPDATES_EXT:
+            value = (double)Context->DeferUpdates;
+            break;
+
         default:
             alSetError(AL_INVALID_ENUM);
             break;
@@ -233,6 +243,10 @@ ALAPI ALfloat ALAPIENTRY alGetFloat(ALenum pname)
             value = Context->flSpeedOfSound;
             break;
 
+        case AL_DEFERRED_UPDATES_EXT:
+            value = (float)Context->DeferUpdates;
+            break;
+
         default:
             alSetError(AL_INVALID_ENUM);
             break;
@@ -269,6 +283,10 @@ ALAPI ALint ALAPIENTRY alGetInteger(ALenum pname)
             value = (ALint)Context->flSpeedOfSound;
             break;
 
+        case AL_DEFERRED_UPDATES_EXT:
+            value = (ALint)Context->DeferUpdates;
+            break;
+
         case AL_SAMPLE_SOURCE_EXT:
             if(Context->SampleSource)
                 value = (ALint)Context->SampleSource->databuffer;
@@ -320,6 +338,10 @@ ALAPI ALvoid ALAPIENTRY alGetBooleanv(ALenum pname,ALboolean *data)
                 *data = (ALboolean)((Context->flSpeedOfSound != 0.0f) ? AL_TRUE : AL_FALSE);
                 break;
 
+            case AL_DEFERRED_UPDATES_EXT:
+                *data = Context->DeferUpdates;
+                break;
+
             default:
                 alSetError(AL_INVALID_ENUM);
                 break;
@@ -361,6 +383,10 @@ ALAPI ALvoid ALAPIENTRY alGetDoublev(ALenum pname,ALdouble *data)
                 *data = (double)Context->flSpeedOfSound;
                 break;
 
+            case AL_DEFERRED_UPDATES_EXT:
+                *data = (double)Context->DeferUpdates;
+                break;
+
             default:
                 alSetError(AL_INVALID_ENUM);
                 break;
@@ -402,6 +428,10 @@ ALAPI ALvoid ALAPIENTRY alGetFloatv(ALenum pname,ALfloat *data)
                 *data = Context->flSpeedOfSound;
                 break;
 
+            case AL_DEFERRED_UPDATES_EXT:
+                *data = (float)Context->DeferUpdates;
+                break;
+
             default:
                 alSetError(AL_INVALID_ENUM);
                 break;
@@ -443,6 +473,10 @@ ALAPI ALvoid ALAPIENTRY alGetIntegerv(ALenum pname,ALint *data)
                 *data = (ALint)Context->flSpeedOfSound;
                 break;
 
+            case AL_DEFERRED_UPDATES_EXT:
+                *data = (ALint)Context->DeferUpdates;
+                break;
+
             case AL_SAMPLE_SOURCE_EXT:
                 if(Context->SampleSource)
                     *data = (ALint)Context->SampleSource->databuffer;
@@ -659,3 +693,70 @@ ALAPI ALvoid ALAPIENTRY alDistanceModel(ALenum value)
 
     ProcessContext(Context);
 }
+
+/*
+    alDeferUpdatesEXT
+
+    Holds back source property and listener changes until
+    alProcessUpdatesEXT, so a whole frame's worth of them can be applied at
+    once
+*/
+ALAPI ALvoid ALAPIENTRY alDeferUpdatesEXT(ALvoid)
+{
+    ALCcontext *Context;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    // Listener setters check this with the context lock, and source setters
+    // with the property lock, so both are needed to change it
+    LockProps();
+    if(!Context->DeferUpdates)
+    {
+        // Listener changes are made to a copy until they're applied
+        Context->DeferredListener = Context->Listener;
+        Context->DeferUpdates = AL_TRUE;
+    }
+    UnlockProps();
+
+    ProcessContext(Context);
+}
+
+/*
+    alProcessUpdatesEXT
+
+    Applies the source and listener changes held back since
+    alDeferUpdatesEXT. The mixer can't run in the meantime, so they all take
+    effect on the same update.
+*/
+ALAPI ALvoid ALAPIENTRY alProcessUpdatesEXT(ALvoid)
+{
+    ALCcontext *Context;
+
+    Context = GetContextSuspended();
+    if(!Context) return;
+
+    LockProps();
+    if(Context->DeferUpdates)
+    {
+        if(Context->UpdateSources)
+        {
+            ALlistener *Listener = &Context->Listener;
+            const ALlistener *Deferred = &Context->DeferredListener;
+
+            memcpy(Listener->Position, Deferred->Position, sizeof(Listener->Position));
+            memcpy(Listener->Velocity, Deferred->Velocity, sizeof(Listener->Velocity));
+            memcpy(Listener->Forward, Deferred->Forward, sizeof(Listener->Forward));
+            memcpy(Listener->Up, Deferred->Up, sizeof(Listener->Up));
+            Listener->Gain = Deferred->Gain;
+            Listener->MetersPerUnit = Deferred->MetersPerUnit;
+            aluUpdateListener(Context);
+        }
+        ApplyDeferredSourceProps(Context);
+        Context->UpdateSources = AL_FALSE;
+        Context->DeferUpdates = AL_FALSE;
+    }
+    UnlockProps();
+
+    ProcessContext(Context);
+}
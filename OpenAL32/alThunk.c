@@ -25,86 +25,191 @@
 #include "alMain.h"
 #include "alThunk.h"
 
+/* Handles are made up of an index into the table, and the generation of that
+ * entry when the handle was given out. An entry's generation changes every
+ * time it's reused, so a stale handle for a deleted object won't find the
+ * object that took its place. Generation 0 is never used, so no handle is
+ * 0. */
+#define THUNK_INDEX_BITS   20
+#define THUNK_INDEX_MASK   ((1<<THUNK_INDEX_BITS)-1)
+#define THUNK_GEN_MASK     ((1<<(32-THUNK_INDEX_BITS))-1)
+
+/* The table is allocated in blocks that are never moved or freed until the
+ * library is unloaded, so lookups can read it without taking the lock. */
+#define THUNK_BLOCK_BITS   10
+#define THUNK_BLOCK_SIZE   (1<<THUNK_BLOCK_BITS)
+#define THUNK_MAX_BLOCKS   (1<<(THUNK_INDEX_BITS-THUNK_BLOCK_BITS))
+
 typedef struct {
     ALvoid *ptr;
-    ALboolean InUse;
+    ThunkType Type;
+    const ALvoid *Owner; // The context or device the object belongs to
+    // The handle currently referring to this entry, or 0 if it's free
+    volatile ALuint Handle;
+    ALuint Generation;
+    ALuint NextFree;
 } ThunkEntry;
 
-static ThunkEntry *g_ThunkArray;
-static ALuint      g_ThunkArraySize;
+static ThunkEntry *volatile g_ThunkBlocks[THUNK_MAX_BLOCKS];
+static ALuint               g_ThunkBlockCount;
+
+/* Free entries are reused in the order they were freed, so an entry's
+ * generation goes around as slowly as possible. The lock is only needed to
+ * add and remove entries. */
+static ALuint g_ThunkFreeHead;
+static ALuint g_ThunkFreeTail;
+static ALuint g_ThunkFreeCount;
 
 static CRITICAL_SECTION g_ThunkLock;
 
+static __inline ThunkEntry *GetThunkEntry(ALuint index)
+{
+    return &g_ThunkBlocks[index>>THUNK_BLOCK_BITS][index&(THUNK_BLOCK_SIZE-1)];
+}
+
+static void PushFreeEntry(ALuint index)
+{
+    GetThunkEntry(index)->NextFree = 0;
+    if(g_ThunkFreeCount == 0)
+        g_ThunkFreeHead = index;
+    else
+        GetThunkEntry(g_ThunkFreeTail)->NextFree = index;
+    g_ThunkFreeTail = index;
+    g_ThunkFreeCount++;
+}
+
 void alThunkInit(void)
 {
     InitializeCriticalSection(&g_ThunkLock);
-    g_ThunkArraySize = 1;
-    g_ThunkArray = calloc(1, g_ThunkArraySize * sizeof(ThunkEntry));
+    g_ThunkBlockCount = 0;
+    g_ThunkFreeCount = 0;
 }
 
 void alThunkExit(void)
 {
-    free(g_ThunkArray);
-    g_ThunkArray = NULL;
-    g_ThunkArraySize = 0;
+    ALuint i;
+
+    for(i = 0;i < g_ThunkBlockCount;i++)
+    {
+        free(g_ThunkBlocks[i]);
+        g_ThunkBlocks[i] = NULL;
+    }
+    g_ThunkBlockCount = 0;
+    g_ThunkFreeCount = 0;
     DeleteCriticalSection(&g_ThunkLock);
 }
 
-ALuint alThunkAddEntry(ALvoid *ptr)
+ALuint alThunkAddEntry(ALvoid *ptr, ThunkType type, const ALvoid *owner)
 {
+    ThunkEntry *entry;
     ALuint index;
 
     EnterCriticalSection(&g_ThunkLock);
 
-    for(index = 0;index < g_ThunkArraySize;index++)
-    {
-        if(g_ThunkArray[index].InUse == AL_FALSE)
-            break;
-    }
-
-    if(index == g_ThunkArraySize)
+    if(g_ThunkFreeCount == 0)
     {
-        ThunkEntry *NewList;
+        ThunkEntry *NewBlock;
 
-        NewList = realloc(g_ThunkArray, g_ThunkArraySize*2 * sizeof(ThunkEntry));
-        if(!NewList)
+        if(g_ThunkBlockCount == THUNK_MAX_BLOCKS ||
+           !(NewBlock=calloc(THUNK_BLOCK_SIZE, sizeof(ThunkEntry))))
         {
             LeaveCriticalSection(&g_ThunkLock);
             return 0;
         }
-        memset(&NewList[g_ThunkArraySize], 0, g_ThunkArraySize*sizeof(ThunkEntry));
-        g_ThunkArraySize *= 2;
-        g_ThunkArray = NewList;
+        // The cleared block must be visible before lookups can find it
+        WriteBarrier();
+        g_ThunkBlocks[g_ThunkBlockCount] = NewBlock;
+        for(index = 0;index < THUNK_BLOCK_SIZE;index++)
+            PushFreeEntry((g_ThunkBlockCount<<THUNK_BLOCK_BITS) | index);
+        g_ThunkBlockCount++;
     }
 
-    g_ThunkArray[index].ptr = ptr;
-    g_ThunkArray[index].InUse = AL_TRUE;
+    index = g_ThunkFreeHead;
+    entry = GetThunkEntry(index);
+    g_ThunkFreeHead = entry->NextFree;
+    g_ThunkFreeCount--;
+
+    entry->Generation = (entry->Generation+1) & THUNK_GEN_MASK;
+    if(entry->Generation == 0)
+        entry->Generation = 1;
+
+    /* The entry's removal has to be seen before it's refilled, and it has to
+     * be filled before the new handle is seen. See FindEntry. */
+    WriteBarrier();
+    entry->ptr = ptr;
+    entry->Type = type;
+    entry->Owner = owner;
+    WriteBarrier();
+    entry->Handle = (entry->Generation<<THUNK_INDEX_BITS) | index;
 
     LeaveCriticalSection(&g_ThunkLock);
 
-    return index+1;
+    return entry->Handle;
 }
 
-void alThunkRemoveEntry(ALuint index)
+void alThunkRemoveEntry(ALuint handle)
 {
+    ALuint index = handle&THUNK_INDEX_MASK;
+    ThunkEntry *entry;
+
     EnterCriticalSection(&g_ThunkLock);
 
-    if(index > 0 && index <= g_ThunkArraySize)
-        g_ThunkArray[index-1].InUse = AL_FALSE;
+    if((index>>THUNK_BLOCK_BITS) < g_ThunkBlockCount)
+    {
+        entry = GetThunkEntry(index);
+        if(entry->Handle == handle)
+        {
+            entry->Handle = 0;
+            PushFreeEntry(index);
+        }
+    }
 
     LeaveCriticalSection(&g_ThunkLock);
 }
 
-ALvoid *alThunkLookupEntry(ALuint index)
+/* Lookups don't take the lock. An entry is read between two checks of its
+ * handle, with barriers keeping the reads in between. alThunkAddEntry clears
+ * the old handle before changing the entry and sets the new handle after, so
+ * if both checks match, what was read belongs to that handle. A lookup that
+ * races with the handle's removal gets either the object or NULL, same as if
+ * it came just before or after. */
+static __inline ALboolean FindEntry(ALuint handle, ThunkEntry *found)
 {
-    ALvoid *ptr = NULL;
+    ALuint block = (handle&THUNK_INDEX_MASK) >> THUNK_BLOCK_BITS;
+    ThunkEntry *blockEntries = g_ThunkBlocks[block];
+    ThunkEntry *entry;
+
+    if(handle == 0 || !blockEntries)
+        return AL_FALSE;
+    entry = &blockEntries[handle&(THUNK_BLOCK_SIZE-1)];
+
+    if(entry->Handle != handle)
+        return AL_FALSE;
+    ReadBarrier();
+    found->ptr = entry->ptr;
+    found->Type = entry->Type;
+    found->Owner = entry->Owner;
+    ReadBarrier();
+    return (entry->Handle == handle);
+}
 
-    EnterCriticalSection(&g_ThunkLock);
+ALvoid *alThunkLookupEntry(ALuint handle)
+{
+    ThunkEntry found;
 
-    if(index > 0 && index <= g_ThunkArraySize)
-        ptr = g_ThunkArray[index-1].ptr;
+    if(!FindEntry(handle, &found))
+        return NULL;
+    return found.ptr;
+}
 
-    LeaveCriticalSection(&g_ThunkLock);
+/* Looks up an object of the given type belonging to the given context or
+ * device. This is how object names are validated, so it must not find
+ * anything for a handle that isn't valid. */
+ALvoid *alThunkLookupObject(ALuint handle, ThunkType type, const ALvoid *owner)
+{
+    ThunkEntry found;
 
-    return ptr;
+    if(!FindEntry(handle, &found) || found.Type != type || found.Owner != owner)
+        return NULL;
+    return found.ptr;
 }
@@ -0,0 +1,72 @@
+#ifndef EXAMPLES_CPUCAPS_H
+#define EXAMPLES_CPUCAPS_H
+
+/* The CPU extensions the mixer's kernels may use, found the same way the
+ * library finds them (see FillCPUCaps in Alc/ALc.c), for the programs that
+ * run the kernels directly. Needs config.h and alMain.h. */
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_CPUID_H
+#include <cpuid.h>
+#endif
+#ifdef HAVE_INTRIN_H
+#include <intrin.h>
+#endif
+
+static ALuint GetCPUCaps(void)
+{
+    ALuint caps = 0;
+
+#if defined(HAVE_GCC_GET_CPUID)
+    unsigned int eax, ebx, ecx, edx;
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        if((edx&(1<<25)))
+            caps |= CPU_CAP_SSE;
+        if((edx&(1<<26)))
+            caps |= CPU_CAP_SSE2;
+    }
+#elif defined(HAVE_CPUID_INTRINSIC)
+    int cpuinf[4];
+    __cpuid(cpuinf, 0);
+    if(cpuinf[0] >= 1)
+    {
+        __cpuid(cpuinf, 1);
+        if((cpuinf[3]&(1<<25)))
+            caps |= CPU_CAP_SSE;
+        if((cpuinf[3]&(1<<26)))
+            caps |= CPU_CAP_SSE2;
+    }
+#elif (defined(HAVE_SSE) || defined(HAVE_SSE2)) && (defined(__x86_64__) || defined(_M_X64))
+    caps |= CPU_CAP_SSE | CPU_CAP_SSE2;
+#endif
+
+#ifdef HAVE_NEON
+#if defined(__aarch64__) || defined(_M_ARM64)
+    caps |= CPU_CAP_NEON;
+#else
+    {
+        FILE *file = fopen("/proc/cpuinfo", "rb");
+        char line[1024];
+        if(file)
+        {
+            while(fgets(line, sizeof(line), file) != NULL)
+            {
+                if(strncmp(line, "Features", 8) != 0)
+                    continue;
+                if(strstr(line, " neon") != NULL)
+                    caps |= CPU_CAP_NEON;
+                break;
+            }
+            fclose(file);
+        }
+    }
+#endif
+#endif
+
+    return caps;
+}
+
+#endif /* EXAMPLES_CPUCAPS_H */
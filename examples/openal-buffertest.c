@@ -0,0 +1,610 @@
+/*
+ * Checks buffers that play from the app's own memory (AL_EXTX_static_buffer)
+ * or from a mapped sound bank file (AL_EXTX_sound_bank) through the public
+ * API. The errors for data that can't be used in place, the attributes of
+ * the data that can, when it's released, and that a source plays it are all
+ * checked. The sound banks are written to the current directory. Buffers
+ * loaded the usual way must keep their sample type. Needs a device to open,
+ * which can be the wave writer.
+ *
+ * Usage: openal-buffertest [ima4-compressed]
+ *
+ * Pass ima4-compressed when the config has the option of the same name set,
+ * so loaded IMA4 data is expected to stay compressed.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "AL/alc.h"
+#include "AL/al.h"
+#include "AL/alext.h"
+
+/* Long enough to still be playing when it's checked */
+#define NUM_SAMPLES  22050
+#define IMA4_BLOCKS  200
+
+static ALshort Samples[NUM_SAMPLES+1];
+static ALuint Ima4Data[IMA4_BLOCKS*36/4];
+
+static PFNALBUFFERDATASTATICEXTPROC palBufferDataStaticEXT;
+static PFNALBUFFERSUBDATAEXTPROC palBufferSubDataEXT;
+static PFNALBUFFERDATAFROMBANKEXTPROC palBufferDataFromBankEXT;
+
+#define BANK_NAME  "openal-buffertest.alsb"
+
+/* A sound bank with a mono 16-bit, a stereo float and a mono IMA4 entry.
+ * Each entry's data starts on a 16-byte boundary. */
+#define BANK_ENTRIES     3
+#define BANK_FLOATS      (NUM_SAMPLES/2)
+#define BANK_IMA4_BLOCKS IMA4_BLOCKS
+#define BANK_OFFSET0     64
+#define BANK_OFFSET1     (BANK_OFFSET0 + ((NUM_SAMPLES*2+15)&~15))
+#define BANK_OFFSET2     (BANK_OFFSET1 + BANK_FLOATS*2*4)
+#define BANK_SIZE        (BANK_OFFSET2 + BANK_IMA4_BLOCKS*36)
+
+static ALubyte Bank[BANK_SIZE];
+
+static ALboolean Ima4Compressed;
+
+static int Failed;
+
+#define CHECK(cond) do {                                                      \
+    if(!(cond))                                                               \
+    {                                                                         \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);       \
+        Failed++;                                                             \
+    }                                                                         \
+} while(0)
+
+#define CHECK_ERROR(expected) do {                                            \
+    ALenum err = alGetError();                                                \
+    if(err != (expected))                                                     \
+    {                                                                         \
+        printf("%s:%d: got error 0x%04x, expected %s\n", __FILE__, __LINE__, \
+               err, #expected);                                               \
+        Failed++;                                                             \
+    }                                                                         \
+} while(0)
+
+/* What the release callback was last called with */
+static struct {
+    ALuint count;
+    ALuint buffer;
+    const ALvoid *data;
+    ALvoid *userptr;
+} Released;
+
+static ALvoid AL_APIENTRY ReleaseData(ALuint buffer, const ALvoid *data, ALvoid *userptr)
+{
+    Released.count++;
+    Released.buffer = buffer;
+    Released.data = data;
+    Released.userptr = userptr;
+}
+
+static void CheckBufferAttribs(ALuint buffer, ALint size, ALint freq, ALint bits, ALint channels)
+{
+    ALint val;
+
+    alGetBufferi(buffer, AL_SIZE, &val);
+    CHECK(val == size);
+    alGetBufferi(buffer, AL_FREQUENCY, &val);
+    CHECK(val == freq);
+    alGetBufferi(buffer, AL_BITS, &val);
+    CHECK(val == bits);
+    alGetBufferi(buffer, AL_CHANNELS, &val);
+    CHECK(val == channels);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+/* Plays the buffer until the source has moved past its start. Stops it
+ * again, and leaves the buffer attached. */
+static void CheckPlays(ALuint source, ALuint buffer)
+{
+    ALint offset = 0, state = AL_PLAYING;
+    int tries;
+
+    alSourcei(source, AL_BUFFER, buffer);
+    alSourcePlay(source);
+    CHECK_ERROR(AL_NO_ERROR);
+    for(tries = 0;tries < 200 && offset == 0 && state == AL_PLAYING;tries++)
+    {
+        usleep(10000);
+        alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+        alGetSourcei(source, AL_SOURCE_STATE, &state);
+    }
+    CHECK(offset > 0 && state == AL_PLAYING);
+    alSourceStop(source);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+static void PutLE32(ALubyte *dst, ALuint val)
+{
+    dst[0] = val&0xff;
+    dst[1] = (val>>8)&0xff;
+    dst[2] = (val>>16)&0xff;
+    dst[3] = (val>>24)&0xff;
+}
+
+static void PutEntry(ALuint idx, ALenum format, ALuint freq, ALuint offset, ALuint size)
+{
+    ALubyte *entry = Bank + 12 + idx*16;
+    PutLE32(entry, format);
+    PutLE32(entry+4, freq);
+    PutLE32(entry+8, offset);
+    PutLE32(entry+12, size);
+}
+
+/* Fills in Bank. The samples are written as little-endian, which is all the
+ * bank loader takes. */
+static void MakeBank(void)
+{
+    ALuint i;
+
+    memset(Bank, 0, sizeof(Bank));
+    memcpy(Bank, "ALSB", 4);
+    PutLE32(Bank+4, 1);
+    PutLE32(Bank+8, BANK_ENTRIES);
+    PutEntry(0, AL_FORMAT_MONO16, 22050, BANK_OFFSET0, NUM_SAMPLES*2);
+    PutEntry(1, AL_FORMAT_STEREO_FLOAT32, 44100, BANK_OFFSET1, BANK_FLOATS*2*4);
+    PutEntry(2, AL_FORMAT_MONO_IMA4, 22050, BANK_OFFSET2, BANK_IMA4_BLOCKS*36);
+
+    for(i = 0;i < NUM_SAMPLES;i++)
+    {
+        Bank[BANK_OFFSET0 + i*2 + 0] = Samples[i]&0xff;
+        Bank[BANK_OFFSET0 + i*2 + 1] = (Samples[i]>>8)&0xff;
+    }
+    for(i = 0;i < BANK_FLOATS*2;i++)
+    {
+        union { ALfloat f; ALuint u; } smp;
+        smp.f = (ALfloat)Samples[i] / 32768.0f;
+        PutLE32(Bank + BANK_OFFSET1 + i*4, smp.u);
+    }
+    memcpy(Bank+BANK_OFFSET2, Ima4Data, BANK_IMA4_BLOCKS*36);
+}
+
+static int WriteBank(const ALubyte *data, size_t size)
+{
+    FILE *f = fopen(BANK_NAME, "wb");
+    if(!f)
+    {
+        printf("Could not create %s\n", BANK_NAME);
+        return 0;
+    }
+    if(fwrite(data, 1, size, f) != size)
+        size = 0;
+    if(fclose(f) != 0)
+        size = 0;
+    if(size == 0)
+        printf("Could not write %s\n", BANK_NAME);
+    return (size != 0);
+}
+
+/* Returns 1 if the bank is mapped into this process, 0 if it isn't, or -1 if
+ * that can't be told */
+static int BankMapped(void)
+{
+    char line[1024];
+    int found = 0;
+    FILE *f;
+
+    f = fopen("/proc/self/maps", "r");
+    if(!f)
+        return -1;
+    while(fgets(line, sizeof(line), f))
+    {
+        if(strstr(line, BANK_NAME))
+            found = 1;
+    }
+    fclose(f);
+    return found;
+}
+
+/* Writes the bank, which loading into buffers must reject with the given
+ * error. The buffers are left empty. */
+static void CheckBadBankData(const char *desc, const ALubyte *data, size_t size,
+                             ALsizei n, const ALuint *buffers, ALenum expected)
+{
+    ALenum err;
+    ALsizei i;
+    ALint val2;
+
+    if(!WriteBank(data, size))
+    {
+        Failed++;
+        return;
+    }
+
+    palBufferDataFromBankEXT(BANK_NAME, n, buffers);
+    err = alGetError();
+    if(err != expected)
+    {
+        printf("%s: got error 0x%04x, expected 0x%04x\n", desc, err, expected);
+        Failed++;
+    }
+    for(i = 0;i < n;i++)
+    {
+        if(!alIsBuffer(buffers[i]) || buffers[i] == 0)
+            continue;
+        alGetBufferi(buffers[i], AL_SIZE, &val2);
+        if(val2 != 0)
+        {
+            printf("%s: buffer %d was changed\n", desc, (int)i);
+            Failed++;
+        }
+    }
+    CHECK(BankMapped() <= 0);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+/* Same as above, for a copy of Bank cut to size with one value changed */
+static void CheckBadBank(const char *desc, size_t size, ALuint pos, ALuint val,
+                         ALsizei n, const ALuint *buffers, ALenum expected)
+{
+    static ALubyte bad[BANK_SIZE];
+
+    memcpy(bad, Bank, size);
+    if(pos+4 <= size)
+        PutLE32(bad+pos, val);
+    CheckBadBankData(desc, bad, size, n, buffers, expected);
+}
+
+static void CheckSoundBanks(ALCdevice *device)
+{
+    ALuint buffers[BANK_ENTRIES+1], badNames[2], source;
+    ALubyte truncated[12 + 16 + 8];
+    ALCint memory, newMemory;
+    ALuint i;
+
+    alGenBuffers(BANK_ENTRIES+1, buffers);
+    alGenSources(1, &source);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    MakeBank();
+    remove(BANK_NAME);
+    palBufferDataFromBankEXT(BANK_NAME, BANK_ENTRIES, buffers);
+    CHECK_ERROR(AL_INVALID_VALUE);
+
+    /* Nothing is loaded unless every entry can be used */
+    CheckBadBank("bad magic", BANK_SIZE, 0, 0x58534c41, BANK_ENTRIES, buffers,
+                 AL_INVALID_VALUE);
+    CheckBadBank("bad version", BANK_SIZE, 4, 2, BANK_ENTRIES, buffers,
+                 AL_INVALID_VALUE);
+    CheckBadBank("short header", 8, 8, 0, BANK_ENTRIES, buffers,
+                 AL_INVALID_VALUE);
+    /* The only usable entry plays the header as 8-bit samples, so just the
+     * missing entries are wrong */
+    memcpy(truncated, "ALSB", 4);
+    PutLE32(truncated+4, 1);
+    PutLE32(truncated+8, 2);
+    PutLE32(truncated+12, AL_FORMAT_MONO8);
+    PutLE32(truncated+16, 22050);
+    PutLE32(truncated+20, 0);
+    PutLE32(truncated+24, 12);
+    memset(truncated+28, 0, 8);
+    CheckBadBankData("truncated entry", truncated, sizeof(truncated), 1, buffers,
+                     AL_INVALID_VALUE);
+    CheckBadBank("truncated data", BANK_SIZE-1, 8, BANK_ENTRIES, BANK_ENTRIES,
+                 buffers, AL_INVALID_VALUE);
+    CheckBadBank("data past the end", BANK_SIZE, 12 + 16*2 + 12, BANK_SIZE,
+                 BANK_ENTRIES, buffers, AL_INVALID_VALUE);
+    CheckBadBank("misaligned 16-bit data", BANK_SIZE, 12 + 8, BANK_OFFSET0+1,
+                 BANK_ENTRIES, buffers, AL_INVALID_VALUE);
+    CheckBadBank("misaligned IMA4 data", BANK_SIZE, 12 + 16*2 + 8, BANK_OFFSET2+2,
+                 BANK_ENTRIES, buffers, AL_INVALID_VALUE);
+    CheckBadBank("partial frame", BANK_SIZE, 12 + 16 + 12, BANK_FLOATS*2*4 - 4,
+                 BANK_ENTRIES, buffers, AL_INVALID_VALUE);
+    CheckBadBank("bad format", BANK_SIZE, 12 + 16, alGetEnumValue("AL_FORMAT_REAR16"),
+                 BANK_ENTRIES, buffers, AL_INVALID_ENUM);
+    CheckBadBank("too many buffers", BANK_SIZE, 8, BANK_ENTRIES, BANK_ENTRIES+1,
+                 buffers, AL_INVALID_VALUE);
+    badNames[0] = buffers[0];
+    badNames[1] = 0;
+    CheckBadBank("buffer name 0", BANK_SIZE, 8, BANK_ENTRIES, 2, badNames,
+                 AL_INVALID_NAME);
+
+    /* A good bank, loaded in place */
+    if(!WriteBank(Bank, BANK_SIZE))
+    {
+        Failed++;
+        return;
+    }
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &memory);
+    palBufferDataFromBankEXT(BANK_NAME, BANK_ENTRIES, buffers);
+    CHECK_ERROR(AL_NO_ERROR);
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &newMemory);
+    CHECK(newMemory == memory);
+    CHECK(BankMapped() != 0);
+
+    CheckBufferAttribs(buffers[0], NUM_SAMPLES*2, 22050, 16, 1);
+    CheckBufferAttribs(buffers[1], BANK_FLOATS*2*4, 44100, 32, 2);
+    CheckBufferAttribs(buffers[2], BANK_IMA4_BLOCKS*65*2, 22050, 16, 1);
+    for(i = 0;i < BANK_ENTRIES;i++)
+    {
+        CheckPlays(source, buffers[i]);
+        alSourcei(source, AL_BUFFER, 0);
+    }
+
+    /* The mapping stays open until the last buffer using it is done */
+    alBufferData(buffers[0], AL_FORMAT_MONO16, Samples, 64, 22050);
+    alDeleteBuffers(1, &buffers[1]);
+    CHECK_ERROR(AL_NO_ERROR);
+    CHECK(BankMapped() != 0);
+    alDeleteBuffers(1, &buffers[2]);
+    CHECK(BankMapped() <= 0);
+
+    /* Fewer buffers than entries takes the first entries */
+    palBufferDataFromBankEXT(BANK_NAME, 1, &buffers[3]);
+    CHECK_ERROR(AL_NO_ERROR);
+    CheckBufferAttribs(buffers[3], NUM_SAMPLES*2, 22050, 16, 1);
+    alDeleteBuffers(1, &buffers[3]);
+    CHECK(BankMapped() <= 0);
+
+    alDeleteSources(1, &source);
+    alDeleteBuffers(1, &buffers[0]);
+    CHECK_ERROR(AL_NO_ERROR);
+    remove(BANK_NAME);
+}
+
+/* Loaded samples are stored in their own type, apart from the formats that
+ * get converted */
+static const struct {
+    const char *name;
+    ALenum format;
+    ALsizei size;
+    ALint storedSize;
+    ALint bits;
+    ALint channels;
+} NativeFormats[] = {
+    { "AL_FORMAT_MONO8", AL_FORMAT_MONO8, 64, 64, 8, 1 },
+    { "AL_FORMAT_STEREO16", AL_FORMAT_STEREO16, 256, 256, 16, 2 },
+    { "AL_FORMAT_MONO_FLOAT32", AL_FORMAT_MONO_FLOAT32, 256, 256, 32, 1 },
+    { "AL_FORMAT_QUAD16_LOKI", AL_FORMAT_QUAD16_LOKI, 256, 256, 16, 4 },
+    /* Rear pairs are put in the back half of quad frames */
+    { "AL_FORMAT_REAR8", AL_FORMAT_REAR8, 64, 128, 8, 4 },
+    { "AL_FORMAT_REAR16", AL_FORMAT_REAR16, 128, 256, 16, 4 },
+    /* IMA4 reports 16-bit, 65 samples from each 36-byte block, whether it's
+     * decoded or not */
+    { "AL_FORMAT_MONO_IMA4", AL_FORMAT_MONO_IMA4, 72, 260, 16, 1 },
+    { NULL, 0, 0, 0, 0, 0 }
+};
+
+static void CheckNativeFormats(ALCdevice *device)
+{
+    ALuint buffers[2], source;
+    ALCint memory, newMemory;
+    ALint expected;
+    ALuint i;
+
+    alGenBuffers(2, buffers);
+    alGenSources(1, &source);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    for(i = 0;NativeFormats[i].name;i++)
+    {
+        alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &memory);
+        alBufferData(buffers[0], NativeFormats[i].format, Samples, NativeFormats[i].size,
+                     22050);
+        alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &newMemory);
+        CHECK_ERROR(AL_NO_ERROR);
+        CheckBufferAttribs(buffers[0], NativeFormats[i].storedSize, 22050,
+                           NativeFormats[i].bits, NativeFormats[i].channels);
+        expected = NativeFormats[i].storedSize;
+        if(Ima4Compressed && NativeFormats[i].format == AL_FORMAT_MONO_IMA4)
+            expected = NativeFormats[i].size;
+        if(newMemory-memory != expected)
+        {
+            printf("%s: buffer memory grew by %d, expected %d\n", NativeFormats[i].name,
+                   newMemory-memory, expected);
+            Failed++;
+        }
+        /* Free it, so the next one counts all of its memory */
+        alBufferData(buffers[0], AL_FORMAT_MONO8, Samples, 0, 22050);
+    }
+
+    /* New samples are widened to the type the buffer has, but can't be
+     * narrowed to it */
+    alBufferData(buffers[0], AL_FORMAT_MONO16, Samples, 128, 22050);
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &memory);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO8, Samples, 0, 16);
+    CHECK_ERROR(AL_NO_ERROR);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO_FLOAT32, Samples, 0, 16);
+    CHECK_ERROR(AL_INVALID_ENUM);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_STEREO8, Samples, 0, 16);
+    CHECK_ERROR(AL_INVALID_ENUM);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO16, Samples, 48, 16);
+    CHECK_ERROR(AL_NO_ERROR);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO8, Samples, 56, 16);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    CheckBufferAttribs(buffers[0], 128, 22050, 16, 1);
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &newMemory);
+    CHECK(newMemory == memory);
+
+    alBufferData(buffers[0], AL_FORMAT_REAR16, Samples, 128, 22050);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_REAR8, Samples, 0, 16);
+    CHECK_ERROR(AL_NO_ERROR);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_REAR32, Samples, 0, 16);
+    CHECK_ERROR(AL_INVALID_ENUM);
+    alBufferData(buffers[0], AL_FORMAT_MONO8, Samples, 64, 22050);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO16, Samples, 0, 16);
+    CHECK_ERROR(AL_INVALID_ENUM);
+    CheckBufferAttribs(buffers[0], 64, 22050, 8, 1);
+    alBufferData(buffers[0], AL_FORMAT_MONO16, Samples, 128, 22050);
+
+    /* IMA4 is written a block at a time. Blocks kept compressed can only be
+     * replaced by more blocks. */
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &memory);
+    alBufferData(buffers[0], AL_FORMAT_MONO_IMA4, Ima4Data, 36*4, 22050);
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &newMemory);
+    CHECK_ERROR(AL_NO_ERROR);
+    CHECK(newMemory-memory == (Ima4Compressed ? 36*4 : 65*4*2) - 128);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO_IMA4, Ima4Data+36*4/4, 65, 130);
+    CHECK_ERROR(AL_NO_ERROR);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO_IMA4, Ima4Data, 1, 65);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO_IMA4, Ima4Data, 195, 130);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO16, Samples, 0, 16);
+    CHECK_ERROR(Ima4Compressed ? AL_INVALID_ENUM : AL_NO_ERROR);
+    CheckBufferAttribs(buffers[0], 65*4*2, 22050, 16, 1);
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &memory);
+    CHECK(memory == newMemory);
+    alBufferData(buffers[0], AL_FORMAT_MONO16, Samples, 128, 22050);
+
+    /* Queued buffers must have the same sample type, not just the same
+     * channels */
+    alBufferData(buffers[1], AL_FORMAT_MONO8, Samples, 64, 22050);
+    alSourceQueueBuffers(source, 1, &buffers[0]);
+    CHECK_ERROR(AL_NO_ERROR);
+    alSourceQueueBuffers(source, 1, &buffers[1]);
+    CHECK_ERROR(AL_INVALID_OPERATION);
+    alSourceQueueBuffers(source, 1, &buffers[0]);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    alDeleteSources(1, &source);
+    alDeleteBuffers(2, buffers);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+static void CheckStaticBuffers(ALCdevice *device)
+{
+    ALuint buffers[2], source;
+    ALCint memory, newMemory;
+    char tag;
+
+    alGenBuffers(2, buffers);
+    alGenSources(1, &source);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    /* The data is used where it is, so it isn't counted as the device's */
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &memory);
+    palBufferDataStaticEXT(buffers[0], AL_FORMAT_MONO16, Samples, NUM_SAMPLES*2,
+                           22050, ReleaseData, &tag);
+    CHECK_ERROR(AL_NO_ERROR);
+    CheckBufferAttribs(buffers[0], NUM_SAMPLES*2, 22050, 16, 1);
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &newMemory);
+    CHECK(newMemory == memory);
+
+    /* Data that can't be used in place is an error, and leaves the buffer as
+     * it was */
+    palBufferDataStaticEXT(buffers[0], AL_FORMAT_MONO16, (ALubyte*)Samples+1, 64,
+                           22050, ReleaseData, &tag);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palBufferDataStaticEXT(buffers[0], AL_FORMAT_STEREO16, Samples, 6,
+                           22050, ReleaseData, &tag);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palBufferDataStaticEXT(buffers[0], AL_FORMAT_MONO16, NULL, 64,
+                           22050, ReleaseData, &tag);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palBufferDataStaticEXT(buffers[0], alGetEnumValue("AL_FORMAT_REAR16"), Samples, 64,
+                           22050, ReleaseData, &tag);
+    CHECK_ERROR(AL_INVALID_ENUM);
+    palBufferDataStaticEXT(0, AL_FORMAT_MONO16, Samples, 64,
+                           22050, ReleaseData, &tag);
+    CHECK_ERROR(AL_INVALID_NAME);
+    palBufferSubDataEXT(buffers[0], AL_FORMAT_MONO16, Samples, 0, 64);
+    CHECK_ERROR(AL_INVALID_OPERATION);
+    CheckBufferAttribs(buffers[0], NUM_SAMPLES*2, 22050, 16, 1);
+    CHECK(Released.count == 0);
+
+    /* The data can't be replaced while a source has the buffer */
+    CheckPlays(source, buffers[0]);
+    palBufferDataStaticEXT(buffers[0], AL_FORMAT_MONO16, Samples, 64,
+                           22050, ReleaseData, &tag);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    CHECK(Released.count == 0);
+
+    /* Once it's free, new data releases the old */
+    alSourcei(source, AL_BUFFER, 0);
+    alBufferData(buffers[0], AL_FORMAT_MONO8, Samples, 64, 22050);
+    CHECK_ERROR(AL_NO_ERROR);
+    CHECK(Released.count == 1 && Released.buffer == buffers[0] &&
+          Released.data == Samples && Released.userptr == &tag);
+
+    /* IMA4 data is kept compressed, but reports its decoded size */
+    palBufferDataStaticEXT(buffers[1], AL_FORMAT_MONO_IMA4, Ima4Data, sizeof(Ima4Data),
+                           22050, ReleaseData, NULL);
+    CHECK_ERROR(AL_NO_ERROR);
+    CheckBufferAttribs(buffers[1], IMA4_BLOCKS*65*2, 22050, 16, 1);
+    CheckPlays(source, buffers[1]);
+    alSourcei(source, AL_BUFFER, 0);
+
+    /* Deleting the buffer releases its data */
+    alDeleteBuffers(1, &buffers[1]);
+    CHECK_ERROR(AL_NO_ERROR);
+    CHECK(Released.count == 2 && Released.buffer == buffers[1] &&
+          Released.data == Ima4Data && Released.userptr == NULL);
+
+    alDeleteSources(1, &source);
+    alDeleteBuffers(1, &buffers[0]);
+    CHECK(Released.count == 2);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+int main(int argc, char **argv)
+{
+    ALCdevice *device;
+    ALCcontext *context;
+    ALuint buffer;
+    ALuint i;
+
+    Ima4Compressed = (argc > 1 && strcmp(argv[1], "ima4-compressed") == 0);
+
+    for(i = 0;i < NUM_SAMPLES+1;i++)
+        Samples[i] = (ALshort)(i*523);
+    for(i = 0;i < IMA4_BLOCKS*36/4;i++)
+        Ima4Data[i] = i*2654435761u;
+
+    device = alcOpenDevice(NULL);
+    if(!device)
+    {
+        printf("Could not open a device\n");
+        return EXIT_FAILURE;
+    }
+    context = alcCreateContext(device, NULL);
+    alcMakeContextCurrent(context);
+
+    palBufferDataStaticEXT = (PFNALBUFFERDATASTATICEXTPROC)alGetProcAddress("alBufferDataStaticEXT");
+    palBufferSubDataEXT = (PFNALBUFFERSUBDATAEXTPROC)alGetProcAddress("alBufferSubDataEXT");
+    if(!alIsExtensionPresent("AL_EXTX_static_buffer") ||
+       !palBufferDataStaticEXT || !palBufferSubDataEXT)
+    {
+        printf("AL_EXTX_static_buffer not supported\n");
+        alcMakeContextCurrent(NULL);
+        alcDestroyContext(context);
+        alcCloseDevice(device);
+        return EXIT_FAILURE;
+    }
+
+    CheckStaticBuffers(device);
+    CheckNativeFormats(device);
+
+    palBufferDataFromBankEXT = (PFNALBUFFERDATAFROMBANKEXTPROC)alGetProcAddress("alBufferDataFromBankEXT");
+    CHECK(alIsExtensionPresent("AL_EXTX_sound_bank") && palBufferDataFromBankEXT);
+    if(palBufferDataFromBankEXT)
+        CheckSoundBanks(device);
+
+    /* Closing the device releases the data of the buffers left on it */
+    alGenBuffers(1, &buffer);
+    palBufferDataStaticEXT(buffer, AL_FORMAT_MONO16, Samples, 64, 22050, ReleaseData, NULL);
+    CHECK_ERROR(AL_NO_ERROR);
+    Released.count = 0;
+
+    alcMakeContextCurrent(NULL);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+    CHECK(Released.count == 1 && Released.buffer == buffer && Released.data == Samples);
+
+    if(Failed)
+    {
+        printf("%d check(s) failed\n", Failed);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+    return EXIT_SUCCESS;
+}
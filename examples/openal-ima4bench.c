@@ -0,0 +1,157 @@
+/*
+ * Compares the mixing cost of IMA4 buffers kept compressed, which are
+ * decoded while mixing, against the same buffers decoded to 16-bit when
+ * they're loaded. The same number of looping voices is played each way, and
+ * the process's CPU time over and above playing nothing is given per voice.
+ * The device mixes in real time, so the wave writer works as well as real
+ * hardware, and the decoded voices need the ima4-compressed option off.
+ *
+ * Usage: openal-ima4bench [voices]
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "AL/alc.h"
+#include "AL/al.h"
+#include "AL/alext.h"
+
+#define DEFAULT_VOICES  32
+#define MAX_VOICES      128
+
+/* About a second of mono samples at 22050hz */
+#define IMA4_BLOCKS     340
+#define BENCH_SECONDS   2.0
+
+static ALuint Ima4Data[IMA4_BLOCKS*36/4];
+
+static double GetWallTime(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec/1000000.0;
+}
+
+/* Plays the buffer on the first count sources, and returns the fraction of
+ * a CPU the process used while they played */
+static double MeasureVoices(const ALuint *sources, ALsizei count, ALuint buffer)
+{
+    double wall, cpu;
+    clock_t start;
+    ALsizei i;
+
+    for(i = 0;i < count;i++)
+    {
+        /* Spread around the listener, so each is panned differently */
+        alSourcei(sources[i], AL_BUFFER, buffer);
+        alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+        alSource3f(sources[i], AL_POSITION, (ALfloat)(i%8) - 3.5f, 0.0f,
+                   (ALfloat)(i/8%8) - 3.5f);
+        alSourcef(sources[i], AL_GAIN, 1.0f/MAX_VOICES);
+    }
+    if(count > 0)
+        alSourcePlayv(count, sources);
+
+    /* Let the voices start before timing them */
+    usleep(200000);
+    wall = GetWallTime();
+    start = clock();
+    do {
+        usleep(100000);
+    } while(GetWallTime()-wall < BENCH_SECONDS);
+    cpu = (double)(clock()-start) / CLOCKS_PER_SEC;
+    wall = GetWallTime() - wall;
+
+    if(count > 0)
+        alSourceStopv(count, sources);
+    for(i = 0;i < count;i++)
+        alSourcei(sources[i], AL_BUFFER, 0);
+    return cpu / wall;
+}
+
+int main(int argc, char **argv)
+{
+    PFNALBUFFERDATASTATICEXTPROC palBufferDataStaticEXT;
+    ALuint sources[MAX_VOICES], buffers[2];
+    double idle, decoded, compressed;
+    ALCint memory, newMemory;
+    ALCdevice *device;
+    ALCcontext *context;
+    ALsizei voices;
+    ALuint i;
+
+    voices = ((argc > 1) ? atoi(argv[1]) : DEFAULT_VOICES);
+    if(voices <= 0 || voices > MAX_VOICES)
+    {
+        printf("Voice count must be between 1 and %d\n", MAX_VOICES);
+        return EXIT_FAILURE;
+    }
+
+    /* Noise, but it decodes the same either way */
+    srand(1);
+    for(i = 0;i < IMA4_BLOCKS*36/4;i++)
+        Ima4Data[i] = ((ALuint)rand()<<16) ^ (ALuint)rand();
+
+    device = alcOpenDevice(NULL);
+    if(!device)
+    {
+        printf("Could not open a device\n");
+        return EXIT_FAILURE;
+    }
+    context = alcCreateContext(device, NULL);
+    alcMakeContextCurrent(context);
+
+    palBufferDataStaticEXT = (PFNALBUFFERDATASTATICEXTPROC)alGetProcAddress("alBufferDataStaticEXT");
+    if(!alIsExtensionPresent("AL_EXTX_static_buffer") || !palBufferDataStaticEXT)
+    {
+        printf("AL_EXTX_static_buffer not supported\n");
+        alcMakeContextCurrent(NULL);
+        alcDestroyContext(context);
+        alcCloseDevice(device);
+        return EXIT_FAILURE;
+    }
+
+    alGenBuffers(2, buffers);
+    alGenSources(voices, sources);
+    if(alGetError() != AL_NO_ERROR)
+    {
+        printf("Could not create %d sources\n", voices);
+        alcMakeContextCurrent(NULL);
+        alcDestroyContext(context);
+        alcCloseDevice(device);
+        return EXIT_FAILURE;
+    }
+
+    /* Static IMA4 data always stays compressed. Loaded data doesn't unless
+     * the option says so, which the memory it takes shows. */
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &memory);
+    alBufferData(buffers[0], AL_FORMAT_MONO_IMA4, Ima4Data, sizeof(Ima4Data), 22050);
+    alcGetIntegerv(device, ALC_BUFFER_MEMORY_EXT, 1, &newMemory);
+    if(newMemory-memory < IMA4_BLOCKS*65*2)
+        printf("Warning: ima4-compressed is on, both sets of voices are compressed\n");
+    palBufferDataStaticEXT(buffers[1], AL_FORMAT_MONO_IMA4, Ima4Data, sizeof(Ima4Data),
+                           22050, NULL, NULL);
+
+    idle = MeasureVoices(sources, 0, 0);
+    decoded = MeasureVoices(sources, voices, buffers[0]);
+    compressed = MeasureVoices(sources, voices, buffers[1]);
+
+    printf("%d voices, %.1f seconds each:\n", voices, BENCH_SECONDS);
+    printf("  idle:        %6.2f%% CPU\n", idle*100.0);
+    printf("  decoded:     %6.2f%% CPU, %8.2f us per voice per second\n",
+           decoded*100.0, (decoded-idle)*1000000.0/voices);
+    printf("  compressed:  %6.2f%% CPU, %8.2f us per voice per second\n",
+           compressed*100.0, (compressed-idle)*1000000.0/voices);
+
+    alDeleteSources(voices, sources);
+    alDeleteBuffers(2, buffers);
+    alcMakeContextCurrent(NULL);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/*
+ * Checks that the resampler reads past the ends of short buffers correctly.
+ * One source loops a buffer shorter than the resampler's padding, and
+ * another loops a queue of even shorter ones, both holding a constant
+ * sample at pitches that leave the resampler between samples. The padding
+ * has to be gathered from as many buffers as it takes, going round the
+ * queue, so what's played back must stay constant too. Meant to be run
+ * with the wave writer using the sinc resampler at 32 taps, and given the
+ * file it writes to:
+ *
+ *     openal-looptest <wave file>
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "AL/alc.h"
+#include "AL/al.h"
+
+#define LOOP_FRAMES   4
+#define CHAIN_FRAMES  2
+#define CHAIN_LENGTH  8
+
+#define SAMPLE_VALUE  8192
+
+/* How long the sources play for, in milliseconds */
+#define PLAY_TIME     500
+
+/* How far the played back samples may stray from their average */
+#define TOLERANCE     16
+
+#define WAVE_HEADER_SIZE  44
+
+static int Failed;
+
+#define CHECK(cond) do {                                                      \
+    if(!(cond))                                                               \
+    {                                                                         \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);       \
+        Failed++;                                                             \
+    }                                                                         \
+} while(0)
+
+#define CHECK_ERROR(expected) do {                                            \
+    ALenum err = alGetError();                                                \
+    if(err != (expected))                                                     \
+    {                                                                         \
+        printf("%s:%d: got error 0x%04x, expected %s\n", __FILE__, __LINE__, \
+               err, #expected);                                               \
+        Failed++;                                                             \
+    }                                                                         \
+} while(0)
+
+/* Starts a looping 4-frame buffer and a looping queue of 2-frame buffers
+ * playing */
+static void PlayLoops(ALuint *sources, ALuint *buffers)
+{
+    static ALshort data[LOOP_FRAMES];
+    ALuint i;
+
+    for(i = 0;i < LOOP_FRAMES;i++)
+        data[i] = SAMPLE_VALUE;
+
+    alGenSources(2, sources);
+    alGenBuffers(CHAIN_LENGTH+1, buffers);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    alBufferData(buffers[0], AL_FORMAT_MONO16, data, LOOP_FRAMES*sizeof(ALshort), 44100);
+    alSourcei(sources[0], AL_BUFFER, buffers[0]);
+    alSourcei(sources[0], AL_LOOPING, AL_TRUE);
+    alSourcef(sources[0], AL_PITCH, 0.7f);
+
+    for(i = 1;i <= CHAIN_LENGTH;i++)
+        alBufferData(buffers[i], AL_FORMAT_MONO16, data, CHAIN_FRAMES*sizeof(ALshort), 44100);
+    alSourceQueueBuffers(sources[1], CHAIN_LENGTH, buffers+1);
+    alSourcei(sources[1], AL_LOOPING, AL_TRUE);
+    alSourcef(sources[1], AL_PITCH, 1.3f);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    alSourcePlayv(2, sources);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+/* Reads the 16-bit stereo samples written while both sources were playing,
+ * skipping the ends of the file when they may not have been, and checks
+ * they all stay close to their average. */
+static void CheckWaveFile(const char *fname)
+{
+    FILE *f;
+    long size, first, last, i;
+    ALshort *samples;
+    long sum = 0, avg;
+
+    f = fopen(fname, "rb");
+    if(!f)
+    {
+        printf("Could not open %s\n", fname);
+        Failed++;
+        return;
+    }
+    fseek(f, 0, SEEK_END);
+    size = (ftell(f) - WAVE_HEADER_SIZE) / 2;
+    fseek(f, WAVE_HEADER_SIZE, SEEK_SET);
+
+    samples = calloc(size+1, sizeof(ALshort));
+    for(i = 0;i < size;i++)
+    {
+        int lo = fgetc(f);
+        int hi = fgetc(f);
+        samples[i] = (ALshort)(lo | (hi<<8));
+    }
+    fclose(f);
+
+    /* The middle half, kept to whole frames */
+    first = size/4 & ~1;
+    last = size*3/4 & ~1;
+    CHECK(last-first > 1000);
+
+    for(i = first;i < last;i++)
+        sum += samples[i];
+    avg = sum / (last-first);
+    CHECK(avg > SAMPLE_VALUE/4);
+
+    for(i = first;i < last;i++)
+    {
+        if(labs(samples[i]-avg) > TOLERANCE)
+        {
+            printf("Sample %ld is %d, averaging %ld\n", i, samples[i], avg);
+            Failed++;
+            break;
+        }
+    }
+    free(samples);
+}
+
+int main(int argc, char **argv)
+{
+    ALCdevice *device;
+    ALCcontext *context;
+    ALuint sources[2], buffers[CHAIN_LENGTH+1];
+
+    if(argc != 2)
+    {
+        printf("Usage: %s <wave file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    device = alcOpenDevice(NULL);
+    if(!device)
+    {
+        printf("Could not open a device\n");
+        return EXIT_FAILURE;
+    }
+    context = alcCreateContext(device, NULL);
+    alcMakeContextCurrent(context);
+
+    PlayLoops(sources, buffers);
+    usleep(PLAY_TIME*1000);
+
+    alSourceStopv(2, sources);
+    alDeleteSources(2, sources);
+    alDeleteBuffers(CHAIN_LENGTH+1, buffers);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    alcMakeContextCurrent(NULL);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+
+    CheckWaveFile(argv[1]);
+
+    if(Failed)
+    {
+        printf("%d check(s) failed\n", Failed);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*
+ * Times the mixer's kernels, which are built into this program. Each one is
+ * run repeatedly over the same block, and the rate is given in output
+ * samples per second. The sample loaders are timed with a few block sizes,
+ * since the mixer calls them with whatever is left of a buffer.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "alMain.h"
+#include "alu.h"
+#include "mixer_defs.h"
+#include "cpucaps.h"
+
+/* Output samples per call, the same as one of the mixer's blocks */
+#define BLOCK_SIZE  BUFFERSIZE
+/* Enough input for a block at the pitches used, plus the sinc padding */
+#define INPUT_SIZE  (BLOCK_SIZE*2 + MAX_SINC_TAPS*2)
+
+#define BENCH_SECONDS  0.5
+
+static ALfloat Input[INPUT_SIZE];
+static ALfloat Output[BLOCK_SIZE];
+static ALubyte InputUbyte[BLOCK_SIZE];
+static ALshort InputShort[BLOCK_SIZE];
+
+static const struct {
+    const char *name;
+    ALuint cap;
+    ResamplerFunc proc;
+} Resamplers[] = {
+    { "Resample_point_C", 0, Resample_point_C },
+    { "Resample_lerp_C", 0, Resample_lerp_C },
+    { "Resample_cos_lerp_C", 0, Resample_cos_lerp_C },
+    { "Resample_sinc_C", 0, Resample_sinc_C },
+#ifdef HAVE_SSE
+    { "Resample_sinc_SSE", CPU_CAP_SSE, Resample_sinc_SSE },
+#endif
+#ifdef HAVE_NEON
+    { "Resample_sinc_Neon", CPU_CAP_NEON, Resample_sinc_Neon },
+#endif
+    { NULL, 0, NULL }
+};
+
+/* Pitches as 18.14 fixed point steps */
+static const struct {
+    const char *name;
+    ALint increment;
+} Pitches[] = {
+    { "1.0", 1<<FRACTIONBITS },
+    { "0.9", (1<<FRACTIONBITS)*9/10 },
+    { "1.5", (1<<FRACTIONBITS)*3/2 },
+    { NULL, 0 }
+};
+
+static const struct {
+    const char *name;
+    ALuint cap;
+    LoadSamplesProc proc;
+    const ALvoid *input;
+} Loaders[] = {
+    { "LoadSamples_ubyte_C", 0, LoadSamples_ubyte_C, InputUbyte },
+    { "LoadSamples_short_C", 0, LoadSamples_short_C, InputShort },
+    { "LoadSamples_float_C", 0, LoadSamples_float_C, Input },
+#ifdef HAVE_SSE2
+    { "LoadSamples_ubyte_SSE2", CPU_CAP_SSE2, LoadSamples_ubyte_SSE2, InputUbyte },
+    { "LoadSamples_short_SSE2", CPU_CAP_SSE2, LoadSamples_short_SSE2, InputShort },
+#endif
+    { NULL, 0, NULL, NULL }
+};
+
+static const ALuint LoaderSizes[] = { 64, 256, 1024, BLOCK_SIZE };
+
+static void BenchLoaders(ALuint caps)
+{
+    ALuint i, s;
+
+    printf("Sample loaders:\n");
+    for(i = 0;Loaders[i].name;i++)
+    {
+        if(Loaders[i].cap && !(caps&Loaders[i].cap))
+        {
+            printf("  %-22s skipped, not supported by this CPU\n", Loaders[i].name);
+            continue;
+        }
+        for(s = 0;s < sizeof(LoaderSizes)/sizeof(LoaderSizes[0]);s++)
+        {
+            double secs, total;
+            unsigned long calls = 0;
+            clock_t start;
+
+            start = clock();
+            do {
+                ALuint n;
+                for(n = 0;n < 64;n++)
+                    Loaders[i].proc(Output, Loaders[i].input, LoaderSizes[s]);
+                calls += 64;
+                secs = (double)(clock()-start) / CLOCKS_PER_SEC;
+            } while(secs < BENCH_SECONDS);
+            total = (double)calls*LoaderSizes[s] / secs;
+
+            printf("  %-22s %4u samples: %8.2f Msamples/s\n", Loaders[i].name,
+                   LoaderSizes[s], total/1000000.0);
+        }
+    }
+}
+
+static void BenchResamplers(ALuint caps)
+{
+    ALuint i, p;
+
+    printf("Resamplers, %d samples per call:\n", BLOCK_SIZE);
+    for(i = 0;Resamplers[i].name;i++)
+    {
+        if(Resamplers[i].cap && !(caps&Resamplers[i].cap))
+        {
+            printf("  %-22s skipped, not supported by this CPU\n", Resamplers[i].name);
+            continue;
+        }
+        for(p = 0;Pitches[p].name;p++)
+        {
+            double secs, total;
+            unsigned long calls = 0;
+            clock_t start;
+
+            start = clock();
+            do {
+                ALuint n;
+                /* The sinc resampler reads samples before the position too,
+                 * so start past them */
+                for(n = 0;n < 64;n++)
+                    Resamplers[i].proc(Input+MAX_SINC_TAPS, 1, n&FRACTIONMASK,
+                                       Pitches[p].increment, Output, BLOCK_SIZE);
+                calls += 64;
+                secs = (double)(clock()-start) / CLOCKS_PER_SEC;
+            } while(secs < BENCH_SECONDS);
+            total = (double)calls*BLOCK_SIZE / secs;
+
+            printf("  %-22s pitch %s: %8.2f Msamples/s\n", Resamplers[i].name,
+                   Pitches[p].name, total/1000000.0);
+        }
+    }
+}
+
+int main(void)
+{
+    ALuint caps = GetCPUCaps();
+    ALuint i;
+
+    InitResamplerTables(DEFAULT_SINC_TAPS);
+    for(i = 0;i < INPUT_SIZE;i++)
+        Input[i] = (ALfloat)((rand()%65536) - 32768) / 32768.0f;
+    for(i = 0;i < BLOCK_SIZE;i++)
+    {
+        InputUbyte[i] = (ALubyte)(rand()%256);
+        InputShort[i] = (ALshort)((rand()%65536) - 32768);
+    }
+
+    BenchResamplers(caps);
+    BenchLoaders(caps);
+    return EXIT_SUCCESS;
+}
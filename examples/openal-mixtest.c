@@ -0,0 +1,418 @@
+/*
+ * Checks the mixer's SIMD kernels against its C kernels. The kernels are
+ * built into this program, and each one is run on the same random input as
+ * the C version, with odd lengths and unaligned offsets, in both rounding
+ * modes the mixer may run in. The sample loaders are also given every 8- or
+ * 16-bit value, and the placement kernel is given partial groups, sources
+ * at the listener and zero reference distances. Any difference is a failure,
+ * except for the sinc resamplers, which only have to be close to the C one
+ * for each tap count, interleaving step and pitch.
+ */
+
+#include "config.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_FENV_H
+#include <fenv.h>
+#endif
+
+#include "alMain.h"
+#include "alu.h"
+#include "mixer_defs.h"
+#include "cpucaps.h"
+
+#define MAX_LENGTH  1031
+#define MAX_OFFSET  4
+
+/* Enough samples for every 16-bit value */
+#define LOADER_LENGTH  65536
+
+/* The sinc resamplers' results are summed in a different order, so they're
+ * only expected to be this close */
+#define SINC_TOLERANCE  1e-5f
+#define SINC_LENGTH     255
+#define MAX_STEP        3
+#define MAX_INCREMENT   (10<<FRACTIONBITS)
+
+static ALuint RandSeed = 22222;
+
+static ALfloat RandFloat(ALfloat lo, ALfloat hi)
+{
+    RandSeed = RandSeed*1103515245 + 12345;
+    return lo + (hi-lo)*((RandSeed>>8)&0xffff)/65535.0f;
+}
+
+static const ALuint Lengths[] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 13, 15, 16, 17, 31, 63, 64, 65, 255,
+    1024, MAX_LENGTH
+};
+
+static const struct {
+    const char *name;
+    ALuint cap;
+    MixRowProc proc;
+} RowMixers[] = {
+#ifdef HAVE_SSE
+    { "MixRow_SSE", CPU_CAP_SSE, MixRow_SSE },
+#endif
+#ifdef HAVE_NEON
+    { "MixRow_Neon", CPU_CAP_NEON, MixRow_Neon },
+#endif
+    { NULL, 0, NULL }
+};
+
+/* Mixes the same block with MixRow_C and proc, returning the number of runs
+ * that differed */
+static int CheckRowMixer(const char *name, MixRowProc proc)
+{
+    static ALfloat data[MAX_LENGTH+MAX_OFFSET];
+    static ALfloat out1[MAX_LENGTH+MAX_OFFSET], out2[MAX_LENGTH+MAX_OFFSET];
+    int failed = 0;
+    ALuint l, doff, ooff, ramp, i;
+
+    for(l = 0;l < sizeof(Lengths)/sizeof(Lengths[0]);l++)
+    {
+        for(doff = 0;doff < MAX_OFFSET;doff++)
+        {
+            for(ooff = 0;ooff < MAX_OFFSET;ooff++)
+            {
+                for(ramp = 0;ramp < 2;ramp++)
+                {
+                    ALuint len = Lengths[l];
+                    ALfloat gain = RandFloat(0.0f, 1.0f);
+                    ALfloat step = (ramp ? RandFloat(-1.0f, 1.0f)/(len+1) : 0.0f);
+                    ALfloat scaler = RandFloat(0.0f, 1.0f);
+
+                    for(i = 0;i < MAX_LENGTH+MAX_OFFSET;i++)
+                    {
+                        data[i] = RandFloat(-1.0f, 1.0f);
+                        out1[i] = out2[i] = RandFloat(-1.0f, 1.0f);
+                    }
+
+                    MixRow_C(out1+ooff, data+doff, gain, step, scaler, len);
+                    proc(out2+ooff, data+doff, gain, step, scaler, len);
+                    if(memcmp(out1, out2, sizeof(out1)) != 0)
+                    {
+                        printf("%s: length %u, offsets %u/%u, %s gain differs\n",
+                               name, len, doff, ooff, (ramp ? "ramping" : "steady"));
+                        failed++;
+                    }
+                }
+            }
+        }
+    }
+    return failed;
+}
+
+static const struct {
+    const char *name;
+    ALuint cap;
+    LoadSamplesProc proc;
+    LoadSamplesProc ref;
+    ALuint bytes;
+} Loaders[] = {
+#ifdef HAVE_SSE2
+    { "LoadSamples_ubyte_SSE2", CPU_CAP_SSE2, LoadSamples_ubyte_SSE2, LoadSamples_ubyte_C, 1 },
+    { "LoadSamples_short_SSE2", CPU_CAP_SSE2, LoadSamples_short_SSE2, LoadSamples_short_C, 2 },
+#endif
+    { NULL, 0, NULL, NULL, 0 }
+};
+
+/* Loads the same samples with ref and proc, returning the number of runs
+ * that differed. The samples count up through every value of their type and
+ * wrap around, and the full length run covers all of them at each offset. */
+static int CheckLoader(const char *name, LoadSamplesProc proc,
+                       LoadSamplesProc ref, ALuint bytes)
+{
+    static ALubyte ubytes[LOADER_LENGTH+MAX_OFFSET];
+    static ALshort shorts[LOADER_LENGTH+MAX_OFFSET];
+    static ALfloat out1[LOADER_LENGTH+MAX_OFFSET], out2[LOADER_LENGTH+MAX_OFFSET];
+    const ALuint numLengths = sizeof(Lengths)/sizeof(Lengths[0]);
+    int failed = 0;
+    ALuint l, soff, ooff, i;
+
+    for(i = 0;i < LOADER_LENGTH+MAX_OFFSET;i++)
+    {
+        ubytes[i] = (ALubyte)i;
+        shorts[i] = (ALshort)(i-32768);
+    }
+
+    for(l = 0;l <= numLengths;l++)
+    {
+        ALuint len = ((l < numLengths) ? Lengths[l] : LOADER_LENGTH);
+        for(soff = 0;soff < MAX_OFFSET;soff++)
+        {
+            for(ooff = 0;ooff < MAX_OFFSET;ooff++)
+            {
+                const ALvoid *src = ((bytes == 1) ? (ALvoid*)(ubytes+soff) :
+                                                    (ALvoid*)(shorts+soff));
+
+                /* Out of range, so writes past the end show up */
+                for(i = 0;i < LOADER_LENGTH+MAX_OFFSET;i++)
+                    out1[i] = out2[i] = -2.0f;
+
+                ref(out1+ooff, src, len);
+                proc(out2+ooff, src, len);
+                if(memcmp(out1, out2, sizeof(out1)) != 0)
+                {
+                    printf("%s: length %u, offsets %u/%u differs\n",
+                           name, len, soff, ooff);
+                    failed++;
+                }
+            }
+        }
+    }
+    return failed;
+}
+
+static const struct {
+    const char *name;
+    ALuint cap;
+    PlacementProc proc;
+} Placers[] = {
+#ifdef HAVE_SSE
+    { "CalcPlacements_SSE", CPU_CAP_SSE, CalcPlacements_SSE },
+#endif
+    { NULL, 0, NULL }
+};
+
+static const ALuint PlacementCounts[] = {
+    0, 1, 2, 3, 4, 5, 7, 13, 62, 63, PLACEMENT_BATCH
+};
+
+/* Places the same batch with CalcPlacements_C and proc, returning the number
+ * of runs that differed. The listener is first at the origin facing the
+ * default way, then turned and moved. Some sources are where the listener
+ * is, or have no direction or velocity, and some have no reference
+ * distance. Only the first count results are compared, since the lanes of a
+ * partial group are scratch. */
+static int CheckPlacer(const char *name, PlacementProc proc)
+{
+    static PlacementBatch batch1, batch2;
+    static const ALfloat listenerPos[3] = { 3.0f, -1.5f, 7.25f };
+    ALfloat matrix[4][4], listenerVel[3];
+    int failed = 0;
+    ALuint moved, l, i, r, c;
+
+    for(moved = 0;moved < 2;moved++)
+    {
+        for(r = 0;r < 4;r++)
+        {
+            for(c = 0;c < 4;c++)
+                matrix[r][c] = ((r == c) ? 1.0f : 0.0f);
+        }
+        if(moved)
+        {
+            /* Turned about the Y axis, and moved to listenerPos, so sources
+             * there end up at the origin */
+            matrix[0][0] = 0.6f;  matrix[0][2] = 0.8f;
+            matrix[2][0] = -0.8f; matrix[2][2] = 0.6f;
+            for(c = 0;c < 3;c++)
+                matrix[3][c] = -(listenerPos[0]*matrix[0][c] + listenerPos[1]*matrix[1][c] +
+                                 listenerPos[2]*matrix[2][c]);
+        }
+        for(c = 0;c < 3;c++)
+            listenerVel[c] = RandFloat(-5.0f, 5.0f);
+
+        for(l = 0;l < sizeof(PlacementCounts)/sizeof(PlacementCounts[0]);l++)
+        {
+            ALuint count = PlacementCounts[l];
+
+            for(i = 0;i < PLACEMENT_BATCH;i++)
+            {
+                batch1.PosX[i] = RandFloat(-10.0f, 10.0f);
+                batch1.PosY[i] = RandFloat(-10.0f, 10.0f);
+                batch1.PosZ[i] = RandFloat(-10.0f, 10.0f);
+                batch1.VelX[i] = RandFloat(-5.0f, 5.0f);
+                batch1.VelY[i] = RandFloat(-5.0f, 5.0f);
+                batch1.VelZ[i] = RandFloat(-5.0f, 5.0f);
+                batch1.DirX[i] = RandFloat(-1.0f, 1.0f);
+                batch1.DirY[i] = RandFloat(-1.0f, 1.0f);
+                batch1.DirZ[i] = RandFloat(-1.0f, 1.0f);
+                batch1.RefDistance[i] = RandFloat(0.0f, 2.0f);
+                if(i%5 == 1)
+                {
+                    batch1.PosX[i] = (moved ? listenerPos[0] : 0.0f);
+                    batch1.PosY[i] = (moved ? listenerPos[1] : 0.0f);
+                    batch1.PosZ[i] = (moved ? listenerPos[2] : 0.0f);
+                }
+                if(i%3 == 2)
+                    batch1.VelX[i] = batch1.VelY[i] = batch1.VelZ[i] = 0.0f;
+                if(i%7 == 3)
+                    batch1.DirX[i] = batch1.DirY[i] = batch1.DirZ[i] = 0.0f;
+                if(i%4 == 1 || i%4 == 2)
+                    batch1.RefDistance[i] = 0.0f;
+            }
+            batch2 = batch1;
+
+            CalcPlacements_C(&batch1, count, matrix, listenerVel);
+            proc(&batch2, count, matrix, listenerVel);
+            if(memcmp(&batch1, &batch2, offsetof(PlacementBatch, Distance)) != 0 ||
+               memcmp(batch1.Distance, batch2.Distance, count*sizeof(ALfloat)) != 0 ||
+               memcmp(batch1.ConeCos, batch2.ConeCos, count*sizeof(ALfloat)) != 0 ||
+               memcmp(batch1.RearCos, batch2.RearCos, count*sizeof(ALfloat)) != 0 ||
+               memcmp(batch1.SourceSpeed, batch2.SourceSpeed, count*sizeof(ALfloat)) != 0 ||
+               memcmp(batch1.ListenerSpeed, batch2.ListenerSpeed, count*sizeof(ALfloat)) != 0 ||
+               memcmp(batch1.PanX, batch2.PanX, count*sizeof(ALfloat)) != 0 ||
+               memcmp(batch1.PanZ, batch2.PanZ, count*sizeof(ALfloat)) != 0 ||
+               memcmp(batch1.DirGain, batch2.DirGain, count*sizeof(ALfloat)) != 0)
+            {
+                printf("%s: count %u, %s listener differs\n", name, count,
+                       (moved ? "moved" : "unmoved"));
+                failed++;
+            }
+        }
+    }
+    return failed;
+}
+
+static const struct {
+    const char *name;
+    ALuint cap;
+    ResamplerFunc proc;
+} Samplers[] = {
+#ifdef HAVE_SSE
+    { "Resample_sinc_SSE", CPU_CAP_SSE, Resample_sinc_SSE },
+#endif
+#ifdef HAVE_NEON
+    { "Resample_sinc_Neon", CPU_CAP_NEON, Resample_sinc_Neon },
+#endif
+    { NULL, 0, NULL }
+};
+
+static const ALuint SincTapCounts[] = { 4, 8, 16, 32 };
+
+/* Increments below, at and above one sample per output, so every cutoff
+ * band gets used */
+static const ALint SincIncrements[] = {
+    (1<<FRACTIONBITS)*3/4, (1<<FRACTIONBITS), (1<<FRACTIONBITS)+1,
+    (1<<FRACTIONBITS)*9/8, (1<<FRACTIONBITS)*3/2, (1<<FRACTIONBITS)*2,
+    (1<<FRACTIONBITS)*3, (1<<FRACTIONBITS)*5, (1<<FRACTIONBITS)*7+12345,
+    MAX_INCREMENT
+};
+
+/* Resamples the same block with Resample_sinc_C and proc, returning the
+ * number of runs where any output was further than SINC_TOLERANCE apart.
+ * Each run starts at a random fraction on one channel of step interleaved
+ * ones. */
+static int CheckSampler(const char *name, ResamplerFunc proc)
+{
+    static ALfloat data[(MAX_SINC_TAPS + SINC_LENGTH*(MAX_INCREMENT>>FRACTIONBITS) + 1)*MAX_STEP];
+    static ALfloat out1[SINC_LENGTH], out2[SINC_LENGTH];
+    const ALuint oldTaps = SincTaps;
+    int failed = 0;
+    ALuint t, step, n, l, i;
+
+    for(t = 0;t < sizeof(SincTapCounts)/sizeof(SincTapCounts[0]);t++)
+    {
+        ALuint taps = SincTapCounts[t];
+
+        InitResamplerTables(taps);
+        for(step = 1;step <= MAX_STEP;step++)
+        {
+            for(n = 0;n < sizeof(SincIncrements)/sizeof(SincIncrements[0]);n++)
+            {
+                for(l = 0;l < sizeof(Lengths)/sizeof(Lengths[0]);l++)
+                {
+                    ALint increment = SincIncrements[n];
+                    ALuint len = Lengths[l];
+                    ALuint frac = (ALuint)RandFloat(0.0f, (ALfloat)FRACTIONMASK);
+                    const ALfloat *src = data + (taps/2-1)*step;
+                    ALfloat maxDiff = 0.0f;
+
+                    if(len > SINC_LENGTH)
+                        continue;
+                    for(i = 0;i < sizeof(data)/sizeof(data[0]);i++)
+                        data[i] = RandFloat(-1.0f, 1.0f);
+
+                    Resample_sinc_C(src, step, frac, increment, out1, len);
+                    proc(src, step, frac, increment, out2, len);
+                    for(i = 0;i < len;i++)
+                    {
+                        ALfloat diff = out1[i] - out2[i];
+                        if(diff < 0.0f) diff = -diff;
+                        if(!(diff <= maxDiff)) maxDiff = diff;
+                    }
+                    if(!(maxDiff <= SINC_TOLERANCE))
+                    {
+                        printf("%s: %u taps, step %u, increment %d, length %u is off by %g\n",
+                               name, taps, step, increment, len, maxDiff);
+                        failed++;
+                    }
+                }
+            }
+        }
+    }
+    InitResamplerTables(oldTaps);
+    return failed;
+}
+
+static int CheckKernels(ALuint caps)
+{
+    int failed = 0;
+    int i;
+
+    for(i = 0;RowMixers[i].name;i++)
+    {
+        if(!(caps&RowMixers[i].cap))
+        {
+            printf("%s: skipped, not supported by this CPU\n", RowMixers[i].name);
+            continue;
+        }
+        failed += CheckRowMixer(RowMixers[i].name, RowMixers[i].proc);
+    }
+    for(i = 0;Loaders[i].name;i++)
+    {
+        if(!(caps&Loaders[i].cap))
+        {
+            printf("%s: skipped, not supported by this CPU\n", Loaders[i].name);
+            continue;
+        }
+        failed += CheckLoader(Loaders[i].name, Loaders[i].proc, Loaders[i].ref,
+                              Loaders[i].bytes);
+    }
+    for(i = 0;Placers[i].name;i++)
+    {
+        if(!(caps&Placers[i].cap))
+        {
+            printf("%s: skipped, not supported by this CPU\n", Placers[i].name);
+            continue;
+        }
+        failed += CheckPlacer(Placers[i].name, Placers[i].proc);
+    }
+    for(i = 0;Samplers[i].name;i++)
+    {
+        if(!(caps&Samplers[i].cap))
+        {
+            printf("%s: skipped, not supported by this CPU\n", Samplers[i].name);
+            continue;
+        }
+        failed += CheckSampler(Samplers[i].name, Samplers[i].proc);
+    }
+    return failed;
+}
+
+int main(void)
+{
+    ALuint caps = GetCPUCaps();
+    int failed;
+
+    failed = CheckKernels(caps);
+#if defined(HAVE_FENV_H) && defined(FE_TOWARDZERO)
+    /* The mixer runs with rounding towards zero where it can */
+    fesetround(FE_TOWARDZERO);
+    failed += CheckKernels(caps);
+    fesetround(FE_TONEAREST);
+#endif
+
+    if(failed)
+    {
+        printf("%d check(s) failed\n", failed);
+        return EXIT_FAILURE;
+    }
+    printf("All kernels match\n");
+    return EXIT_SUCCESS;
+}
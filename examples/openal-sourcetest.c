@@ -0,0 +1,732 @@
+/*
+ * Checks object names and source behavior through the public API. Names
+ * must only be valid for the type, and the device or context, they were
+ * made for, and not after they're deleted. Changes made while updates are
+ * deferred must read back right away. Properties set and read for many
+ * sources at once must match the per-source calls. Sources too quiet to be
+ * heard, or left out when the device has a voice budget, must keep the same
+ * place as ones that are heard. The mixer must only recalculate the sources
+ * a change affects, and where they are only when they or the listener
+ * moved. Buffers are queued and unqueued at
+ * random while the source is seeked around its queue, and the processed
+ * count and offset are checked against a model of the queue. Needs a device
+ * to open, which can be the wave writer.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "AL/alc.h"
+#include "AL/al.h"
+#include "AL/alext.h"
+
+#define NUM_BUFFERS   16
+#define MAX_QUEUED    256
+#define SEEK_ROUNDS   100
+
+/* Each buffer is long enough that the mixer can't play through it between
+ * starting and pausing the source */
+#define BUFFER_FRAMES(i)  (4096 + ((i)*37%97)*8)
+
+static ALshort Silence[BUFFER_FRAMES(NUM_BUFFERS)*2];
+
+static int Failed;
+
+#define CHECK(cond) do {                                                      \
+    if(!(cond))                                                               \
+    {                                                                         \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);       \
+        Failed++;                                                             \
+    }                                                                         \
+} while(0)
+
+#define CHECK_ERROR(expected) do {                                            \
+    ALenum err = alGetError();                                                \
+    if(err != (expected))                                                     \
+    {                                                                         \
+        printf("%s:%d: got error 0x%04x, expected %s\n", __FILE__, __LINE__, \
+               err, #expected);                                               \
+        Failed++;                                                             \
+    }                                                                         \
+} while(0)
+
+typedef ALvoid (AL_APIENTRY*GenNamesProc)(ALsizei, ALuint*);
+typedef ALboolean (AL_APIENTRY*IsNameProc)(ALuint);
+
+/* Each kind of object, found by name so the EFX ones don't need their
+ * prototypes. Names of the ones made per context are only valid in that
+ * context. */
+static const struct {
+    const char *gen;
+    const char *del;
+    const char *is;
+    ALboolean perContext;
+    ALboolean nullValid;
+} ObjectTypes[] = {
+    { "alGenSources", "alDeleteSources", "alIsSource", AL_TRUE, AL_FALSE },
+    { "alGenBuffers", "alDeleteBuffers", "alIsBuffer", AL_FALSE, AL_TRUE },
+    { "alGenEffects", "alDeleteEffects", "alIsEffect", AL_FALSE, AL_TRUE },
+    { "alGenFilters", "alDeleteFilters", "alIsFilter", AL_FALSE, AL_TRUE },
+    { "alGenAuxiliaryEffectSlots", "alDeleteAuxiliaryEffectSlots",
+      "alIsAuxiliaryEffectSlot", AL_TRUE, AL_FALSE }
+};
+#define NUM_OBJECT_TYPES  (sizeof(ObjectTypes)/sizeof(ObjectTypes[0]))
+
+#define MAX_LOCKSTEP  16
+
+#define NAMES_PER_TYPE  4
+
+static ALuint RandSeed = 22222;
+
+static ALuint RandInt(ALuint max)
+{
+    RandSeed = RandSeed*1103515245 + 12345;
+    return ((RandSeed>>8)&0xffff) % max;
+}
+
+/* The frame counts of the queued buffers, oldest first */
+static ALuint QueueFrames[MAX_QUEUED];
+static ALuint QueueLength;
+
+/* Seeks to the frame and checks how many buffers the source counts as
+ * processed, and where it says it is */
+static void CheckSeek(ALuint source, ALuint frame)
+{
+    ALint processed, offset;
+    ALuint i, end = 0;
+
+    alSourcei(source, AL_SAMPLE_OFFSET, frame);
+    CHECK_ERROR(AL_NO_ERROR);
+    alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+    alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    for(i = 0;i < QueueLength;i++)
+    {
+        end += QueueFrames[i];
+        if(end > frame)
+            break;
+    }
+    if((ALuint)processed != i || (ALuint)offset != frame)
+    {
+        printf("seek to %u: %d processed at %d, expected %u at %u\n", frame,
+               processed, offset, i, frame);
+        Failed++;
+    }
+}
+
+static void CheckNames(ALCdevice *device, ALCcontext *context)
+{
+    GenNamesProc genProcs[NUM_OBJECT_TYPES], delProcs[NUM_OBJECT_TYPES];
+    IsNameProc isProcs[NUM_OBJECT_TYPES];
+    ALuint names[NUM_OBJECT_TYPES][NAMES_PER_TYPE];
+    ALCcontext *context2;
+    ALuint t, u, i, name;
+
+    for(t = 0;t < NUM_OBJECT_TYPES;t++)
+    {
+        genProcs[t] = (GenNamesProc)alGetProcAddress(ObjectTypes[t].gen);
+        delProcs[t] = (GenNamesProc)alGetProcAddress(ObjectTypes[t].del);
+        isProcs[t] = (IsNameProc)alGetProcAddress(ObjectTypes[t].is);
+        if(!genProcs[t] || !delProcs[t] || !isProcs[t])
+        {
+            printf("%s not found\n", ObjectTypes[t].gen);
+            Failed++;
+            return;
+        }
+        genProcs[t](NAMES_PER_TYPE, names[t]);
+        CHECK_ERROR(AL_NO_ERROR);
+    }
+
+    /* A name is only valid for its own type */
+    for(t = 0;t < NUM_OBJECT_TYPES;t++)
+    {
+        CHECK(isProcs[t](0) == ObjectTypes[t].nullValid);
+        for(u = 0;u < NUM_OBJECT_TYPES;u++)
+        {
+            for(i = 0;i < NAMES_PER_TYPE;i++)
+            {
+                if(isProcs[t](names[u][i]) != (t == u))
+                {
+                    printf("%s(%u) from %s gave %s\n", ObjectTypes[t].is, names[u][i],
+                           ObjectTypes[u].gen, ((t == u) ? "false" : "true"));
+                    Failed++;
+                }
+            }
+        }
+    }
+
+    /* Names of objects made per context aren't valid in another context on
+     * the same device, but the device's are */
+    context2 = alcCreateContext(device, NULL);
+    alcMakeContextCurrent(context2);
+    for(t = 0;t < NUM_OBJECT_TYPES;t++)
+    {
+        for(i = 0;i < NAMES_PER_TYPE;i++)
+            CHECK(isProcs[t](names[t][i]) == !ObjectTypes[t].perContext);
+    }
+    alcMakeContextCurrent(context);
+    alcDestroyContext(context2);
+
+    /* A deleted name stays invalid, even once its slot is used again */
+    for(t = 0;t < NUM_OBJECT_TYPES;t++)
+    {
+        delProcs[t](1, &names[t][1]);
+        CHECK_ERROR(AL_NO_ERROR);
+        CHECK(!isProcs[t](names[t][1]));
+        genProcs[t](1, &name);
+        CHECK(name != names[t][1]);
+        CHECK(!isProcs[t](names[t][1]));
+        CHECK(isProcs[t](name));
+        names[t][1] = name;
+    }
+    alSourcef(names[0][0], AL_GAIN, 1.0f);
+    CHECK_ERROR(AL_NO_ERROR);
+    alSourcef(names[1][0], AL_GAIN, 1.0f);
+    CHECK_ERROR(AL_INVALID_NAME);
+    alBufferData(names[0][0], AL_FORMAT_MONO16, Silence, 64, 22050);
+    CHECK_ERROR(AL_INVALID_NAME);
+
+    for(t = 0;t < NUM_OBJECT_TYPES;t++)
+    {
+        delProcs[t](NAMES_PER_TYPE, names[t]);
+        CHECK_ERROR(AL_NO_ERROR);
+        for(i = 0;i < NAMES_PER_TYPE;i++)
+            CHECK(!isProcs[t](names[t][i]));
+    }
+}
+
+static void CheckVector(const ALfloat *values, ALfloat x, ALfloat y, ALfloat z)
+{
+    if(values[0] != x || values[1] != y || values[2] != z)
+    {
+        printf("got %f, %f, %f, expected %f, %f, %f\n", values[0], values[1],
+               values[2], x, y, z);
+        Failed++;
+    }
+}
+
+static void CheckDeferredUpdates(void)
+{
+    static const ALfloat orientation[6] = { 0.0f, 0.0f, 1.0f,  0.0f, 1.0f, 0.0f };
+    PFNALDEFERUPDATESEXTPROC palDeferUpdatesEXT;
+    PFNALPROCESSUPDATESEXTPROC palProcessUpdatesEXT;
+    ALuint sources[2], buffer, pass;
+    ALfloat val, vec[6];
+    ALint state;
+
+    palDeferUpdatesEXT = (PFNALDEFERUPDATESEXTPROC)alGetProcAddress("alDeferUpdatesEXT");
+    palProcessUpdatesEXT = (PFNALPROCESSUPDATESEXTPROC)alGetProcAddress("alProcessUpdatesEXT");
+    CHECK(alIsExtensionPresent("AL_EXTX_deferred_updates"));
+    CHECK(palDeferUpdatesEXT != NULL && palProcessUpdatesEXT != NULL);
+    if(!palDeferUpdatesEXT || !palProcessUpdatesEXT)
+        return;
+
+    alGenSources(2, sources);
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO16, Silence, BUFFER_FRAMES(0)*2, 22050);
+    alSourcei(sources[0], AL_BUFFER, buffer);
+    alSourcef(sources[0], AL_GAIN, 0.5f);
+    CHECK(alGetBoolean(AL_DEFERRED_UPDATES_EXT) == AL_FALSE);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    palDeferUpdatesEXT();
+    CHECK(alGetBoolean(AL_DEFERRED_UPDATES_EXT) == AL_TRUE);
+    alSourcef(sources[0], AL_GAIN, 0.25f);
+    alSource3f(sources[1], AL_POSITION, 1.0f, 2.0f, 3.0f);
+    alListenerf(AL_GAIN, 0.75f);
+    alListener3f(AL_POSITION, 4.0f, 5.0f, 6.0f);
+    alListener3f(AL_VELOCITY, 7.0f, 8.0f, 9.0f);
+    alListenerfv(AL_ORIENTATION, orientation);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    /* Deferring again while deferred changes nothing */
+    palDeferUpdatesEXT();
+    CHECK(alGetBoolean(AL_DEFERRED_UPDATES_EXT) == AL_TRUE);
+
+    /* Playback state isn't deferred */
+    alSourcePlay(sources[0]);
+    alGetSourcei(sources[0], AL_SOURCE_STATE, &state);
+    CHECK(state == AL_PLAYING);
+
+    /* The new values read back before and after they're applied */
+    for(pass = 0;pass < 2;pass++)
+    {
+        alGetSourcef(sources[0], AL_GAIN, &val);
+        CHECK(val == 0.25f);
+        alGetSourcefv(sources[1], AL_POSITION, vec);
+        CheckVector(vec, 1.0f, 2.0f, 3.0f);
+        alGetListenerf(AL_GAIN, &val);
+        CHECK(val == 0.75f);
+        alGetListenerfv(AL_POSITION, vec);
+        CheckVector(vec, 4.0f, 5.0f, 6.0f);
+        alGetListener3f(AL_VELOCITY, &vec[0], &vec[1], &vec[2]);
+        CheckVector(vec, 7.0f, 8.0f, 9.0f);
+        alGetListenerfv(AL_ORIENTATION, vec);
+        CheckVector(vec, 0.0f, 0.0f, 1.0f);
+        CheckVector(vec+3, 0.0f, 1.0f, 0.0f);
+        CHECK_ERROR(AL_NO_ERROR);
+
+        palProcessUpdatesEXT();
+        CHECK(alGetBoolean(AL_DEFERRED_UPDATES_EXT) == AL_FALSE);
+        CHECK_ERROR(AL_NO_ERROR);
+    }
+
+    /* Changes go straight through again */
+    alListenerf(AL_GAIN, 1.0f);
+    alGetListenerf(AL_GAIN, &val);
+    CHECK(val == 1.0f);
+    alListener3f(AL_POSITION, 0.0f, 0.0f, 0.0f);
+    alListener3f(AL_VELOCITY, 0.0f, 0.0f, 0.0f);
+    alListenerfv(AL_ORIENTATION, orientation);
+
+    alSourceStop(sources[0]);
+    alDeleteSources(2, sources);
+    alDeleteBuffers(1, &buffer);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+static void CheckSourceArrays(void)
+{
+    static const ALfloat gains[3] = { 0.1f, 0.2f, 0.3f };
+    static const ALfloat badGains[3] = { 0.4f, -1.0f, 0.6f };
+    static const ALfloat offsets[3] = { 2000.0f, 2500.0f, 3000.0f };
+    static const ALfloat badOffsets[3] = { 2000.0f, 1000000.0f, 3000.0f };
+    static const ALfloat positions[9] = {
+        1.0f, 2.0f, 3.0f,  4.0f, 5.0f, 6.0f,  7.0f, 8.0f, 9.0f
+    };
+    PFNALSOURCESFVEXTPROC palSourcesfvEXT;
+    PFNALGETSOURCESFVEXTPROC palGetSourcesfvEXT;
+    ALuint sources[3], badNames[3], buffer;
+    ALfloat values[9], val;
+    ALuint i;
+
+    palSourcesfvEXT = (PFNALSOURCESFVEXTPROC)alGetProcAddress("alSourcesfvEXT");
+    palGetSourcesfvEXT = (PFNALGETSOURCESFVEXTPROC)alGetProcAddress("alGetSourcesfvEXT");
+    CHECK(alIsExtensionPresent("AL_EXTX_source_arrays"));
+    CHECK(palSourcesfvEXT != NULL && palGetSourcesfvEXT != NULL);
+    if(!palSourcesfvEXT || !palGetSourcesfvEXT)
+        return;
+
+    alGenSources(3, sources);
+    alGenBuffers(1, &buffer);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    /* Packed values match the per-source calls both ways */
+    palSourcesfvEXT(3, sources, AL_GAIN, gains);
+    palSourcesfvEXT(3, sources, AL_POSITION, positions);
+    CHECK_ERROR(AL_NO_ERROR);
+    for(i = 0;i < 3;i++)
+    {
+        alGetSourcef(sources[i], AL_GAIN, &val);
+        CHECK(val == gains[i]);
+        alGetSource3f(sources[i], AL_POSITION, &values[0], &values[1], &values[2]);
+        CheckVector(values, positions[i*3+0], positions[i*3+1], positions[i*3+2]);
+    }
+    alSource3f(sources[1], AL_VELOCITY, -1.0f, -2.0f, -3.0f);
+    palGetSourcesfvEXT(3, sources, AL_GAIN, values);
+    CHECK(values[0] == gains[0] && values[1] == gains[1] && values[2] == gains[2]);
+    palGetSourcesfvEXT(3, sources, AL_VELOCITY, values);
+    CheckVector(values, 0.0f, 0.0f, 0.0f);
+    CheckVector(values+3, -1.0f, -2.0f, -3.0f);
+    CheckVector(values+6, 0.0f, 0.0f, 0.0f);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    /* A bad name anywhere changes and reads nothing */
+    badNames[0] = sources[0];
+    badNames[1] = buffer;
+    badNames[2] = sources[2];
+    palSourcesfvEXT(3, badNames, AL_GAIN, badGains);
+    CHECK_ERROR(AL_INVALID_NAME);
+    for(i = 0;i < 9;i++)
+        values[i] = -2.0f;
+    palGetSourcesfvEXT(3, badNames, AL_GAIN, values);
+    CHECK_ERROR(AL_INVALID_NAME);
+    CHECK(values[0] == -2.0f && values[1] == -2.0f && values[2] == -2.0f);
+    palGetSourcesfvEXT(3, sources, AL_GAIN, values);
+    CHECK(values[0] == gains[0] && values[1] == gains[1] && values[2] == gains[2]);
+
+    /* A bad value anywhere changes nothing */
+    palSourcesfvEXT(3, sources, AL_GAIN, badGains);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palGetSourcesfvEXT(3, sources, AL_GAIN, values);
+    CHECK(values[0] == gains[0] && values[1] == gains[1] && values[2] == gains[2]);
+
+    /* Nor does an offset past the end of a paused source's buffer */
+    alBufferData(buffer, AL_FORMAT_MONO16, Silence, BUFFER_FRAMES(0)*2, 22050);
+    for(i = 0;i < 3;i++)
+        alSourcei(sources[i], AL_BUFFER, buffer);
+    alSourcePlayv(3, sources);
+    alSourcePausev(3, sources);
+    CHECK_ERROR(AL_NO_ERROR);
+    palSourcesfvEXT(3, sources, AL_SAMPLE_OFFSET, badOffsets);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palGetSourcesfvEXT(3, sources, AL_SAMPLE_OFFSET, values);
+    CHECK(values[0] < offsets[0] && values[1] < offsets[0] && values[2] < offsets[0]);
+    palSourcesfvEXT(3, sources, AL_SAMPLE_OFFSET, offsets);
+    CHECK_ERROR(AL_NO_ERROR);
+    palGetSourcesfvEXT(3, sources, AL_SAMPLE_OFFSET, values);
+    CHECK(values[0] == offsets[0] && values[1] == offsets[1] && values[2] == offsets[2]);
+    alSourceStopv(3, sources);
+    for(i = 0;i < 3;i++)
+        alSourcei(sources[i], AL_BUFFER, 0);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    palSourcesfvEXT(0, NULL, AL_GAIN, NULL);
+    CHECK_ERROR(AL_NO_ERROR);
+    palSourcesfvEXT(-1, sources, AL_GAIN, gains);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    palGetSourcesfvEXT(-1, sources, AL_GAIN, values);
+    CHECK_ERROR(AL_INVALID_VALUE);
+
+    alDeleteSources(3, sources);
+    alDeleteBuffers(1, &buffer);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+/* Plays the sources together until they stop, checking that they're at the
+ * same offset the whole time. Returns the number of checks made. */
+static ALuint CheckLockstep(const ALuint *sources, ALsizei count)
+{
+    PFNALGETSOURCESFVEXTPROC palGetSourcesfvEXT;
+    ALfloat offsets[MAX_LOCKSTEP];
+    ALuint checks = 0;
+    ALint state, tries;
+    ALsizei i;
+
+    palGetSourcesfvEXT = (PFNALGETSOURCESFVEXTPROC)alGetProcAddress("alGetSourcesfvEXT");
+    if(!palGetSourcesfvEXT)
+    {
+        printf("alGetSourcesfvEXT not found\n");
+        Failed++;
+        return 0;
+    }
+
+    alSourcePlayv(count, sources);
+    CHECK_ERROR(AL_NO_ERROR);
+    for(tries = 0;tries < 500;tries++)
+    {
+        /* One call reads them all within the same mixer update */
+        palGetSourcesfvEXT(count, sources, AL_SAMPLE_OFFSET, offsets);
+        for(i = 1;i < count;i++)
+        {
+            if(offsets[i] != offsets[0])
+            {
+                printf("source %d is at %f, source 0 at %f\n", (int)i, offsets[i],
+                       offsets[0]);
+                Failed++;
+            }
+        }
+        checks++;
+
+        alGetSourcei(sources[0], AL_SOURCE_STATE, &state);
+        if(state != AL_PLAYING)
+            break;
+        usleep(10000);
+    }
+    CHECK(state == AL_STOPPED);
+    for(i = 1;i < count;i++)
+    {
+        alGetSourcei(sources[i], AL_SOURCE_STATE, &state);
+        CHECK(state == AL_STOPPED);
+    }
+    return checks;
+}
+
+static void CheckSilentSources(void)
+{
+    ALuint sources[4], buffers[2];
+    ALsizei i;
+
+    alGenSources(4, sources);
+    alGenBuffers(2, buffers);
+    alBufferData(buffers[0], AL_FORMAT_MONO16, Silence, BUFFER_FRAMES(0)*2, 22050);
+    alBufferData(buffers[1], AL_FORMAT_MONO16, Silence, BUFFER_FRAMES(1)*2, 22050);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    /* A queue of two buffers, played at 1.5x. The first source is heard,
+     * and the rest are silent by their gain or their distance. */
+    for(i = 0;i < 4;i++)
+    {
+        alSourceQueueBuffers(sources[i], 2, buffers);
+        alSourcef(sources[i], AL_PITCH, 1.5f);
+    }
+    alSourcef(sources[1], AL_GAIN, 0.0f);
+    alSourcef(sources[2], AL_GAIN, 0.000001f);
+    alSource3f(sources[3], AL_POSITION, 0.0f, 0.0f, -1000000.0f);
+    alSourcef(sources[3], AL_ROLLOFF_FACTOR, 10.0f);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    CHECK(CheckLockstep(sources, 4) > 1);
+
+    alDeleteSources(4, sources);
+    alDeleteBuffers(2, buffers);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+/* With the "voices" option set below the number playing, the ones with the
+ * lowest priority are faded out and stop being mixed */
+static void CheckSourcePriorities(void)
+{
+    ALuint sources[MAX_LOCKSTEP], buffer;
+    ALfloat val;
+    ALsizei i;
+
+    alGenSources(MAX_LOCKSTEP, sources);
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO16, Silence, BUFFER_FRAMES(2)*2, 22050);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    alGetSourcef(sources[0], AL_SOURCE_PRIORITY, &val);
+    CHECK(val == 1.0f);
+    alSourcef(sources[0], AL_SOURCE_PRIORITY, -1.0f);
+    CHECK_ERROR(AL_INVALID_VALUE);
+    alGetSourcef(sources[0], AL_SOURCE_PRIORITY, &val);
+    CHECK(val == 1.0f);
+
+    /* The first one has the highest priority, so it's always mixed */
+    for(i = 0;i < MAX_LOCKSTEP;i++)
+    {
+        alSourcei(sources[i], AL_BUFFER, buffer);
+        alSourcef(sources[i], AL_SOURCE_PRIORITY, (ALfloat)(MAX_LOCKSTEP-i));
+        alSource3f(sources[i], AL_POSITION, (ALfloat)(i%4) - 1.5f, 0.0f, -1.0f);
+    }
+    alGetSourcef(sources[3], AL_SOURCE_PRIORITY, &val);
+    CHECK(val == (ALfloat)(MAX_LOCKSTEP-3));
+    CHECK_ERROR(AL_NO_ERROR);
+
+    CHECK(CheckLockstep(sources, MAX_LOCKSTEP) > 1);
+
+    alDeleteSources(MAX_LOCKSTEP, sources);
+    alDeleteBuffers(1, &buffer);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+#define WORLD_SOURCES     4
+#define RELATIVE_SOURCES  2
+
+/* Waits for a mixer update that recalculated something (or nothing, if busy
+ * is false), giving up after a few updates' time. The counts are only for the
+ * last update, which can be missed if updates come quickly. */
+static ALboolean WaitForUpdate(ALCdevice *device, ALboolean busy, ALCint *params, ALCint *placements)
+{
+    int tries;
+
+    for(tries = 0;tries < 200;tries++)
+    {
+        alcGetIntegerv(device, ALC_PARAM_UPDATES_EXT, 1, params);
+        alcGetIntegerv(device, ALC_PLACEMENT_UPDATES_EXT, 1, placements);
+        if((*params != 0) == busy)
+            return AL_TRUE;
+        usleep(1000);
+    }
+    return AL_FALSE;
+}
+
+/* Only the playing sources a change affects are recalculated, and their place
+ * relative to the listener only when one of them moved */
+static void CheckUpdateCounts(ALCdevice *device)
+{
+    ALuint sources[WORLD_SOURCES+RELATIVE_SOURCES], buffer;
+    ALCint params, placements;
+    ALsizei i;
+    int tries;
+
+    CHECK(alcIsExtensionPresent(device, "ALC_EXTX_mixer_stats"));
+
+    alGenSources(WORLD_SOURCES+RELATIVE_SOURCES, sources);
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO16, Silence, BUFFER_FRAMES(0)*2, 22050);
+    for(i = 0;i < WORLD_SOURCES+RELATIVE_SOURCES;i++)
+    {
+        alSourcei(sources[i], AL_BUFFER, buffer);
+        alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+        alSource3f(sources[i], AL_POSITION, (ALfloat)i, 0.0f, -1.0f);
+        alSourcei(sources[i], AL_SOURCE_RELATIVE, (i >= WORLD_SOURCES));
+    }
+    alSourcePlayv(WORLD_SOURCES+RELATIVE_SOURCES, sources);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    /* Once they've started, nothing is recalculated until something
+     * changes */
+    CHECK(WaitForUpdate(device, AL_TRUE, &params, &placements));
+    usleep(100000);
+    for(tries = 0;tries < 50;tries++)
+    {
+        alcGetIntegerv(device, ALC_PARAM_UPDATES_EXT, 1, &params);
+        alcGetIntegerv(device, ALC_PLACEMENT_UPDATES_EXT, 1, &placements);
+        CHECK(params == 0 && placements == 0);
+        usleep(2000);
+    }
+
+    /* Moving the listener moves every other source, but the head-relative
+     * ones stay where they were relative to it */
+    for(tries = 0;tries < 10;tries++)
+    {
+        WaitForUpdate(device, AL_FALSE, &params, &placements);
+        alListener3f(AL_POSITION, 0.0f, (ALfloat)(tries+1), 0.0f);
+        if(WaitForUpdate(device, AL_TRUE, &params, &placements))
+            break;
+    }
+    CHECK(tries < 10);
+    CHECK(params == WORLD_SOURCES && placements == WORLD_SOURCES);
+
+    /* A gain change doesn't move the source */
+    for(tries = 0;tries < 10;tries++)
+    {
+        WaitForUpdate(device, AL_FALSE, &params, &placements);
+        alSourcef(sources[0], AL_GAIN, 1.0f/(tries+2));
+        if(WaitForUpdate(device, AL_TRUE, &params, &placements))
+            break;
+    }
+    CHECK(tries < 10);
+    CHECK(params == 1 && placements == 0);
+
+    /* A head-relative source's placement doesn't go stale when the listener
+     * moves, so its next change doesn't recalculate it either */
+    for(tries = 0;tries < 10;tries++)
+    {
+        WaitForUpdate(device, AL_FALSE, &params, &placements);
+        alSourcef(sources[WORLD_SOURCES], AL_GAIN, 1.0f/(tries+2));
+        if(WaitForUpdate(device, AL_TRUE, &params, &placements))
+            break;
+    }
+    CHECK(tries < 10);
+    CHECK(params == 1 && placements == 0);
+
+    /* Moving a head-relative source only needs its own placement */
+    for(tries = 0;tries < 10;tries++)
+    {
+        WaitForUpdate(device, AL_FALSE, &params, &placements);
+        alSource3f(sources[WORLD_SOURCES], AL_POSITION, 0.0f, (ALfloat)(tries+1), -1.0f);
+        if(WaitForUpdate(device, AL_TRUE, &params, &placements))
+            break;
+    }
+    CHECK(tries < 10);
+    CHECK(params == 1 && placements == 1);
+
+    alSourceStopv(WORLD_SOURCES+RELATIVE_SOURCES, sources);
+    alDeleteSources(WORLD_SOURCES+RELATIVE_SOURCES, sources);
+    alDeleteBuffers(1, &buffer);
+    alListener3f(AL_POSITION, 0.0f, 0.0f, 0.0f);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+static void CheckQueueSeeking(void)
+{
+    ALuint buffers[NUM_BUFFERS], source;
+    ALuint round, i;
+
+    alGenBuffers(NUM_BUFFERS, buffers);
+    alGenSources(1, &source);
+    for(i = 0;i < NUM_BUFFERS;i++)
+        alBufferData(buffers[i], AL_FORMAT_MONO16, Silence, BUFFER_FRAMES(i)*2, 22050);
+    CHECK_ERROR(AL_NO_ERROR);
+
+    for(round = 0;round < SEEK_ROUNDS;round++)
+    {
+        ALuint added = 1 + RandInt(8);
+        ALuint total = 0;
+        ALint val;
+
+        /* Queue some more buffers */
+        for(i = 0;i < added && QueueLength < MAX_QUEUED;i++)
+        {
+            ALuint idx = RandInt(NUM_BUFFERS);
+            alSourceQueueBuffers(source, 1, &buffers[idx]);
+            QueueFrames[QueueLength++] = BUFFER_FRAMES(idx);
+        }
+        CHECK_ERROR(AL_NO_ERROR);
+        alGetSourcei(source, AL_BUFFERS_QUEUED, &val);
+        CHECK((ALuint)val == QueueLength);
+
+        alSourcePlay(source);
+        alSourcePause(source);
+        alGetSourcei(source, AL_SOURCE_STATE, &val);
+        CHECK(val == AL_PAUSED);
+
+        /* Seek around the queue, including either side of each boundary */
+        for(i = 0;i < QueueLength;i++)
+            total += QueueFrames[i];
+        for(i = 0;i < 10;i++)
+            CheckSeek(source, RandInt(total));
+        CheckSeek(source, 0);
+        CheckSeek(source, QueueFrames[0]-1);
+        CheckSeek(source, QueueFrames[0]);
+        CheckSeek(source, total-QueueFrames[QueueLength-1]);
+        CheckSeek(source, total-1);
+        alSourcei(source, AL_SAMPLE_OFFSET, total);
+        CHECK_ERROR(AL_INVALID_VALUE);
+
+        /* Take off some of the processed buffers, so the next seeks count
+         * from a later item */
+        CheckSeek(source, RandInt(total));
+        alGetSourcei(source, AL_BUFFERS_PROCESSED, &val);
+        if(val > 0)
+        {
+            ALuint removed[MAX_QUEUED];
+            ALuint count = RandInt(val+1);
+
+            alSourceUnqueueBuffers(source, count, removed);
+            CHECK_ERROR(AL_NO_ERROR);
+            memmove(QueueFrames, QueueFrames+count, (QueueLength-count)*sizeof(QueueFrames[0]));
+            QueueLength -= count;
+        }
+    }
+
+    /* Setting a single buffer replaces the whole queue */
+    alSourceStop(source);
+    alSourcei(source, AL_BUFFER, 0);
+    alSourcei(source, AL_BUFFER, buffers[3]);
+    CHECK_ERROR(AL_NO_ERROR);
+    QueueFrames[0] = BUFFER_FRAMES(3);
+    QueueLength = 1;
+    alSourcePlay(source);
+    alSourcePause(source);
+    CheckSeek(source, BUFFER_FRAMES(3)/2);
+    CheckSeek(source, BUFFER_FRAMES(3)-1);
+
+    alSourceStop(source);
+    alDeleteSources(1, &source);
+    alDeleteBuffers(NUM_BUFFERS, buffers);
+    CHECK_ERROR(AL_NO_ERROR);
+}
+
+int main(void)
+{
+    ALCdevice *device;
+    ALCcontext *context;
+
+    device = alcOpenDevice(NULL);
+    if(!device)
+    {
+        printf("Could not open a device\n");
+        return EXIT_FAILURE;
+    }
+    context = alcCreateContext(device, NULL);
+    alcMakeContextCurrent(context);
+
+    CheckNames(device, context);
+    CheckDeferredUpdates();
+    CheckSourceArrays();
+    CheckSilentSources();
+    CheckSourcePriorities();
+    CheckUpdateCounts(device);
+    CheckQueueSeeking();
+
+    alcMakeContextCurrent(NULL);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+
+    if(Failed)
+    {
+        printf("%d check(s) failed\n", Failed);
+        return EXIT_FAILURE;
+    }
+    printf("All checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/*
+ * Stress test and benchmark of the thunk table's lock-free lookups. The
+ * table is built into this program. Churn threads keep removing and adding
+ * entries, while reader threads look up the handles the churn threads last
+ * gave out, which are often stale by the time they're looked up. A lookup
+ * must find nothing, or the object that was given that exact handle, with
+ * the type and owner it was added with. Reports the lookup rate.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "alMain.h"
+#include "alThunk.h"
+
+#define NUM_CHURNERS  2
+#define NUM_READERS   4
+#define NUM_SLOTS     256
+#define CHURN_COUNT   (1<<20)
+
+/* Each add gets a new object, so an object is only ever given one handle */
+typedef struct {
+    ALuint Handle;
+    ThunkType Type;
+} StressObject;
+
+typedef struct {
+    StressObject *Objects;
+    volatile ALuint Handles[NUM_SLOTS];
+    ALuint Failed;
+} Churner;
+
+typedef struct {
+    ALuint Lookups;
+    ALuint Found;
+    ALuint Failed;
+} Reader;
+
+static Churner Churners[NUM_CHURNERS];
+static Reader Readers[NUM_READERS];
+static volatile ALuint Done;
+
+static ALuint ChurnProc(ALvoid *ptr)
+{
+    Churner *self = ptr;
+    ALuint i, slot = 0;
+
+    for(i = 0;i < CHURN_COUNT;i++)
+    {
+        StressObject *obj = &self->Objects[i];
+        ALuint handle;
+
+        ALTHUNK_REMOVEENTRY(self->Handles[slot]);
+
+        obj->Type = ((i&1) ? THUNK_SOURCE : THUNK_BUFFER);
+        handle = ALTHUNK_ADDENTRY(obj, obj->Type, self);
+        if(handle == 0)
+        {
+            self->Failed++;
+            break;
+        }
+        obj->Handle = handle;
+        // The object has to be filled in before readers can get its handle
+        WriteBarrier();
+        self->Handles[slot] = handle;
+
+        slot = (slot+1) % NUM_SLOTS;
+    }
+    return 0;
+}
+
+static ALuint ReadProc(ALvoid *ptr)
+{
+    Reader *self = ptr;
+    ALuint c = 0, slot = 0;
+
+    while(!Done)
+    {
+        Churner *owner = &Churners[c];
+        Churner *other = &Churners[(c+1) % NUM_CHURNERS];
+        ALuint handle = owner->Handles[slot];
+        StressObject *obj;
+
+        obj = ALTHUNK_LOOKUPENTRY(handle);
+        if(obj)
+        {
+            ReadBarrier();
+            if(obj->Handle != handle)
+                self->Failed++;
+            self->Found++;
+        }
+
+        obj = ALTHUNK_LOOKUPOBJECT(handle, THUNK_SOURCE, owner);
+        if(obj)
+        {
+            ReadBarrier();
+            if(obj->Handle != handle || obj->Type != THUNK_SOURCE)
+                self->Failed++;
+        }
+        obj = ALTHUNK_LOOKUPOBJECT(handle, THUNK_BUFFER, owner);
+        if(obj)
+        {
+            ReadBarrier();
+            if(obj->Handle != handle || obj->Type != THUNK_BUFFER)
+                self->Failed++;
+        }
+        if(other != owner &&
+           (ALTHUNK_LOOKUPOBJECT(handle, THUNK_SOURCE, other) ||
+            ALTHUNK_LOOKUPOBJECT(handle, THUNK_BUFFER, other)))
+            self->Failed++;
+
+        self->Lookups += 4;
+        slot = (slot+1) % NUM_SLOTS;
+        if(slot == 0)
+            c = (c+1) % NUM_CHURNERS;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    ALvoid *threads[NUM_CHURNERS+NUM_READERS];
+    ALuint start, elapsed;
+    double lookups = 0.0, found = 0.0;
+    ALuint failed = 0;
+    ALuint i;
+
+    ALTHUNK_INIT();
+
+    for(i = 0;i < NUM_CHURNERS;i++)
+    {
+        Churners[i].Objects = calloc(CHURN_COUNT, sizeof(StressObject));
+        if(!Churners[i].Objects)
+        {
+            printf("Out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    start = timeGetTime();
+    for(i = 0;i < NUM_READERS;i++)
+        threads[NUM_CHURNERS+i] = StartThread(ReadProc, &Readers[i]);
+    for(i = 0;i < NUM_CHURNERS;i++)
+        threads[i] = StartThread(ChurnProc, &Churners[i]);
+    for(i = 0;i < NUM_CHURNERS+NUM_READERS;i++)
+    {
+        if(!threads[i])
+        {
+            printf("Failed to start threads\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    for(i = 0;i < NUM_CHURNERS;i++)
+        StopThread(threads[i]);
+    Done = 1;
+    for(i = 0;i < NUM_READERS;i++)
+        StopThread(threads[NUM_CHURNERS+i]);
+    elapsed = timeGetTime() - start;
+    if(elapsed == 0)
+        elapsed = 1;
+
+    for(i = 0;i < NUM_CHURNERS;i++)
+    {
+        if(Churners[i].Failed)
+            printf("Churn thread %u ran out of handles\n", i);
+        failed += Churners[i].Failed;
+        free(Churners[i].Objects);
+    }
+    for(i = 0;i < NUM_READERS;i++)
+    {
+        lookups += Readers[i].Lookups;
+        found += Readers[i].Found;
+        failed += Readers[i].Failed;
+    }
+
+    ALTHUNK_EXIT();
+
+    printf("%d churn threads made %d handles each, while %d reader threads\n"
+           "made %.0f lookups in %ums (%.2f million/s, %.1f%% of handles live)\n",
+           NUM_CHURNERS, CHURN_COUNT, NUM_READERS, lookups, elapsed,
+           lookups / elapsed / 1000.0, found*400.0 / (lookups ? lookups : 1.0));
+    if(failed)
+    {
+        printf("%u lookup(s) found the wrong object\n", failed);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -110,6 +110,17 @@ typedef ALvoid (AL_APIENTRY*PFNALBUFFERSUBDATAEXTPROC)(ALuint,ALenum,const ALvoi
 typedef ALvoid (AL_APIENTRY*PFNALBUFFERDATASTATICPROC)(const ALint,ALenum,ALvoid*,ALsizei,ALsizei);
 #endif
 
+#ifndef AL_EXTX_sound_bank
+#define AL_EXTX_sound_bank 1
+typedef ALvoid (AL_APIENTRY*PFNALBUFFERDATAFROMBANKEXTPROC)(const ALchar*,ALsizei,const ALuint*);
+#endif
+
+#ifndef AL_EXTX_static_buffer
+#define AL_EXTX_static_buffer 1
+typedef ALvoid (AL_APIENTRY*ALBUFFERRELEASEPROCEXT)(ALuint,const ALvoid*,ALvoid*);
+typedef ALvoid (AL_APIENTRY*PFNALBUFFERDATASTATICEXTPROC)(ALuint,ALenum,const ALvoid*,ALsizei,ALsizei,ALBUFFERRELEASEPROCEXT,ALvoid*);
+#endif
+
 #ifndef AL_EXT_sample_buffer_object
 #define AL_EXT_sample_buffer_object 1
 #define AL_SAMPLE_SOURCE_EXT                     0x1040
@@ -156,11 +167,47 @@ typedef ALCboolean (ALC_APIENTRY*PFNALCMAKECURRENTPROC)(ALCcontext *context);
 typedef ALCcontext* (ALC_APIENTRY*PFNALCGETTHREADCONTEXTPROC)(void);
 #endif
 
+#ifndef ALC_EXTX_mixer_stats
+#define ALC_EXTX_mixer_stats 1
+#define ALC_PARAM_UPDATES_EXT                    0x1A00
+#define ALC_PLACEMENT_UPDATES_EXT                0x1A01
+#endif
+
+#ifndef ALC_EXTX_pool_stats
+#define ALC_EXTX_pool_stats 1
+#define ALC_POOL_HITS_EXT                        0x1A02
+#define ALC_POOL_MISSES_EXT                      0x1A03
+#endif
+
+#ifndef ALC_EXTX_buffer_memory
+#define ALC_EXTX_buffer_memory 1
+#define ALC_BUFFER_MEMORY_EXT                    0x1A04
+#define ALC_BUFFER_MEMORY_SAVED_EXT              0x1A05
+#endif
+
 #ifndef AL_EXT_source_distance_model
 #define AL_EXT_source_distance_model 1
 #define AL_SOURCE_DISTANCE_MODEL                 0x200
 #endif
 
+#ifndef AL_EXTX_source_priority
+#define AL_EXTX_source_priority 1
+#define AL_SOURCE_PRIORITY                       0x201
+#endif
+
+#ifndef AL_EXTX_deferred_updates
+#define AL_EXTX_deferred_updates 1
+#define AL_DEFERRED_UPDATES_EXT                  0xC002
+typedef ALvoid (AL_APIENTRY*PFNALDEFERUPDATESEXTPROC)(void);
+typedef ALvoid (AL_APIENTRY*PFNALPROCESSUPDATESEXTPROC)(void);
+#endif
+
+#ifndef AL_EXTX_source_arrays
+#define AL_EXTX_source_arrays 1
+typedef ALvoid (AL_APIENTRY*PFNALSOURCESFVEXTPROC)(ALsizei,const ALuint*,ALenum,const ALfloat*);
+typedef ALvoid (AL_APIENTRY*PFNALGETSOURCESFVEXTPROC)(ALsizei,const ALuint*,ALenum,ALfloat*);
+#endif
+
 #ifdef __cplusplus
 }
 #endif